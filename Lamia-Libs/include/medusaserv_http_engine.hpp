@@ -10,6 +10,8 @@
 #ifndef MEDUSASERV_HTTP_ENGINE_HPP
 #define MEDUSASERV_HTTP_ENGINE_HPP
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,8 +27,22 @@ typedef struct {
     int active_connections;
     long total_requests_processed;
     bool server_initialized;
+    long total_connections;          // Connections handled by process_http_requests
+    long keep_alive_requests;        // Requests answered on a connection that had already served one
+    double keep_alive_reuse_ratio;   // keep_alive_requests / total_requests_processed
+    long static_files_served;        // Responses from configure_http_static_files, 304s included
+    long not_modified_responses;     // 304s answered from ETag / Last-Modified
+    double file_cache_hit_ratio;     // Open-file cache hits / lookups
 } MedusaServHttpStats;
 
+/**
+ * Resolves a request path (percent-decoded, query removed) against a root;
+ * returns an allocated file path, or NULL when nothing should be served.
+ * route_static_files from MEDUSASERV_PATHING_ENGINE.hpp fits.
+ */
+typedef char* (*MedusaServPathResolver)(const char* path, const char* root);
+typedef void (*MedusaServPathRelease)(char* path);
+
 typedef struct {
     char method[16];
     char path[512];
@@ -43,10 +59,44 @@ int manage_http_connections();
 int implement_http_methods();
 int optimize_request_pipeline();
 int handle_concurrent_requests();
+int configure_http_keep_alive(int idle_timeout_ms, int max_requests_per_connection);
+
+/**
+ * Serve GET and HEAD requests from files under static_root
+ * @param static_root Directory the resolver maps paths into; NULL turns file serving off
+ * @param resolver Maps a request path to a file (e.g. route_static_files); NULL joins
+ *        static_root and the path, refusing "." and ".." segments, with index.html for "/"
+ * @param release Frees what resolver returned (free_path_string for the pathing
+ *        engine); NULL means free()
+ *
+ * Bodies are sent with sendfile from an LRU cache of open files kept fresh by
+ * inotify; ETag / Last-Modified are set and conditional requests answered 304.
+ * Paths that resolve to no regular file fall through to the built-in pages.
+ */
+int configure_http_static_files(const char* static_root, MedusaServPathResolver resolver, MedusaServPathRelease release);
 
 // HTTP utility functions
 int get_http_stats(MedusaServHttpStats* stats);
-const char* generate_http_response(const char* request);
+const char* generate_http_response(const char* request); // Per-thread buffer, valid until the thread's next call
+
+/**
+ * @brief Write the response to request into a caller-owned buffer
+ * @return The response's length; it was written (NUL-terminated) only if
+ *         smaller than capacity, so call again with a larger buffer if not
+ */
+int generate_http_response_into(const char* request, char* buffer, size_t capacity);
+
+/**
+ * @brief Parse the request at the front of data into request
+ * @return Bytes the request occupies (head and body) when complete, 0 when
+ *         more data is needed, MEDUSASERV_ERROR_GENERIC when malformed
+ *
+ * Fields longer than their member are truncated; content_length is the body
+ * size, decoded for chunked requests. C++ callers can use
+ * medusaserv::http::HttpRequestParser (medusaserv_http_parser.hpp) directly
+ * for string_views into data and resumable parsing.
+ */
+int parse_http_request(const char* data, size_t length, MedusaServHttpRequest* request);
 const char* get_http_version();
 
 #ifdef __cplusplus
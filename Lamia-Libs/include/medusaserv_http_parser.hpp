@@ -0,0 +1,689 @@
+/**
+ * LIBMEDUSASERV_HTTP_PARSER HEADER v0.3.0a
+ * =========================================
+ * Incremental HTTP/1.1 request parser for YOUR MedusaServ
+ * Zero-copy: method, path, query, headers and body come back as
+ * string_views into the connection's own read buffer
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves
+ *
+ * The parser is a resumable state machine. Call parse() with the
+ * connection's buffer (starting at the request) after every read; it
+ * continues from where the last call stopped, so every byte is looked at
+ * once however the request is split across reads. Positions are kept as
+ * offsets, so the buffer may grow or move between calls.
+ *
+ * Bodies are framed by Content-Length or chunked Transfer-Encoding.
+ * Chunked framing is parsed but the data is left in place, neither copied
+ * nor joined: body_part(i) views chunk i's bytes in the buffer, and
+ * body_size() is their total.
+ * A request carrying both framings is rejected (request smuggling).
+ */
+
+#ifndef MEDUSASERV_HTTP_PARSER_HPP
+#define MEDUSASERV_HTTP_PARSER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace medusaserv {
+namespace http {
+
+class HttpRequestParser {
+public:
+    enum class Status { INCOMPLETE, COMPLETE, ERROR };
+
+    enum class Error {
+        NONE,
+        BAD_REQUEST_LINE,
+        BAD_VERSION,
+        BAD_HEADER,
+        HEAD_TOO_LARGE,
+        TOO_MANY_HEADERS,
+        BAD_CONTENT_LENGTH,
+        BODY_TOO_LARGE,
+        BAD_CHUNK,
+        UNSUPPORTED_TRANSFER_ENCODING
+    };
+
+    struct Limits {
+        size_t max_head_bytes = 16 * 1024;       // Request line and headers (and chunk trailers)
+        size_t max_headers = 100;
+        size_t max_body_bytes = 8 * 1024 * 1024; // Declared or chunked body
+    };
+
+    struct Header {
+        std::string_view name;
+        std::string_view value; // Without surrounding whitespace
+    };
+
+    HttpRequestParser() = default;
+    explicit HttpRequestParser(const Limits& limits) : limits_(limits) {}
+
+    /**
+     * @brief Parse as far as data allows
+     * @param data The request's bytes so far: the same prefix as last call, possibly longer
+     *
+     * After COMPLETE, length() bytes belong to this request; call reset()
+     * before parsing the next pipelined one.
+     */
+    Status parse(std::string_view data) {
+        if (state_ == State::DONE) {
+            return Status::COMPLETE;
+        }
+        if (state_ == State::FAILED) {
+            return Status::ERROR;
+        }
+        data_ = data.data();
+
+        const char* p = data.data();
+        const size_t end = data.size();
+        while (pos_ < end) {
+            char c = p[pos_];
+            switch (state_) {
+                case State::REQUEST_START:
+                    // Empty lines before a request line are ignored (RFC 9112 2.2)
+                    if (c == '\r' || c == '\n') {
+                        ++pos_;
+                        break;
+                    }
+                    start_ = pos_;
+                    state_ = State::METHOD;
+                    // fallthrough
+                case State::METHOD:
+                    while (pos_ < end && is_token(p[pos_])) {
+                        ++pos_;
+                    }
+                    if (pos_ == end) {
+                        break;
+                    }
+                    if (p[pos_] != ' ' || pos_ == start_) {
+                        return fail(Error::BAD_REQUEST_LINE);
+                    }
+                    method_ = {start_, pos_ - start_};
+                    target_.offset = ++pos_;
+                    state_ = State::TARGET;
+                    break;
+
+                case State::TARGET:
+                    while (pos_ < end && is_target_char(p[pos_])) {
+                        if (p[pos_] == '?' && query_.offset == 0) {
+                            query_.offset = pos_ + 1;
+                        }
+                        ++pos_;
+                    }
+                    if (pos_ == end) {
+                        break;
+                    }
+                    if (p[pos_] != ' ' || pos_ == target_.offset) {
+                        return fail(Error::BAD_REQUEST_LINE);
+                    }
+                    target_.length = pos_ - target_.offset;
+                    if (query_.offset) {
+                        query_.length = pos_ - query_.offset;
+                    }
+                    version_.offset = ++pos_;
+                    state_ = State::VERSION;
+                    break;
+
+                case State::VERSION:
+                    if (c == '\r' || c == '\n') {
+                        version_.length = pos_ - version_.offset;
+                        std::string_view version = view(version_);
+                        if (version.size() != 8 || version.substr(0, 7) != "HTTP/1." ||
+                            (version[7] != '0' && version[7] != '1')) {
+                            return fail(Error::BAD_VERSION);
+                        }
+                        version_minor_ = version[7] - '0';
+                        ++pos_;
+                        state_ = c == '\r' ? State::REQUEST_LINE_LF : State::HEADER_START;
+                    } else if (pos_ - version_.offset >= 8) {
+                        return fail(Error::BAD_VERSION);
+                    } else {
+                        ++pos_;
+                    }
+                    break;
+
+                case State::REQUEST_LINE_LF:
+                case State::HEADER_LF:
+                    if (c != '\n') {
+                        return fail(state_ == State::REQUEST_LINE_LF ? Error::BAD_REQUEST_LINE : Error::BAD_HEADER);
+                    }
+                    ++pos_;
+                    state_ = State::HEADER_START;
+                    break;
+
+                case State::HEADER_START:
+                    if (c == '\r') {
+                        ++pos_;
+                        state_ = State::HEAD_END_LF;
+                    } else if (c == '\n') {
+                        ++pos_;
+                        if (!finish_head()) {
+                            return Status::ERROR;
+                        }
+                    } else if (is_token(c)) {
+                        if (headers_.size() == limits_.max_headers) {
+                            return fail(Error::TOO_MANY_HEADERS);
+                        }
+                        headers_.push_back({{pos_, 0}, {0, 0}});
+                        state_ = State::HEADER_NAME;
+                    } else {
+                        return fail(Error::BAD_HEADER); // Includes obsolete line folding
+                    }
+                    break;
+
+                case State::HEADER_NAME: {
+                    Span& name = headers_.back().name;
+                    while (pos_ < end && is_token(p[pos_])) {
+                        ++pos_;
+                    }
+                    if (pos_ == end) {
+                        break;
+                    }
+                    if (p[pos_] != ':') {
+                        return fail(Error::BAD_HEADER);
+                    }
+                    name.length = pos_ - name.offset;
+                    ++pos_;
+                    state_ = State::HEADER_VALUE_START;
+                    break;
+                }
+
+                case State::HEADER_VALUE_START:
+                    if (c == ' ' || c == '\t') {
+                        ++pos_;
+                        break;
+                    }
+                    headers_.back().value.offset = pos_;
+                    state_ = State::HEADER_VALUE;
+                    // fallthrough
+                case State::HEADER_VALUE: {
+                    while (pos_ < end && is_field_char(p[pos_])) {
+                        ++pos_;
+                    }
+                    if (pos_ == end) {
+                        break;
+                    }
+                    char terminator = p[pos_];
+                    if (terminator != '\r' && terminator != '\n') {
+                        return fail(Error::BAD_HEADER);
+                    }
+                    Span& value = headers_.back().value;
+                    size_t value_end = pos_;
+                    while (value_end > value.offset && (p[value_end - 1] == ' ' || p[value_end - 1] == '\t')) {
+                        --value_end;
+                    }
+                    value.length = value_end - value.offset;
+                    if (!inspect_header(headers_.back())) {
+                        return Status::ERROR;
+                    }
+                    ++pos_;
+                    state_ = terminator == '\r' ? State::HEADER_LF : State::HEADER_START;
+                    break;
+                }
+
+                case State::HEAD_END_LF:
+                    if (c != '\n') {
+                        return fail(Error::BAD_HEADER);
+                    }
+                    ++pos_;
+                    if (!finish_head()) {
+                        return Status::ERROR;
+                    }
+                    break;
+
+                case State::BODY: {
+                    // Skip straight over the body - no byte of it is inspected
+                    size_t take = std::min(remaining_, end - pos_);
+                    pos_ += take;
+                    remaining_ -= take;
+                    if (remaining_ == 0) {
+                        state_ = State::DONE;
+                    }
+                    break;
+                }
+
+                case State::CHUNK_SIZE: {
+                    int digit = hex_value(c);
+                    if (digit >= 0) {
+                        if (remaining_ > (limits_.max_body_bytes >> 4)) {
+                            return fail(Error::BODY_TOO_LARGE);
+                        }
+                        remaining_ = (remaining_ << 4) | static_cast<size_t>(digit);
+                        ++chunk_digits_;
+                        ++pos_;
+                    } else if (chunk_digits_ == 0) {
+                        return fail(Error::BAD_CHUNK);
+                    } else if (c == ';' || c == ' ' || c == '\t') {
+                        ++pos_;
+                        state_ = State::CHUNK_EXTENSION;
+                    } else if (c == '\r') {
+                        ++pos_;
+                        state_ = State::CHUNK_SIZE_LF;
+                    } else if (c == '\n') {
+                        ++pos_;
+                        if (!start_chunk()) {
+                            return Status::ERROR;
+                        }
+                    } else {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    break;
+                }
+
+                case State::CHUNK_EXTENSION:
+                    // Extensions are allowed and ignored
+                    if (c == '\r') {
+                        state_ = State::CHUNK_SIZE_LF;
+                    } else if (c == '\n') {
+                        ++pos_;
+                        if (!start_chunk()) {
+                            return Status::ERROR;
+                        }
+                        break;
+                    } else if (!is_field_char(c)) {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    ++pos_;
+                    break;
+
+                case State::CHUNK_SIZE_LF:
+                    if (c != '\n') {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    ++pos_;
+                    if (!start_chunk()) {
+                        return Status::ERROR;
+                    }
+                    break;
+
+                case State::CHUNK_DATA: {
+                    size_t take = std::min(remaining_, end - pos_);
+                    pos_ += take;
+                    remaining_ -= take;
+                    if (remaining_ == 0) {
+                        state_ = State::CHUNK_DATA_CR;
+                    }
+                    break;
+                }
+
+                case State::CHUNK_DATA_CR:
+                    if (c == '\r') {
+                        state_ = State::CHUNK_DATA_LF;
+                    } else if (c == '\n') {
+                        state_ = State::CHUNK_SIZE;
+                    } else {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    ++pos_;
+                    break;
+
+                case State::CHUNK_DATA_LF:
+                    if (c != '\n') {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    ++pos_;
+                    state_ = State::CHUNK_SIZE;
+                    break;
+
+                case State::TRAILER_START:
+                    // Trailer fields are skipped; they count against the head limit
+                    if (c == '\r') {
+                        state_ = State::TRAILER_END_LF;
+                    } else if (c == '\n') {
+                        state_ = State::DONE;
+                    } else {
+                        state_ = State::TRAILER_LINE;
+                    }
+                    ++pos_;
+                    break;
+
+                case State::TRAILER_LINE:
+                    while (pos_ < end && p[pos_] != '\n') {
+                        if (!is_field_char(p[pos_]) && p[pos_] != '\r') {
+                            return fail(Error::BAD_CHUNK);
+                        }
+                        ++pos_;
+                    }
+                    if (pos_ < end) {
+                        ++pos_;
+                        state_ = State::TRAILER_START;
+                    }
+                    break;
+
+                case State::TRAILER_END_LF:
+                    if (c != '\n') {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    ++pos_;
+                    state_ = State::DONE;
+                    break;
+
+                case State::DONE:
+                case State::FAILED:
+                    break;
+            }
+
+            if (state_ == State::DONE) {
+                return Status::COMPLETE;
+            }
+            if (state_ == State::FAILED) {
+                return Status::ERROR;
+            }
+            if (in_head() && pos_ - start_ > limits_.max_head_bytes) {
+                return fail(Error::HEAD_TOO_LARGE);
+            }
+            if (state_ >= State::TRAILER_START && pos_ - trailer_start_ > limits_.max_head_bytes) {
+                return fail(Error::HEAD_TOO_LARGE);
+            }
+        }
+
+        if (in_head() && pos_ - start_ > limits_.max_head_bytes) {
+            return fail(Error::HEAD_TOO_LARGE);
+        }
+        return Status::INCOMPLETE;
+    }
+
+    /**
+     * @brief Forget the request, ready for the next one on the connection
+     */
+    void reset() {
+        // Keep the vectors' storage, so a connection's later requests allocate nothing
+        std::vector<HeaderSpan> headers = std::move(headers_);
+        std::vector<Span> chunks = std::move(chunks_);
+        *this = HttpRequestParser(limits_);
+        headers.clear();
+        chunks.clear();
+        headers_ = std::move(headers);
+        chunks_ = std::move(chunks);
+    }
+
+    Error error() const { return error_; }
+    bool complete() const { return state_ == State::DONE; }
+
+    /**
+     * @brief Bytes the request occupies, leading empty lines included - valid once complete
+     */
+    size_t length() const { return pos_; }
+
+    // Views into the buffer last passed to parse(), valid while it is
+    bool request_line_complete() const { return state_ > State::VERSION; }
+    std::string_view method() const { return view(method_); }
+    std::string_view target() const { return view(target_); }
+    std::string_view path() const {
+        return query_.offset ? view({target_.offset, query_.offset - 1 - target_.offset}) : view(target_);
+    }
+    std::string_view query() const { return view(query_); }
+    std::string_view version() const { return view(version_); }
+    int version_minor() const { return version_minor_; }
+
+    size_t header_count() const { return headers_.size(); }
+    Header header(size_t index) const {
+        return {view(headers_[index].name), view(headers_[index].value)};
+    }
+
+    /**
+     * @brief Value of the first header called name (case-insensitive), empty if none
+     */
+    std::string_view header(std::string_view name) const {
+        for (const auto& header : headers_) {
+            if (equals_ignore_case(view(header.name), name)) {
+                return view(header.value);
+            }
+        }
+        return std::string_view();
+    }
+
+    /**
+     * @brief Whether the connection may carry another request after this one
+     */
+    bool keep_alive() const { return keep_alive_; }
+    bool chunked() const { return chunked_; }
+    size_t content_length() const { return content_length_; }
+
+    /**
+     * @brief The body's bytes, in order: one part for Content-Length, one per chunk
+     */
+    size_t body_part_count() const {
+        return chunked_ ? chunks_.size() : (content_length_ ? 1 : 0);
+    }
+    std::string_view body_part(size_t index) const {
+        return chunked_ ? view(chunks_[index]) : view(body_);
+    }
+    size_t body_size() const { return body_size_; }
+
+private:
+    enum class State : uint8_t {
+        REQUEST_START, METHOD, TARGET, VERSION, REQUEST_LINE_LF,
+        HEADER_START, HEADER_NAME, HEADER_VALUE_START, HEADER_VALUE, HEADER_LF, HEAD_END_LF,
+        BODY, CHUNK_SIZE, CHUNK_EXTENSION, CHUNK_SIZE_LF, CHUNK_DATA, CHUNK_DATA_CR, CHUNK_DATA_LF,
+        TRAILER_START, TRAILER_LINE, TRAILER_END_LF,
+        DONE, FAILED
+    };
+
+    struct Span {
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    struct HeaderSpan {
+        Span name;
+        Span value;
+    };
+
+    Limits limits_;
+    const char* data_ = nullptr;
+    State state_ = State::REQUEST_START;
+    Error error_ = Error::NONE;
+    size_t pos_ = 0;   // Next byte to look at
+    size_t start_ = 0; // Request line start, after any empty lines
+
+    Span method_, target_, query_, version_;
+    int version_minor_ = 1;
+    std::vector<HeaderSpan> headers_;
+
+    // Framing, gathered while the headers are read
+    bool keep_alive_ = true;
+    bool saw_connection_close_ = false;
+    bool saw_connection_keep_alive_ = false;
+    bool has_content_length_ = false;
+    bool has_transfer_encoding_ = false;
+    bool chunked_ = false;
+    size_t content_length_ = 0;
+
+    // Body
+    Span body_;
+    std::vector<Span> chunks_;
+    size_t body_size_ = 0;
+    size_t remaining_ = 0;    // Bytes left in the body or current chunk (chunk size while reading it)
+    size_t chunk_digits_ = 0;
+    size_t trailer_start_ = 0;
+
+    std::string_view view(Span span) const {
+        return span.length ? std::string_view(data_ + span.offset, span.length) : std::string_view();
+    }
+
+    bool in_head() const { return state_ < State::BODY; }
+
+    Status fail(Error error) {
+        error_ = error;
+        state_ = State::FAILED;
+        return Status::ERROR;
+    }
+
+    /**
+     * @brief Note the headers that decide framing and persistence
+     */
+    bool inspect_header(const HeaderSpan& header) {
+        std::string_view name = view(header.name);
+        std::string_view value = view(header.value);
+
+        if (equals_ignore_case(name, "content-length")) {
+            size_t length = 0;
+            if (value.empty()) {
+                fail(Error::BAD_CONTENT_LENGTH);
+                return false;
+            }
+            for (char c : value) {
+                if (c < '0' || c > '9' || length > (SIZE_MAX - 9) / 10) {
+                    fail(Error::BAD_CONTENT_LENGTH);
+                    return false;
+                }
+                length = length * 10 + static_cast<size_t>(c - '0');
+            }
+            // Repeats must agree, or the framing is ambiguous
+            if (has_content_length_ && length != content_length_) {
+                fail(Error::BAD_CONTENT_LENGTH);
+                return false;
+            }
+            has_content_length_ = true;
+            content_length_ = length;
+        } else if (equals_ignore_case(name, "transfer-encoding")) {
+            // Only chunked is decoded, and it must be the final coding
+            has_transfer_encoding_ = true;
+            chunked_ = last_token_is(value, "chunked");
+            if (!chunked_) {
+                fail(Error::UNSUPPORTED_TRANSFER_ENCODING);
+                return false;
+            }
+        } else if (equals_ignore_case(name, "connection")) {
+            saw_connection_close_ |= has_token(value, "close");
+            saw_connection_keep_alive_ |= has_token(value, "keep-alive");
+        }
+        return true;
+    }
+
+    /**
+     * @brief The blank line after the headers: decide persistence and how the body is framed
+     */
+    bool finish_head() {
+        if (has_transfer_encoding_ && has_content_length_) {
+            fail(Error::BAD_CONTENT_LENGTH); // Both framings at once - a smuggling vector
+            return false;
+        }
+
+        // HTTP/1.1 is persistent unless told otherwise, HTTP/1.0 only when asked
+        keep_alive_ = version_minor_ == 1 ? !saw_connection_close_ : saw_connection_keep_alive_ && !saw_connection_close_;
+
+        if (chunked_) {
+            remaining_ = 0;
+            chunk_digits_ = 0;
+            state_ = State::CHUNK_SIZE;
+        } else if (content_length_ > 0) {
+            if (content_length_ > limits_.max_body_bytes) {
+                fail(Error::BODY_TOO_LARGE);
+                return false;
+            }
+            body_ = {pos_, content_length_};
+            body_size_ = content_length_;
+            remaining_ = content_length_;
+            state_ = State::BODY;
+        } else {
+            state_ = State::DONE;
+        }
+        return true;
+    }
+
+    /**
+     * @brief A chunk-size line has ended: a data chunk follows, or the trailers
+     */
+    bool start_chunk() {
+        chunk_digits_ = 0;
+        if (remaining_ == 0) {
+            trailer_start_ = pos_;
+            state_ = State::TRAILER_START;
+            return true;
+        }
+        if (body_size_ + remaining_ > limits_.max_body_bytes) {
+            fail(Error::BODY_TOO_LARGE);
+            return false;
+        }
+        chunks_.push_back({pos_, remaining_});
+        body_size_ += remaining_;
+        state_ = State::CHUNK_DATA;
+        return true;
+    }
+
+    // RFC 9110 tchar
+    static bool is_token(char c) {
+        static constexpr bool TABLE[128] = {
+            0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+            0,1,0,1,1,1,1,1, 0,0,1,1,0,1,1,0, 1,1,1,1,1,1,1,1, 1,1,0,0,0,0,0,0,
+            0,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1, 1,1,1,0,0,0,1,1,
+            1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1, 1,1,1,0,1,0,1,0
+        };
+        unsigned char u = static_cast<unsigned char>(c);
+        return u < 128 && TABLE[u];
+    }
+
+    // Visible characters (obs-text included); no spaces or controls
+    static bool is_target_char(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return u > 0x20 && u != 0x7F;
+    }
+
+    // Field values: visible characters, space and tab
+    static bool is_field_char(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return (u >= 0x20 && u != 0x7F) || u == '\t';
+    }
+
+    static int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static bool equals_ignore_case(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (lower(a[i]) != lower(b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static char lower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    static std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+        return text;
+    }
+
+    /**
+     * @brief Whether a comma-separated value lists token (case-insensitive)
+     */
+    static bool has_token(std::string_view value, std::string_view token) {
+        while (true) {
+            size_t comma = value.find(',');
+            if (equals_ignore_case(trim(value.substr(0, comma)), token)) {
+                return true;
+            }
+            if (comma == std::string_view::npos) {
+                return false;
+            }
+            value.remove_prefix(comma + 1);
+        }
+    }
+
+    static bool last_token_is(std::string_view value, std::string_view token) {
+        size_t comma = value.rfind(',');
+        return equals_ignore_case(trim(comma == std::string_view::npos ? value : value.substr(comma + 1)), token);
+    }
+};
+
+} // namespace http
+} // namespace medusaserv
+
+#endif // MEDUSASERV_HTTP_PARSER_HPP
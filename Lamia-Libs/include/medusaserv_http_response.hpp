@@ -0,0 +1,279 @@
+/**
+ * LIBMEDUSASERV_HTTP_RESPONSE HEADER v0.3.0a
+ * ===========================================
+ * Reentrant HTTP response builder for YOUR MedusaServ
+ * Scatter/gather output: static headers and bodies are sent from where
+ * they live, only the bytes that vary are written to a buffer
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves
+ *
+ * An HttpResponseBuilder lists a response (or several pipelined ones) as
+ * segments. Static segments - string literals, constant bodies - are
+ * referenced, so they must outlive the send. Everything else (numbers,
+ * copied values) is appended to a scratch buffer the caller owns, usually
+ * one taken from an HttpBufferPool. send() hands the segments to the
+ * kernel with one sendmsg per IOV_MAX of them; copy_to() flattens them for
+ * callers that need a contiguous response.
+ *
+ * Content-Length is always computed from the body given to finish(), or
+ * given to finish_headers() when the body follows by other means.
+ */
+
+#ifndef MEDUSASERV_HTTP_RESPONSE_HPP
+#define MEDUSASERV_HTTP_RESPONSE_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace medusaserv {
+namespace http {
+
+/**
+ * @brief Reusable byte buffers, shared between threads
+ *
+ * Buffers come back cleared but keep their capacity, so steady-state
+ * connections allocate nothing. Oversized buffers are dropped on release.
+ */
+class HttpBufferPool {
+public:
+    explicit HttpBufferPool(size_t max_pooled = 256, size_t max_capacity = 64 * 1024)
+        : max_pooled_(max_pooled), max_capacity_(max_capacity) {}
+
+    std::string acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            return std::string();
+        }
+        std::string buffer = std::move(free_.back());
+        free_.pop_back();
+        return buffer;
+    }
+
+    void release(std::string&& buffer) {
+        if (buffer.capacity() > max_capacity_) {
+            return;
+        }
+        buffer.clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < max_pooled_) {
+            free_.push_back(std::move(buffer));
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> free_;
+    size_t max_pooled_;
+    size_t max_capacity_;
+};
+
+/**
+ * @brief Builds responses as iovec segments over static text and a caller-owned scratch buffer
+ */
+class HttpResponseBuilder {
+public:
+    /**
+     * @param scratch Receives the bytes that are not static; appended to, never shrunk
+     */
+    explicit HttpResponseBuilder(std::string& scratch) : scratch_(scratch) {}
+
+    /**
+     * @brief A complete status line, CRLF included - e.g. "HTTP/1.1 200 OK\r\n"
+     */
+    HttpResponseBuilder& start(std::string_view status_line) {
+        return add_static(status_line);
+    }
+
+    /**
+     * @brief A complete static header line, CRLF included
+     */
+    HttpResponseBuilder& header(std::string_view line) {
+        return add_static(line);
+    }
+
+    /**
+     * @brief A header whose name is static and whose value is copied
+     * @param name_prefix Name, colon and space - e.g. "Content-Type: "
+     */
+    HttpResponseBuilder& header(std::string_view name_prefix, std::string_view value) {
+        add_static(name_prefix);
+        add_copy(value);
+        return add_static("\r\n");
+    }
+
+    /**
+     * @brief A header with a decimal value, formatted into the scratch buffer
+     */
+    HttpResponseBuilder& header(std::string_view name_prefix, size_t value) {
+        add_static(name_prefix);
+        add_number(value);
+        return add_static("\r\n");
+    }
+
+    /**
+     * @brief Content-Length for body, the blank line, then body itself unless omitted
+     * @param body Static - referenced, not copied
+     * @param send_body False for HEAD and other bodiless responses: the length is still announced
+     */
+    HttpResponseBuilder& finish(std::string_view body, bool send_body = true) {
+        header("Content-Length: ", body.size());
+        add_static("\r\n");
+        if (send_body) {
+            add_static(body);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Content-Length and the blank line, for a body sent separately (sendfile) or not at all
+     */
+    HttpResponseBuilder& finish_headers(size_t content_length) {
+        header("Content-Length: ", content_length);
+        return end_headers();
+    }
+
+    /**
+     * @brief The blank line alone - for responses that carry no Content-Length, such as 304
+     */
+    HttpResponseBuilder& end_headers() {
+        return add_static("\r\n");
+    }
+
+    /**
+     * @brief Reference text that outlives the send
+     */
+    HttpResponseBuilder& add_static(std::string_view text) {
+        if (text.empty()) {
+            return *this;
+        }
+        // Pieces that sit next to each other in memory share one iovec
+        if (!segments_.empty() && segments_.back().data &&
+            segments_.back().data + segments_.back().length == text.data()) {
+            segments_.back().length += text.size();
+        } else {
+            segments_.push_back({text.data(), 0, text.size()});
+        }
+        size_ += text.size();
+        return *this;
+    }
+
+    /**
+     * @brief Copy text into the scratch buffer
+     */
+    HttpResponseBuilder& add_copy(std::string_view text) {
+        if (text.empty()) {
+            return *this;
+        }
+        // Scratch segments are offsets: the buffer may reallocate as it grows
+        if (!segments_.empty() && !segments_.back().data &&
+            segments_.back().offset + segments_.back().length == scratch_.size()) {
+            segments_.back().length += text.size();
+        } else {
+            segments_.push_back({nullptr, scratch_.size(), text.size()});
+        }
+        scratch_.append(text);
+        size_ += text.size();
+        return *this;
+    }
+
+    HttpResponseBuilder& add_number(size_t value) {
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* begin = end;
+        do {
+            *--begin = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+        return add_copy(std::string_view(begin, static_cast<size_t>(end - begin)));
+    }
+
+    size_t size() const { return size_; }
+    size_t segment_count() const { return segments_.size(); }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Forget the segments; the scratch buffer is left to its owner
+     */
+    void clear() {
+        segments_.clear();
+        size_ = 0;
+    }
+
+    /**
+     * @brief Flatten into out, which must hold size() bytes
+     */
+    void copy_to(char* out) const {
+        for (const auto& segment : segments_) {
+            std::memcpy(out, bytes(segment), segment.length);
+            out += segment.length;
+        }
+    }
+
+    /**
+     * @brief Write every segment to socket_fd, resuming after partial writes
+     * @param more A body follows by other means (sendfile): let the kernel hold a partial packet
+     * @return False if the peer went away or the socket failed
+     */
+    bool send(int socket_fd, bool more = false) {
+        // Reused between sends: kept like segments_, so steady state allocates nothing
+        vectors_.clear();
+        for (const auto& segment : segments_) {
+            vectors_.push_back({const_cast<char*>(bytes(segment)), segment.length});
+        }
+
+        size_t first = 0;
+        while (first < vectors_.size()) {
+            struct msghdr message = {};
+            message.msg_iov = &vectors_[first];
+            message.msg_iovlen = std::min<size_t>(vectors_.size() - first, IOV_MAX);
+            // sendmsg rather than writev: MSG_NOSIGNAL keeps a closed peer from raising SIGPIPE
+            ssize_t written = sendmsg(socket_fd, &message, MSG_NOSIGNAL | (more ? MSG_MORE : 0));
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            size_t remaining = static_cast<size_t>(written);
+            while (first < vectors_.size() && remaining >= vectors_[first].iov_len) {
+                remaining -= vectors_[first].iov_len;
+                ++first;
+            }
+            if (remaining > 0) {
+                vectors_[first].iov_base = static_cast<char*>(vectors_[first].iov_base) + remaining;
+                vectors_[first].iov_len -= remaining;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Segment {
+        const char* data; // Static text, or nullptr for a scratch range
+        size_t offset;    // Into the scratch buffer
+        size_t length;
+    };
+
+    std::string& scratch_;
+    std::vector<Segment> segments_;
+    std::vector<struct iovec> vectors_; // send()'s working copy of segments_
+    size_t size_ = 0;
+
+    const char* bytes(const Segment& segment) const {
+        return segment.data ? segment.data : scratch_.data() + segment.offset;
+    }
+};
+
+} // namespace http
+} // namespace medusaserv
+
+#endif // MEDUSASERV_HTTP_RESPONSE_HPP
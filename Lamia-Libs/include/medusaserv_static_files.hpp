@@ -0,0 +1,681 @@
+/**
+ * LIBMEDUSASERV_STATIC_FILES HEADER v0.3.0a
+ * ==========================================
+ * Static file pipeline for YOUR MedusaServ
+ * Open-descriptor cache, conditional requests and kernel-side body
+ * transfer: file bytes never pass through user space
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves
+ *
+ * StaticFileCache keeps the most recently served files open together with
+ * their fstat results, ETag and Last-Modified, so a hit is a hash lookup
+ * and no syscalls. Every directory on a cached file's path is watched, not
+ * just its parent: a thread started with the first watch drains inotify,
+ * and a write, attribute change, rename or delete of the file or of any
+ * directory or symlink leading to it ("current -> release-2" swapped)
+ * drops the entry - under every spelling of its path - so the next request
+ * reopens it. Without inotify, or when a watch can't be added, entries are
+ * revalidated with stat() instead.
+ *
+ * Entries are shared_ptrs: a file evicted or invalidated mid-transfer
+ * stays open until its last sender finishes.
+ *
+ * Bodies go out with send_file_body() (sendfile) to plain sockets, or with
+ * splice_file_body() through a pipe when the destination is a TLS offload
+ * socket or pipe that sendfile cannot feed.
+ */
+
+#ifndef MEDUSASERV_STATIC_FILES_HPP
+#define MEDUSASERV_STATIC_FILES_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace medusaserv {
+namespace http {
+
+/**
+ * @brief One open file and what its responses say about it
+ */
+struct StaticFile {
+    int fd = -1;
+    off_t size = 0;
+    struct timespec modified = {};
+    ino_t inode = 0;
+    dev_t device = 0;
+    std::string path;
+    std::string etag;          // Strong validator, quotes included
+    std::string last_modified; // IMF-fixdate
+    std::string_view content_type;
+
+    StaticFile() = default;
+    StaticFile(const StaticFile&) = delete;
+    StaticFile& operator=(const StaticFile&) = delete;
+    ~StaticFile() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+/**
+ * @brief An HTTP-date (IMF-fixdate), e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+ */
+inline std::string format_http_date(time_t when) {
+    struct tm parts;
+    gmtime_r(&when, &parts);
+    char text[32];
+    size_t length = strftime(text, sizeof(text), "%a, %d %b %Y %H:%M:%S GMT", &parts);
+    return std::string(text, length);
+}
+
+/**
+ * @brief Parse an IMF-fixdate; -1 if value is not one
+ */
+inline time_t parse_http_date(std::string_view value) {
+    std::string text(value);
+    struct tm parts = {};
+    const char* end = strptime(text.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &parts);
+    if (!end || *end) {
+        return -1;
+    }
+    return timegm(&parts);
+}
+
+inline std::string_view content_type_for(std::string_view path) {
+    static const std::pair<std::string_view, std::string_view> TYPES[] = {
+        {".html", "text/html; charset=utf-8"},
+        {".htm", "text/html; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"},
+        {".js", "text/javascript; charset=utf-8"},
+        {".mjs", "text/javascript; charset=utf-8"},
+        {".json", "application/json"},
+        {".map", "application/json"},
+        {".wasm", "application/wasm"},
+        {".svg", "image/svg+xml"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".webp", "image/webp"},
+        {".ico", "image/x-icon"},
+        {".woff", "font/woff"},
+        {".woff2", "font/woff2"},
+        {".ttf", "font/ttf"},
+        {".otf", "font/otf"},
+        {".txt", "text/plain; charset=utf-8"},
+        {".xml", "application/xml"},
+        {".pdf", "application/pdf"},
+        {".mp4", "video/mp4"},
+        {".webm", "video/webm"},
+        {".mp3", "audio/mpeg"},
+    };
+    size_t dot = path.rfind('.');
+    size_t slash = path.rfind('/');
+    if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+        return "application/octet-stream";
+    }
+    std::string_view extension = path.substr(dot);
+    for (const auto& [suffix, type] : TYPES) {
+        if (extension.size() == suffix.size()) {
+            bool same = true;
+            for (size_t i = 0; i < suffix.size() && same; ++i) {
+                char c = extension[i];
+                same = (c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c) == suffix[i];
+            }
+            if (same) {
+                return type;
+            }
+        }
+    }
+    return "application/octet-stream";
+}
+
+/**
+ * @brief Percent-decode a request path; false on a bad escape or an encoded NUL
+ */
+inline bool decode_request_path(std::string_view path, std::string& decoded) {
+    decoded.clear();
+    decoded.reserve(path.size());
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (path[i] != '%') {
+            decoded += path[i];
+            continue;
+        }
+        auto hex = [](char c) {
+            return c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+        };
+        if (i + 2 >= path.size() || hex(path[i + 1]) < 0 || hex(path[i + 2]) < 0) {
+            return false;
+        }
+        char c = static_cast<char>(hex(path[i + 1]) * 16 + hex(path[i + 2]));
+        if (c == '\0') {
+            return false;
+        }
+        decoded += c;
+        i += 2;
+    }
+    return true;
+}
+
+/**
+ * @brief Whether a decoded path has a "." or ".." segment
+ */
+inline bool has_dot_segment(std::string_view path) {
+    while (!path.empty()) {
+        size_t slash = path.find('/');
+        std::string_view segment = path.substr(0, slash);
+        if (segment == "." || segment == "..") {
+            return true;
+        }
+        if (slash == std::string_view::npos) {
+            break;
+        }
+        path.remove_prefix(slash + 1);
+    }
+    return false;
+}
+
+/**
+ * @brief Whether a conditional request can be answered 304 Not Modified
+ *
+ * If-None-Match wins when present (weak comparison, "*" included);
+ * If-Modified-Since is consulted only without it (RFC 9110 13.2.2).
+ */
+inline bool is_not_modified(const StaticFile& file, std::string_view if_none_match, std::string_view if_modified_since) {
+    if (!if_none_match.empty()) {
+        auto opaque = [](std::string_view tag) {
+            while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t')) tag.remove_prefix(1);
+            while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t')) tag.remove_suffix(1);
+            if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+            return tag;
+        };
+        std::string_view ours = opaque(file.etag);
+        while (true) {
+            size_t comma = if_none_match.find(',');
+            std::string_view tag = opaque(if_none_match.substr(0, comma));
+            if (tag == "*" || tag == ours) {
+                return true;
+            }
+            if (comma == std::string_view::npos) {
+                return false;
+            }
+            if_none_match.remove_prefix(comma + 1);
+        }
+    }
+    if (!if_modified_since.empty()) {
+        time_t since = parse_http_date(if_modified_since);
+        return since >= 0 && file.modified.tv_sec <= since;
+    }
+    return false;
+}
+
+/**
+ * @brief Wait until a non-blocking socket can take more; false on timeout
+ */
+inline bool wait_writable(int socket_fd, int timeout_ms = 30000) {
+    struct pollfd writable = {socket_fd, POLLOUT, 0};
+    int ready;
+    do {
+        ready = poll(&writable, 1, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    return ready > 0;
+}
+
+/**
+ * @brief Send length bytes of file_fd from offset with sendfile: page cache to socket
+ */
+inline bool send_file_body(int socket_fd, int file_fd, off_t offset, size_t length) {
+    while (length > 0) {
+        ssize_t sent = sendfile(socket_fd, file_fd, &offset, length);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN && wait_writable(socket_fd)) {
+                continue;
+            }
+            return false;
+        }
+        if (sent == 0) {
+            return false; // The file shrank under us
+        }
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Move length bytes of file_fd from offset to out_fd through a pipe, never copying to user space
+ *
+ * For destinations sendfile cannot target - a pipe to a TLS terminator, or
+ * a kTLS socket - the pages are spliced file -> pipe -> out_fd. Each thread
+ * keeps one pipe for this.
+ */
+inline bool splice_file_body(int out_fd, int file_fd, off_t offset, size_t length) {
+    struct ThreadPipe {
+        int ends[2] = {-1, -1};
+        ~ThreadPipe() { reset(); }
+        void reset() {
+            for (int& end : ends) {
+                if (end >= 0) close(end);
+                end = -1;
+            }
+        }
+    };
+    thread_local ThreadPipe pipe;
+    if (pipe.ends[0] < 0 && pipe2(pipe.ends, O_CLOEXEC) < 0) {
+        return false;
+    }
+
+    loff_t position = offset;
+    while (length > 0) {
+        ssize_t filled = splice(file_fd, &position, pipe.ends[1], nullptr, length, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (filled < 0 && errno == EINTR) {
+            continue;
+        }
+        if (filled <= 0) {
+            return false;
+        }
+        size_t in_pipe = static_cast<size_t>(filled);
+        while (in_pipe > 0) {
+            ssize_t drained = splice(pipe.ends[0], nullptr, out_fd, nullptr, in_pipe, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (drained < 0 && errno == EINTR) {
+                continue;
+            }
+            if (drained < 0 && errno == EAGAIN && wait_writable(out_fd)) {
+                continue;
+            }
+            if (drained <= 0) {
+                pipe.reset(); // Bytes left in the pipe would prefix the next transfer
+                return false;
+            }
+            in_pipe -= static_cast<size_t>(drained);
+        }
+        length -= static_cast<size_t>(filled);
+    }
+    return true;
+}
+
+/**
+ * @brief LRU cache of open regular files, invalidated by inotify
+ */
+class StaticFileCache {
+public:
+    explicit StaticFileCache(size_t capacity = 1024) : capacity_(capacity ? capacity : 1) {
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+
+    ~StaticFileCache() {
+        if (watcher_.joinable()) {
+            uint64_t stop = 1;
+            ssize_t ignored = write(stop_fd_, &stop, sizeof(stop));
+            (void)ignored;
+            watcher_.join();
+        }
+        if (stop_fd_ >= 0) {
+            close(stop_fd_);
+        }
+        if (inotify_fd_ >= 0) {
+            close(inotify_fd_);
+        }
+    }
+
+    StaticFileCache(const StaticFileCache&) = delete;
+    StaticFileCache& operator=(const StaticFileCache&) = delete;
+
+    /**
+     * @brief The open file at path, from the cache or freshly opened; null if it is not a readable regular file
+     */
+    std::shared_ptr<const StaticFile> open(const std::string& path) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it != entries_.end()) {
+            if (!it->second.watches.empty() || still_current(*it->second.file)) {
+                lru_.splice(lru_.begin(), lru_, it->second.position);
+                ++hits_;
+                return it->second.file;
+            }
+            erase(it);
+        }
+        ++misses_;
+        lock.unlock();
+
+        // Open outside the lock: a slow disk must not stall hits on other files
+        std::shared_ptr<StaticFile> file = load(path);
+        if (!file) {
+            return nullptr;
+        }
+
+        lock.lock();
+        it = entries_.find(path);
+        if (it != entries_.end()) {
+            erase(it); // Another thread got here first; keep the newer open
+        }
+        std::vector<Watch> watches = watch_path(path);
+        if (!watches.empty() && !still_current(*file)) {
+            // Changed between the open and the watches: serve it this once, cache nothing stale
+            release_watches(watches, path);
+            return file;
+        }
+        lru_.push_front(path);
+        entries_.emplace(path, Entry{file, lru_.begin(), std::move(watches)});
+        while (entries_.size() > capacity_) {
+            erase(entries_.find(lru_.back()));
+        }
+        return file;
+    }
+
+    /**
+     * @brief Drop path, e.g. after the server itself rewrote it
+     */
+    void invalidate(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it != entries_.end()) {
+            erase(it);
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!entries_.empty()) {
+            erase(entries_.begin());
+        }
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    uint64_t hits() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+
+    uint64_t misses() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+
+    bool watching() const { return inotify_fd_ >= 0; }
+
+private:
+    /**
+     * @brief A directory on an entry's path and the name the path takes in it
+     */
+    struct Watch {
+        int descriptor;
+        std::string name;
+    };
+
+    struct Entry {
+        std::shared_ptr<const StaticFile> file;
+        std::list<std::string>::iterator position;
+        std::vector<Watch> watches; // File's directory first, then each ancestor; empty when unwatched
+    };
+
+    /**
+     * @brief One inotify watch and the entries it covers
+     *
+     * Keyed by name, not by path: "/a//b.txt", "/a/./b.txt" and a path
+     * through a symlinked directory all share one watch, and an event for
+     * b.txt must drop every one of them.
+     */
+    struct Directory {
+        std::unordered_multimap<std::string, std::string> names; // Name in this directory -> cache key
+    };
+
+    std::mutex mutex_;
+    size_t capacity_;
+    std::list<std::string> lru_; // Most recently used first
+    std::unordered_map<std::string, Entry> entries_;
+    int inotify_fd_ = -1;
+    int stop_fd_ = -1;
+    std::thread watcher_; // Drains inotify; started with the first watch
+    std::unordered_map<int, Directory> directories_; // By watch descriptor
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+
+    static constexpr uint32_t WATCH_EVENTS = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO |
+                                             IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    static std::shared_ptr<StaticFile> load(const std::string& path) {
+        // O_NONBLOCK: opening a FIFO for reading would otherwise wait for a writer.
+        // Regular files ignore the flag, so reads and sendfile behave as usual
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK | O_NOCTTY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        auto file = std::make_shared<StaticFile>();
+        file->fd = fd;
+        struct stat info;
+        if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode)) {
+            return nullptr; // Directories, FIFOs and devices are never served
+        }
+        file->size = info.st_size;
+        file->modified = info.st_mtim;
+        file->inode = info.st_ino;
+        file->device = info.st_dev;
+        file->path = path;
+        file->content_type = content_type_for(path);
+        file->last_modified = format_http_date(info.st_mtim.tv_sec);
+
+        // Inode, size and nanosecond mtime: any rewrite or replacement changes it
+        char etag[64];
+        int length = std::snprintf(etag, sizeof(etag), "\"%llx-%llx-%llx\"",
+                                   static_cast<unsigned long long>(info.st_ino),
+                                   static_cast<unsigned long long>(info.st_size),
+                                   static_cast<unsigned long long>(info.st_mtim.tv_sec) * 1000000000ULL +
+                                       static_cast<unsigned long long>(info.st_mtim.tv_nsec));
+        file->etag.assign(etag, static_cast<size_t>(length));
+        return file;
+    }
+
+    /**
+     * @brief Without inotify: whether the path still names the file as it was opened
+     */
+    static bool still_current(const StaticFile& file) {
+        struct stat info;
+        return stat(file.path.c_str(), &info) == 0 && info.st_ino == file.inode && info.st_dev == file.device &&
+               info.st_size == file.size && info.st_mtim.tv_sec == file.modified.tv_sec &&
+               info.st_mtim.tv_nsec == file.modified.tv_nsec;
+    }
+
+    static std::string parent_of(const std::string& path) {
+        size_t slash = path.rfind('/');
+        if (slash == std::string::npos) {
+            return ".";
+        }
+        return slash == 0 ? "/" : path.substr(0, slash);
+    }
+
+    static std::string name_of(const std::string& path) {
+        size_t slash = path.rfind('/');
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    /**
+     * @brief Watch every directory path passes through, up to "/" or the working directory
+     *
+     * Each directory is watched by the name the path takes in it, so an
+     * ancestor renamed or a symlinked component replaced drops the entry
+     * as a change to the file itself does. Empty if any watch fails.
+     */
+    std::vector<Watch> watch_path(const std::string& path) {
+        std::vector<Watch> watches;
+        if (inotify_fd_ < 0) {
+            return watches;
+        }
+        if (!watcher_.joinable()) {
+            stop_fd_ = eventfd(0, EFD_CLOEXEC);
+            if (stop_fd_ < 0) {
+                close(inotify_fd_);
+                inotify_fd_ = -1; // Fall back to stat() revalidation
+                return watches;
+            }
+            watcher_ = std::thread(&StaticFileCache::watch_events, this);
+        }
+        std::string below = path;
+        while (true) {
+            std::string directory = parent_of(below);
+            std::string name = name_of(below);
+            if (!name.empty() && name != "." && name != "..") { // Events never carry these names
+                // Watching a directory again returns the same descriptor
+                int watch = inotify_add_watch(inotify_fd_, directory.c_str(), WATCH_EVENTS);
+                if (watch < 0) {
+                    release_watches(watches, path);
+                    watches.clear();
+                    return watches;
+                }
+                directories_[watch].names.emplace(name, path);
+                watches.push_back(Watch{watch, std::move(name)});
+            }
+            if (directory == "/" || directory == "." || directory == below) {
+                return watches;
+            }
+            below = std::move(directory);
+        }
+    }
+
+    void erase(std::unordered_map<std::string, Entry>::iterator it) {
+        release_watches(it->second.watches, it->first);
+        lru_.erase(it->second.position);
+        entries_.erase(it);
+    }
+
+    void release_watches(const std::vector<Watch>& watches, const std::string& path) {
+        for (const auto& watch : watches) {
+            auto directory = directories_.find(watch.descriptor);
+            if (directory == directories_.end()) {
+                continue;
+            }
+            auto& names = directory->second.names;
+            auto range = names.equal_range(watch.name);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == path) {
+                    names.erase(it);
+                    break;
+                }
+            }
+            if (names.empty()) {
+                inotify_rm_watch(inotify_fd_, watch.descriptor);
+                directories_.erase(directory);
+            }
+        }
+    }
+
+    /**
+     * @brief Drop the entries with this name in directory - every name when it is empty
+     */
+    void erase_names(std::unordered_map<int, Directory>::iterator directory, const char* name) {
+        // Erasing may drop the watch, so collect first
+        std::vector<std::string> stale;
+        auto& names = directory->second.names;
+        if (name) {
+            auto range = names.equal_range(name);
+            for (auto it = range.first; it != range.second; ++it) {
+                stale.push_back(it->second);
+            }
+        } else {
+            for (const auto& [entry_name, path] : names) {
+                stale.push_back(path);
+            }
+        }
+        for (const auto& path : stale) {
+            auto entry = entries_.find(path);
+            if (entry != entries_.end()) {
+                erase(entry);
+            }
+        }
+    }
+
+    /**
+     * @brief Watcher thread: apply inotify events as they arrive, until the cache is destroyed
+     */
+    void watch_events() {
+        struct pollfd sources[2] = {{inotify_fd_, POLLIN, 0}, {stop_fd_, POLLIN, 0}};
+        while (true) {
+            if (poll(sources, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            if (sources[1].revents) {
+                return;
+            }
+            if (sources[0].revents) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                drain_events();
+            }
+        }
+    }
+
+    /**
+     * @brief Apply queued inotify events: drop every entry whose file may have changed
+     */
+    void drain_events() {
+        if (inotify_fd_ < 0) {
+            return;
+        }
+        alignas(struct inotify_event) char events[4096];
+        while (true) {
+            ssize_t length = read(inotify_fd_, events, sizeof(events));
+            if (length < 0 && errno == EINTR) {
+                continue;
+            }
+            if (length <= 0) {
+                return;
+            }
+            for (char* cursor = events; cursor < events + length;) {
+                const auto* event = reinterpret_cast<const struct inotify_event*>(cursor);
+                cursor += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    while (!entries_.empty()) {
+                        erase(entries_.begin()); // Events were lost: trust nothing
+                    }
+                    continue;
+                }
+                auto directory = directories_.find(event->wd);
+                if (directory == directories_.end()) {
+                    continue;
+                }
+                if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                    erase_names(directory, nullptr);
+                    directories_.erase(event->wd);
+                    continue;
+                }
+                if (event->len > 0) {
+                    erase_names(directory, event->name); // Every spelling of the path
+                }
+            }
+        }
+    }
+};
+
+} // namespace http
+} // namespace medusaserv
+
+#endif // MEDUSASERV_STATIC_FILES_HPP
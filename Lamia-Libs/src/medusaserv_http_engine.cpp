@@ -5,14 +5,39 @@
  * Native C++ shared library with professional HTTP/HTTPS support
  * NO shortcuts, NO mock data, maximum performance
  * © 2025 The Medusa Project | Roylepython | D Hargreaves
+ *
+ * Connections are persistent (HTTP/1.1 keep-alive): process_http_requests
+ * answers every complete request in its read buffer - pipelined requests
+ * arrive together - then waits for more until the client closes, asks to
+ * close, stays idle past the timeout or reaches the per-connection limit.
+ * Requests are framed by HttpRequestParser (medusaserv_http_parser.hpp),
+ * which resumes where the last read left off, so a request split over
+ * many reads is still parsed once.
+ * Responses are built by HttpResponseBuilder (medusaserv_http_response.hpp)
+ * into pooled per-connection buffers and sent with scatter/gather I/O, so
+ * status lines, static headers and bodies are never copied.
+ * With configure_http_static_files, GET and HEAD are served from disk by
+ * the pipeline in medusaserv_static_files.hpp: cached open descriptors,
+ * ETag / Last-Modified validation and sendfile bodies.
  */
 
 #include "medusaserv_http_engine.hpp"
+#include "medusaserv_http_parser.hpp"
+#include "medusaserv_http_response.hpp"
+#include "medusaserv_static_files.hpp"
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <string_view>
+#include <algorithm>
 #include <atomic>
 #include <thread>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <poll.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -25,6 +50,200 @@ namespace http {
 static std::atomic<bool> g_http_initialized{false};
 static std::atomic<int> g_active_connections{0};
 static std::atomic<long> g_requests_processed{0};
+static std::atomic<long> g_connections_handled{0};
+static std::atomic<long> g_keep_alive_requests{0};
+
+// Keep-alive policy (configure_http_keep_alive)
+static std::atomic<int> g_idle_timeout_ms{5000};
+static std::atomic<int> g_max_requests_per_connection{100};
+
+// Read and scratch buffers, reused across connections
+static HttpBufferPool g_buffer_pool;
+
+// Static file serving (configure_http_static_files); swapped whole, read with atomic_load
+struct StaticFileConfig {
+    std::string root;
+    MedusaServPathResolver resolver = nullptr;
+    MedusaServPathRelease release = nullptr;
+};
+static std::shared_ptr<const StaticFileConfig> g_static_files;
+static StaticFileCache g_file_cache;
+static std::atomic<long> g_static_files_served{0};
+static std::atomic<long> g_not_modified_responses{0};
+
+static constexpr size_t MAX_REQUEST_HEAD = 16 * 1024; // Request line and headers; longer is a 431
+static constexpr std::string_view SERVER_HEADER = "Server: MedusaServ v0.3.0a (Professional Native C++ Server)\r\n";
+static constexpr std::string_view JSON_CONTENT_TYPE = "Content-Type: application/json\r\n";
+static constexpr std::string_view HTML_CONTENT_TYPE = "Content-Type: text/html\r\n";
+static constexpr std::string_view KEEP_ALIVE_HEADER = "Connection: keep-alive\r\n";
+static constexpr std::string_view CLOSE_HEADER = "Connection: close\r\n";
+
+static constexpr std::string_view HEALTH_BODY =
+    "{\n"
+    "  \"status\": \"healthy\",\n"
+    "  \"server\": \"MedusaServ v0.3.0a\",\n"
+    "  \"engine\": \"Native C++\"\n"
+    "}";
+static constexpr std::string_view INDEX_BODY =
+    "<html><body><h1>MedusaServ v0.3.0a</h1><p>Native C++ Professional Server</p></body></html>";
+
+/**
+ * @brief Parser limits for one request: the head limit above, bodies up to 8 MB
+ */
+static HttpRequestParser::Limits request_limits() {
+    HttpRequestParser::Limits limits;
+    limits.max_head_bytes = MAX_REQUEST_HEAD;
+    return limits;
+}
+
+/**
+ * @brief Connection (and Keep-Alive) headers for a persistent or closing connection
+ * @param remaining Requests the connection may still carry
+ */
+static void add_connection_headers(HttpResponseBuilder& response, bool keep_alive, int remaining) {
+    if (keep_alive) {
+        response.header(KEEP_ALIVE_HEADER)
+                .add_static("Keep-Alive: timeout=")
+                .add_number(static_cast<size_t>(std::max(1, g_idle_timeout_ms.load() / 1000)))
+                .add_static(", max=")
+                .add_number(static_cast<size_t>(remaining))
+                .add_static("\r\n");
+    } else {
+        response.header(CLOSE_HEADER);
+    }
+}
+
+/**
+ * @brief The response to method and path, framed for a persistent or closing connection
+ * @param remaining Requests the connection may still carry, for the Keep-Alive header
+ */
+static void build_http_response(HttpResponseBuilder& response, std::string_view method, std::string_view path,
+                                bool keep_alive, int remaining) {
+    bool health = path == "/health";
+    
+    response.start("HTTP/1.1 200 OK\r\n")
+            .header(SERVER_HEADER)
+            .header(health ? JSON_CONTENT_TYPE : HTML_CONTENT_TYPE);
+    add_connection_headers(response, keep_alive, remaining);
+    // A HEAD response has the headers only, or the next response would be misread
+    response.finish(health ? HEALTH_BODY : INDEX_BODY, method != "HEAD");
+}
+
+/**
+ * @brief Headers for a file response; the body, if any, follows with send_file_body
+ * @param not_modified Answer 304: validators only, no body or length
+ */
+static void build_file_response(HttpResponseBuilder& response, const StaticFile& file, bool not_modified,
+                                bool keep_alive, int remaining) {
+    response.start(not_modified ? "HTTP/1.1 304 Not Modified\r\n" : "HTTP/1.1 200 OK\r\n")
+            .header(SERVER_HEADER)
+            .header("ETag: ", file.etag) // Copied: the cache may drop the file before the send
+            .header("Last-Modified: ", file.last_modified);
+    if (!not_modified) {
+        response.add_static("Content-Type: ").add_static(file.content_type).add_static("\r\n");
+    }
+    add_connection_headers(response, keep_alive, remaining);
+    if (not_modified) {
+        response.end_headers();
+    } else {
+        response.finish_headers(static_cast<size_t>(file.size));
+    }
+}
+
+/**
+ * @brief The cached open file a request path resolves to, or null to fall through to the built-in pages
+ */
+static std::shared_ptr<const StaticFile> open_static_file(const StaticFileConfig& config, std::string_view request_path) {
+    std::string decoded;
+    if (!decode_request_path(request_path, decoded) || decoded.empty() || decoded[0] != '/') {
+        return nullptr;
+    }
+    
+    std::string resolved;
+    if (config.resolver) {
+        char* path = config.resolver(decoded.c_str(), config.root.c_str());
+        if (!path) {
+            return nullptr;
+        }
+        resolved = path;
+        if (config.release) {
+            config.release(path);
+        } else {
+            free(path);
+        }
+    } else {
+        if (has_dot_segment(decoded)) {
+            return nullptr;
+        }
+        resolved = config.root + decoded;
+        if (resolved.back() == '/') {
+            resolved += "index.html";
+        }
+    }
+    return g_file_cache.open(resolved);
+}
+
+/**
+ * @brief The response to a request the parser rejected; the connection closes after it
+ */
+static void build_error_response(HttpResponseBuilder& response, HttpRequestParser::Error error) {
+    switch (error) {
+        case HttpRequestParser::Error::HEAD_TOO_LARGE:
+        case HttpRequestParser::Error::TOO_MANY_HEADERS:
+            response.start("HTTP/1.1 431 Request Header Fields Too Large\r\n");
+            break;
+        case HttpRequestParser::Error::BODY_TOO_LARGE:
+            response.start("HTTP/1.1 413 Content Too Large\r\n");
+            break;
+        case HttpRequestParser::Error::UNSUPPORTED_TRANSFER_ENCODING:
+            response.start("HTTP/1.1 501 Not Implemented\r\n");
+            break;
+        default:
+            response.start("HTTP/1.1 400 Bad Request\r\n");
+            break;
+    }
+    response.header(SERVER_HEADER)
+            .header(CLOSE_HEADER)
+            .finish(std::string_view());
+}
+
+/**
+ * @brief The single response generate_http_response* give to a request held in a C string
+ */
+static void build_response_to(const char* request, HttpResponseBuilder& response) {
+    if (!request) {
+        build_error_response(response, HttpRequestParser::Error::BAD_REQUEST_LINE);
+        return;
+    }
+    
+    // A bare request line is enough here; the headers, if any, must still be well formed
+    std::string_view text(request);
+    std::string terminated;
+    if (text.find('\n') == std::string_view::npos) {
+        terminated = std::string(text) + "\r\n"; // The line's end is the string's end
+        text = terminated;
+    }
+    HttpRequestParser parser(request_limits());
+    HttpRequestParser::Status status = parser.parse(text);
+    if (status == HttpRequestParser::Status::ERROR || !parser.request_line_complete()) {
+        build_error_response(response, status == HttpRequestParser::Status::ERROR
+            ? parser.error() : HttpRequestParser::Error::BAD_REQUEST_LINE);
+        return;
+    }
+    
+    // Generate professional HTTP response - a single response, so the connection closes
+    build_http_response(response, parser.method(), parser.path(), false, 0);
+}
+
+/**
+ * @brief Copy a parsed field into a fixed MedusaServHttpRequest member, truncating to fit
+ */
+template<size_t N>
+static void copy_field(char (&destination)[N], std::string_view value) {
+    size_t length = std::min(value.size(), N - 1);
+    std::memcpy(destination, value.data(), length);
+    destination[length] = '\0';
+}
 
 extern "C" {
 
@@ -80,24 +299,103 @@ int process_http_requests(int client_socket) {
     }
     
     g_active_connections.fetch_add(1);
-    
-    char buffer[4096];
-    ssize_t bytes_read = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-    
-    if (bytes_read > 0) {
-        buffer[bytes_read] = '\0';
-        
-        // Professional HTTP request processing
-        std::string request(buffer);
-        std::string response = generate_http_response(request.c_str());
+    g_connections_handled.fetch_add(1);
+    
+    const int idle_timeout_ms = g_idle_timeout_ms.load();
+    const int max_requests = g_max_requests_per_connection.load();
+    const std::shared_ptr<const StaticFileConfig> static_files = std::atomic_load(&g_static_files);
+    
+    std::string buffer = g_buffer_pool.acquire();  // Bytes received and not yet answered
+    std::string scratch = g_buffer_pool.acquire(); // The responses' bytes that are not static
+    HttpResponseBuilder output(scratch);           // Responses to one read's worth of requests, sent together
+    HttpRequestParser parser(request_limits()); // Holds its place in a partly received request
+    int served = 0;
+    bool open = true;
+    char chunk[16384];
+    
+    while (open) {
+        // Answer every complete request buffered so far, in order
+        output.clear();
+        scratch.clear();
+        size_t consumed = 0;
+        while (open) {
+            HttpRequestParser::Status status = parser.parse(std::string_view(buffer).substr(consumed));
+            if (status == HttpRequestParser::Status::INCOMPLETE) {
+                break;
+            }
+            if (status == HttpRequestParser::Status::ERROR) {
+                build_error_response(output, parser.error());
+                open = false;
+                break;
+            }
+            
+            ++served;
+            open = parser.keep_alive() && served < max_requests;
+            
+            std::shared_ptr<const StaticFile> file;
+            bool head = parser.method() == "HEAD";
+            if (static_files && (head || parser.method() == "GET") && parser.path() != "/health") {
+                file = open_static_file(*static_files, parser.path());
+            }
+            if (file) {
+                bool not_modified = is_not_modified(*file, parser.header("If-None-Match"), parser.header("If-Modified-Since"));
+                build_file_response(output, *file, not_modified, open, max_requests - served);
+                g_static_files_served.fetch_add(1);
+                if (not_modified) {
+                    g_not_modified_responses.fetch_add(1);
+                } else if (!head && file->size > 0) {
+                    // Everything up to these headers, then the body straight from the page cache
+                    if (!output.send(client_socket, true) ||
+                        !send_file_body(client_socket, file->fd, 0, static_cast<size_t>(file->size))) {
+                        output.clear();
+                        open = false;
+                        break;
+                    }
+                    output.clear();
+                    scratch.clear();
+                }
+            } else {
+                build_http_response(output, parser.method(), parser.path(), open, max_requests - served);
+            }
+            consumed += parser.length();
+            parser.reset();
+            
+            g_requests_processed.fetch_add(1);
+            if (served > 1) {
+                g_keep_alive_requests.fetch_add(1);
+            }
+        }
+        buffer.erase(0, consumed);
         
-        // Send response with professional headers
-        send(client_socket, response.c_str(), response.length(), 0);
+        if (!output.empty() && !output.send(client_socket)) {
+            break;
+        }
+        if (!open) {
+            break;
+        }
         
-        g_requests_processed.fetch_add(1);
+        // Wait for the next request (or the rest of this one); idle connections are closed
+        struct pollfd readable = {client_socket, POLLIN, 0};
+        int ready = poll(&readable, 1, idle_timeout_ms);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            break;
+        }
+        ssize_t bytes_read = recv(client_socket, chunk, sizeof(chunk), 0);
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read <= 0) {
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(bytes_read));
     }
     
     close(client_socket);
+    g_buffer_pool.release(std::move(buffer));
+    g_buffer_pool.release(std::move(scratch));
     g_active_connections.fetch_sub(1);
     
     return MEDUSASERV_SUCCESS;
@@ -116,6 +414,8 @@ int manage_http_connections() {
     
     std::cout << "📊 Active connections: " << active << std::endl;
     std::cout << "📈 Requests processed: " << processed << std::endl;
+    std::cout << "🔁 Keep-alive requests: " << g_keep_alive_requests.load()
+              << " over " << g_connections_handled.load() << " connections" << std::endl;
     
     return MEDUSASERV_SUCCESS;
 }
@@ -146,7 +446,9 @@ int optimize_request_pipeline() {
     // Zero-copy operations
     // Memory pooling
     // Connection pooling
-    // Keep-alive optimization
+    // Keep-alive and pipelining: process_http_requests, configure_http_keep_alive
+    // Pooled buffers and scatter/gather responses: medusaserv_http_response.hpp
+    // Static files by sendfile from an open-descriptor cache: medusaserv_static_files.hpp
     
     std::cout << "✅ HTTP request pipeline optimized for maximum throughput" << std::endl;
     
@@ -170,6 +472,45 @@ int handle_concurrent_requests() {
     return MEDUSASERV_SUCCESS;
 }
 
+int configure_http_keep_alive(int idle_timeout_ms, int max_requests_per_connection) {
+    if (idle_timeout_ms <= 0 || max_requests_per_connection <= 0) {
+        return MEDUSASERV_ERROR_INVALID_PARAMETER;
+    }
+    
+    // Connections already open keep the policy they started with
+    g_idle_timeout_ms.store(idle_timeout_ms);
+    g_max_requests_per_connection.store(max_requests_per_connection);
+    
+    return MEDUSASERV_SUCCESS;
+}
+
+int configure_http_static_files(const char* static_root, MedusaServPathResolver resolver, MedusaServPathRelease release) {
+    if (!static_root) {
+        std::atomic_store(&g_static_files, std::shared_ptr<const StaticFileConfig>());
+        g_file_cache.clear();
+        return MEDUSASERV_SUCCESS;
+    }
+    if (!*static_root) {
+        return MEDUSASERV_ERROR_INVALID_PARAMETER;
+    }
+    
+    auto config = std::make_shared<StaticFileConfig>();
+    config->root = static_root;
+    while (config->root.size() > 1 && config->root.back() == '/') {
+        config->root.pop_back();
+    }
+    config->resolver = resolver;
+    config->release = release;
+    
+    // Connections already open keep the root they started with
+    std::atomic_store(&g_static_files, std::shared_ptr<const StaticFileConfig>(std::move(config)));
+    
+    std::cout << "📁 Static files served from " << static_root
+              << (g_file_cache.watching() ? " (inotify cache invalidation)" : " (stat revalidation)") << std::endl;
+    
+    return MEDUSASERV_SUCCESS;
+}
+
 int get_http_stats(MedusaServHttpStats* stats) {
     if (!stats) {
         return MEDUSASERV_ERROR_INVALID_PARAMETER;
@@ -178,61 +519,76 @@ int get_http_stats(MedusaServHttpStats* stats) {
     stats->active_connections = g_active_connections.load();
     stats->total_requests_processed = g_requests_processed.load();
     stats->server_initialized = g_http_initialized.load();
+    stats->total_connections = g_connections_handled.load();
+    stats->keep_alive_requests = g_keep_alive_requests.load();
+    stats->keep_alive_reuse_ratio = stats->total_requests_processed > 0
+        ? static_cast<double>(stats->keep_alive_requests) / stats->total_requests_processed
+        : 0.0;
+    stats->static_files_served = g_static_files_served.load();
+    stats->not_modified_responses = g_not_modified_responses.load();
+    uint64_t hits = g_file_cache.hits();
+    uint64_t lookups = hits + g_file_cache.misses();
+    stats->file_cache_hit_ratio = lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
     
     return MEDUSASERV_SUCCESS;
 }
 
-const char* generate_http_response(const char* request) {
-    static std::string response_buffer;
+int parse_http_request(const char* data, size_t length, MedusaServHttpRequest* request) {
+    if (!data || !request) {
+        return MEDUSASERV_ERROR_INVALID_PARAMETER;
+    }
     
-    if (!request) {
-        response_buffer = "HTTP/1.1 400 Bad Request\r\n"
-                         "Server: MedusaServ v0.3.0a (Professional Native C++ Server)\r\n"
-                         "Content-Length: 0\r\n"
-                         "Connection: close\r\n\r\n";
-        return response_buffer.c_str();
-    }
-    
-    // Parse request method and path
-    std::string req_str(request);
-    size_t first_space = req_str.find(' ');
-    size_t second_space = req_str.find(' ', first_space + 1);
-    
-    if (first_space == std::string::npos || second_space == std::string::npos) {
-        response_buffer = "HTTP/1.1 400 Bad Request\r\n"
-                         "Server: MedusaServ v0.3.0a (Professional Native C++ Server)\r\n"
-                         "Content-Length: 0\r\n"
-                         "Connection: close\r\n\r\n";
-        return response_buffer.c_str();
-    }
-    
-    std::string method = req_str.substr(0, first_space);
-    std::string path = req_str.substr(first_space + 1, second_space - first_space - 1);
-    
-    // Generate professional HTTP response
-    if (path == "/health") {
-        response_buffer = "HTTP/1.1 200 OK\r\n"
-                         "Server: MedusaServ v0.3.0a (Professional Native C++ Server)\r\n"
-                         "Content-Type: application/json\r\n"
-                         "Content-Length: 85\r\n"
-                         "Connection: close\r\n\r\n"
-                         "{\n"
-                         "  \"status\": \"healthy\",\n"
-                         "  \"server\": \"MedusaServ v0.3.0a\",\n"
-                         "  \"engine\": \"Native C++\"\n"
-                         "}";
-    } else {
-        response_buffer = "HTTP/1.1 200 OK\r\n"
-                         "Server: MedusaServ v0.3.0a (Professional Native C++ Server)\r\n"
-                         "Content-Type: text/html\r\n"
-                         "Content-Length: 100\r\n"
-                         "Connection: close\r\n\r\n"
-                         "<html><body><h1>MedusaServ v0.3.0a</h1><p>Native C++ Professional Server</p></body></html>";
+    HttpRequestParser parser(request_limits());
+    HttpRequestParser::Status status = parser.parse(std::string_view(data, length));
+    if (status == HttpRequestParser::Status::ERROR) {
+        return MEDUSASERV_ERROR_GENERIC;
     }
+    if (status == HttpRequestParser::Status::INCOMPLETE) {
+        return 0;
+    }
+    
+    copy_field(request->method, parser.method());
+    copy_field(request->path, parser.target());
+    copy_field(request->version, parser.version());
+    copy_field(request->host, parser.header("Host"));
+    copy_field(request->user_agent, parser.header("User-Agent"));
+    request->content_length = static_cast<int>(std::min<size_t>(parser.body_size(), INT_MAX));
+    
+    return static_cast<int>(parser.length());
+}
+
+const char* generate_http_response(const char* request) {
+    // One buffer per thread: the pointer stays valid until this thread's next call
+    thread_local std::string response_buffer;
+    
+    std::string scratch = g_buffer_pool.acquire();
+    HttpResponseBuilder response(scratch);
+    build_response_to(request, response);
+    response_buffer.resize(response.size());
+    response.copy_to(&response_buffer[0]);
+    g_buffer_pool.release(std::move(scratch));
     
     return response_buffer.c_str();
 }
 
+int generate_http_response_into(const char* request, char* buffer, size_t capacity) {
+    if (!buffer && capacity > 0) {
+        return MEDUSASERV_ERROR_INVALID_PARAMETER;
+    }
+    
+    std::string scratch = g_buffer_pool.acquire();
+    HttpResponseBuilder response(scratch);
+    build_response_to(request, response);
+    size_t size = response.size();
+    if (size < capacity) {
+        response.copy_to(buffer);
+        buffer[size] = '\0';
+    }
+    g_buffer_pool.release(std::move(scratch));
+    
+    return static_cast<int>(size);
+}
+
 const char* get_http_version() {
     return "MedusaServ HTTP Engine v0.3.0a";
 }
@@ -0,0 +1,238 @@
+/**
+ * MEDUSASERV HTTP PARSER TEST v0.3.0a
+ * ===================================
+ * Differential fuzz of HttpRequestParser: every generated request, and a
+ * mutated copy of some, must parse the same whether it arrives whole or
+ * split at random points into a freshly allocated buffer on each call.
+ * Unmutated requests must also yield the body that was generated and stop
+ * exactly before a pipelined follower. Run it under -fsanitize=address,undefined
+ * to catch a view that outlives its buffer.
+ *
+ * g++ -std=c++17 -Iinclude tests/medusaserv_http_parser_test.cpp
+ * Usage: a.out [iterations]
+ */
+
+#include "medusaserv_http_parser.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace medusaserv::http;
+using Parser = HttpRequestParser;
+
+static int failures = 0;
+
+static void check(bool passed, const std::string& what) {
+    std::cout << (passed ? "  ✅ " : "  ❌ ") << what << std::endl;
+    failures += passed ? 0 : 1;
+}
+
+/**
+ * @brief Everything a parse produced, copied out of the buffer
+ */
+struct Outcome {
+    Parser::Status status = Parser::Status::INCOMPLETE;
+    Parser::Error error = Parser::Error::NONE;
+    size_t length = 0;
+    std::string method, target, path, query, version;
+    bool keep_alive = false, chunked = false;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;       // The parts joined
+    size_t body_size = 0;   // As the parser counts it
+
+    bool operator==(const Outcome& other) const {
+        return status == other.status && error == other.error && length == other.length &&
+               method == other.method && target == other.target && path == other.path &&
+               query == other.query && version == other.version && keep_alive == other.keep_alive &&
+               chunked == other.chunked && headers == other.headers && body == other.body &&
+               body_size == other.body_size;
+    }
+};
+
+static Outcome outcome(const Parser& parser, Parser::Status status) {
+    Outcome result;
+    result.status = status;
+    result.error = parser.error();
+    if (status != Parser::Status::COMPLETE) {
+        return result;
+    }
+    result.length = parser.length();
+    result.method = parser.method();
+    result.target = parser.target();
+    result.path = parser.path();
+    result.query = parser.query();
+    result.version = parser.version();
+    result.keep_alive = parser.keep_alive();
+    result.chunked = parser.chunked();
+    for (size_t i = 0; i < parser.header_count(); ++i) {
+        result.headers.emplace_back(std::string(parser.header(i).name), std::string(parser.header(i).value));
+    }
+    for (size_t i = 0; i < parser.body_part_count(); ++i) {
+        result.body += parser.body_part(i);
+    }
+    result.body_size = parser.body_size();
+    return result;
+}
+
+static Outcome parse_whole(const std::string& input) {
+    Parser parser;
+    return outcome(parser, parser.parse(input));
+}
+
+static Outcome parse_split(const std::string& input, std::mt19937& rng) {
+    Parser parser;
+    Parser::Status status = Parser::Status::INCOMPLETE;
+    std::string buffer;
+    size_t have = 0;
+    while (true) {
+        size_t step = std::uniform_int_distribution<size_t>(0, rng() % 4 == 0 ? 64 : 3)(rng);
+        have = std::min(input.size(), have + step);
+        std::string moved(input.substr(0, have)); // A fresh allocation: offsets must survive the move
+        buffer.swap(moved);
+        status = parser.parse(buffer);
+        if (status != Parser::Status::INCOMPLETE || have == input.size()) {
+            return outcome(parser, status);
+        }
+    }
+}
+
+static const char* const PIPELINED = "GET / HTTP/1.1\r\n\r\n";
+
+/**
+ * @brief A request with random framing; body receives the body it carries
+ */
+static std::string generate(std::mt19937& rng, std::string& body) {
+    auto pick = [&](int n) { return static_cast<int>(rng() % n); };
+    static const char* const methods[] = {"GET", "POST", "HEAD", "PUT", "DELETE", "OPTIONS", "PATCH", "G{T", ""};
+
+    std::string request = pick(8) == 0 ? "\r\n" : "";
+    request += methods[pick(9)];
+    request += pick(2) ? " /health" : " /a/b";
+    request += pick(2) ? "?x=1&y=2" : "";
+    request += pick(10) == 0 ? " HTTP/2.0" : (pick(2) ? " HTTP/1.1" : " HTTP/1.0");
+    request += pick(6) == 0 ? "\n" : "\r\n";
+    for (int i = pick(6); i > 0; --i) {
+        request += "X-H" + std::to_string(i) + ": " + (pick(2) ? "  v " : "val") + std::to_string(pick(100)) + "\r\n";
+    }
+    if (pick(3) == 0) {
+        request += pick(2) ? "Connection: close\r\n" : "Connection: keep-alive, Upgrade\r\n";
+    }
+
+    body.clear();
+    switch (pick(4)) {
+        case 1:
+            body.assign(pick(40), 'b');
+            request += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            break;
+        case 2:
+            request += pick(2) ? "Transfer-Encoding: chunked\r\n\r\n" : "Transfer-Encoding: gzip, chunked\r\n\r\n";
+            for (int chunk = 0, chunks = pick(4); chunk < chunks; ++chunk) {
+                std::string data(1 + pick(20), static_cast<char>('a' + chunk));
+                char size[16];
+                std::snprintf(size, sizeof(size), pick(2) ? "%zx" : "%zX", data.size());
+                request += size;
+                request += pick(3) == 0 ? ";ext=1\r\n" : "\r\n";
+                request += data + "\r\n";
+                body += data;
+            }
+            request += pick(3) == 0 ? "0\r\nTrailer: x\r\n\r\n" : "0\r\n\r\n";
+            break;
+        case 3:
+            request += pick(4) == 0 ? "Content-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n" : "\r\n";
+            break;
+        default:
+            request += "\r\n";
+    }
+    if (pick(2)) {
+        request += PIPELINED; // Must not be consumed
+    }
+    return request;
+}
+
+static void mutate(std::string& request, std::mt19937& rng) {
+    for (int edits = 1 + rng() % 3; edits > 0 && !request.empty(); --edits) {
+        size_t at = rng() % request.size();
+        switch (rng() % 4) {
+            case 0: request[at] = static_cast<char>(rng() % 256); break;
+            case 1: request.erase(at, 1); break;
+            case 2: request.insert(at, 1, "\r\n :;\t0aZ\x7f"[rng() % 10]); break;
+            default: request.insert(at, request.substr(rng() % request.size(), rng() % 8));
+        }
+    }
+}
+
+static void test_split_matches_whole(long iterations) {
+    std::cout << "🔍 Split input parses like whole input (" << iterations << " requests)" << std::endl;
+    std::mt19937 rng(12345);
+    long complete = 0, chunked = 0, errors = 0, mismatches = 0, wrong_bodies = 0, wrong_lengths = 0;
+    std::string first_failure;
+    for (long i = 0; i < iterations; ++i) {
+        std::string body;
+        std::string request = generate(rng, body);
+        bool mutated = rng() % 3 == 0;
+        if (mutated) {
+            mutate(request, rng);
+        }
+
+        Outcome whole = parse_whole(request);
+        for (int split = 0; split < 3; ++split) {
+            if (!(parse_split(request, rng) == whole)) {
+                ++mismatches;
+                first_failure = first_failure.empty() ? request : first_failure;
+                break;
+            }
+        }
+
+        if (whole.status == Parser::Status::ERROR) {
+            ++errors;
+        } else if (whole.status == Parser::Status::COMPLETE) {
+            ++complete;
+            chunked += whole.chunked ? 1 : 0;
+            if (whole.body.size() != whole.body_size || (!mutated && whole.body != body)) {
+                ++wrong_bodies;
+                first_failure = first_failure.empty() ? request : first_failure;
+            }
+            std::string rest = request.substr(whole.length);
+            if (!mutated && !rest.empty() && rest != PIPELINED) {
+                ++wrong_lengths;
+                first_failure = first_failure.empty() ? request : first_failure;
+            }
+        }
+    }
+
+    check(mismatches == 0, std::to_string(mismatches) + " split parses differ from the whole parse");
+    check(wrong_bodies == 0, std::to_string(wrong_bodies) + " bodies differ from body_size() or the generated body");
+    check(wrong_lengths == 0, std::to_string(wrong_lengths) + " requests end anywhere but before the pipelined one");
+    check(complete > iterations / 4 && chunked > 0 && errors > 0,
+          "the corpus covers complete (" + std::to_string(complete) + ", " + std::to_string(chunked) +
+          " chunked) and rejected (" + std::to_string(errors) + ") requests");
+    if (!first_failure.empty()) {
+        std::cout << "  First failing request:\n---\n" << first_failure << "\n---" << std::endl;
+    }
+}
+
+static void test_chunks_stay_in_place() {
+    std::cout << "🔍 Chunk data is returned where it lies" << std::endl;
+    std::string request = "POST /up HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                          "5\r\nhello\r\n6;x=y\r\n world\r\n0\r\n\r\n";
+    Parser parser;
+    check(parser.parse(request) == Parser::Status::COMPLETE, "the request completes");
+    check(parser.body_part_count() == 2 && parser.body_size() == 11, "two parts, eleven bytes");
+    check(parser.body_part_count() == 2 && parser.body_part(0).data() == request.data() + request.find("hello") &&
+          parser.body_part(1) == " world", "each part is a view of the buffer, not a copy");
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "🔮 Testing HttpRequestParser v0.3.0a" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    test_split_matches_whole(argc > 1 ? std::atol(argv[1]) : 20000);
+    test_chunks_stay_in_place();
+
+    std::cout << (failures ? "❌ " : "✅ ") << failures << " failed" << std::endl;
+    return failures ? 1 : 0;
+}
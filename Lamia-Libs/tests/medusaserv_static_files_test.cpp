@@ -0,0 +1,107 @@
+/**
+ * MEDUSASERV STATIC FILES TEST v0.3.0a
+ * ====================================
+ * StaticFileCache must stop serving a cached file once the path leads
+ * somewhere else: a symlinked release directory swapped atomically, or
+ * an ancestor directory renamed and recreated.
+ *
+ * g++ -std=c++17 -Iinclude tests/medusaserv_static_files_test.cpp -lpthread
+ */
+
+#include "medusaserv_static_files.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace medusaserv::http;
+
+static int failures = 0;
+
+static void check(bool passed, const std::string& what) {
+    std::cout << (passed ? "  ✅ " : "  ❌ ") << what << std::endl;
+    failures += passed ? 0 : 1;
+}
+
+static void write_file(const std::string& path, const std::string& content) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    std::fwrite(content.data(), 1, content.size(), file);
+    std::fclose(file);
+}
+
+static std::string body_of(const std::shared_ptr<const StaticFile>& file) {
+    if (!file) {
+        return "(not served)";
+    }
+    std::string body(static_cast<size_t>(file->size), '\0');
+    ssize_t length = pread(file->fd, &body[0], body.size(), 0);
+    return body.substr(0, length < 0 ? 0 : static_cast<size_t>(length));
+}
+
+/**
+ * @brief The body served for path once the watcher has caught up (inotify is asynchronous)
+ */
+static std::string settled_body(StaticFileCache& cache, const std::string& path, const std::string& expected) {
+    std::string body;
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        body = body_of(cache.open(path));
+        if (body == expected) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return body;
+}
+
+static void test_symlink_swap(const std::string& root) {
+    std::cout << "🔍 Release symlink swapped" << std::endl;
+    mkdir((root + "/rel1").c_str(), 0755);
+    mkdir((root + "/rel2").c_str(), 0755);
+    write_file(root + "/rel1/app.js", "one");
+    write_file(root + "/rel2/app.js", "two");
+    symlink("rel1", (root + "/current").c_str());
+
+    StaticFileCache cache;
+    std::string path = root + "/current/app.js";
+    check(body_of(cache.open(path)) == "one", "serves the first release");
+    check(body_of(cache.open(path)) == "one" && cache.hits() == 1, "then from the cache");
+
+    symlink("rel2", (root + "/next").c_str());
+    rename((root + "/next").c_str(), (root + "/current").c_str()); // Atomic swap
+    check(settled_body(cache, path, "two") == "two", "serves the second release after the swap");
+}
+
+static void test_ancestor_renamed(const std::string& root) {
+    std::cout << "🔍 Ancestor directory renamed" << std::endl;
+    mkdir((root + "/site").c_str(), 0755);
+    mkdir((root + "/site/css").c_str(), 0755);
+    write_file(root + "/site/css/main.css", "old");
+
+    StaticFileCache cache;
+    std::string path = root + "/site/css/main.css";
+    check(body_of(cache.open(path)) == "old", "serves the file");
+
+    rename((root + "/site").c_str(), (root + "/site.old").c_str());
+    mkdir((root + "/site").c_str(), 0755);
+    mkdir((root + "/site/css").c_str(), 0755);
+    write_file(root + "/site/css/main.css", "new");
+    check(settled_body(cache, path, "new") == "new", "serves the new file after the rename");
+}
+
+int main() {
+    std::cout << "🔮 Testing StaticFileCache v0.3.0a" << std::endl;
+    std::cout << "==================================" << std::endl;
+
+    char root[] = "/tmp/medusaserv_static_files_test.XXXXXX";
+    if (!mkdtemp(root)) {
+        std::cout << "❌ no temporary directory" << std::endl;
+        return 1;
+    }
+    test_symlink_swap(root);
+    test_ancestor_renamed(root);
+    std::system(("rm -rf '" + std::string(root) + "'").c_str());
+
+    std::cout << (failures ? "❌ " : "✅ ") << failures << " failed" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA AST ARENA v0.3.0c
+ * =======================
+ *
+ * Per-compilation bump allocator for AST nodes
+ * - Nodes, strings and child arrays live in large contiguous blocks
+ * - Property keys and identifiers are interned once per compilation unit
+ * - Freeing a compilation unit releases its blocks in one step, no node walk
+ *
+ * Everything placed in the arena must be trivially destructible: the arena
+ * never runs destructors.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia AST Arena - Bump allocator owning one compilation unit
+ */
+class LamiaAstArena {
+private:
+ static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+ std::vector<std::unique_ptr<char[]>> blocks_;
+ std::vector<std::unique_ptr<char[]>> large_blocks_;
+ char* cursor_ = nullptr;
+ char* limit_ = nullptr;
+
+ size_t bytes_used_ = 0;
+ size_t node_count_ = 0;
+ std::unordered_set<std::string_view> interned_;
+
+public:
+ LamiaAstArena() = default;
+ LamiaAstArena(const LamiaAstArena&) = delete;
+ LamiaAstArena& operator=(const LamiaAstArena&) = delete;
+
+ /**
+ * @brief Allocate raw, suitably aligned storage
+ */
+ void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+ // Oversized requests get a dedicated block so the bump block is not wasted
+ if (size > BLOCK_SIZE / 4) {
+ large_blocks_.emplace_back(new char[size + alignment]);
+ bytes_used_ += size;
+ return align_up(large_blocks_.back().get(), alignment);
+ }
+
+ char* result = cursor_ ? align_up(cursor_, alignment) : nullptr;
+ if (!result || result + size > limit_) {
+ add_block();
+ result = align_up(cursor_, alignment);
+ }
+
+ bytes_used_ += static_cast<size_t>(result + size - cursor_);
+ cursor_ = result + size;
+ return result;
+ }
+
+ /**
+ * @brief Construct an AST node in the arena
+ */
+ template<typename T, typename... Args>
+ T* create(Args&&... args) {
+ static_assert(std::is_trivially_destructible_v<T>, "Arena nodes must be trivially destructible");
+ ++node_count_;
+ return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+ }
+
+ /**
+ * @brief Allocate an uninitialised array of trivially copyable elements
+ */
+ template<typename T>
+ T* allocate_array(size_t count) {
+ static_assert(std::is_trivially_copyable_v<T>, "Arena arrays must be trivially copyable");
+ return static_cast<T*>(allocate(sizeof(T) * (count ? count : 1), alignof(T)));
+ }
+
+ /**
+ * @brief Intern a string - equal text always yields the same view
+ */
+ std::string_view intern(std::string_view text) {
+ auto it = interned_.find(text);
+ if (it != interned_.end()) {
+ return *it;
+ }
+
+ char* storage = static_cast<char*>(allocate(text.size() + 1, 1));
+ std::memcpy(storage, text.data(), text.size());
+ storage[text.size()] = '\0';
+
+ std::string_view stored(storage, text.size());
+ interned_.insert(stored);
+ return stored;
+ }
+
+ /**
+ * @brief Release the whole compilation unit, keeping one block for reuse
+ */
+ void reset() {
+ if (blocks_.size() > 1) {
+ blocks_.erase(blocks_.begin() + 1, blocks_.end());
+ }
+ large_blocks_.clear();
+ cursor_ = blocks_.empty() ? nullptr : blocks_.front().get();
+ limit_ = blocks_.empty() ? nullptr : cursor_ + BLOCK_SIZE;
+ bytes_used_ = 0;
+ node_count_ = 0;
+ interned_.clear();
+ }
+
+ size_t node_count() const { return node_count_; }
+ size_t bytes_used() const { return bytes_used_; }
+ size_t block_count() const { return blocks_.size() + large_blocks_.size(); }
+
+private:
+ void add_block() {
+ blocks_.emplace_back(new char[BLOCK_SIZE]);
+ cursor_ = blocks_.back().get();
+ limit_ = cursor_ + BLOCK_SIZE;
+ }
+
+ static char* align_up(char* pointer, size_t alignment) {
+ uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+ return pointer + (alignment - address % alignment) % alignment;
+ }
+};
+
+/**
+ * @brief Flat, arena-backed array used for AST children and properties
+ *
+ * Growth doubles into fresh arena storage; the old storage is simply
+ * abandoned until the arena is released.
+ */
+template<typename T>
+class LamiaArenaVector {
+private:
+ static_assert(std::is_trivially_copyable_v<T>, "Arena arrays must be trivially copyable");
+
+ T* data_ = nullptr;
+ uint32_t size_ = 0;
+ uint32_t capacity_ = 0;
+
+public:
+ void push_back(LamiaAstArena& arena, const T& value) {
+ if (size_ == capacity_) {
+ grow(arena);
+ }
+ data_[size_++] = value;
+ }
+
+ void insert(LamiaAstArena& arena, size_t index, const T& value) {
+ if (size_ == capacity_) {
+ grow(arena);
+ }
+ std::memmove(data_ + index + 1, data_ + index, (size_ - index) * sizeof(T));
+ data_[index] = value;
+ ++size_;
+ }
+
+ size_t size() const { return size_; }
+ bool empty() const { return size_ == 0; }
+ T& operator[](size_t index) { return data_[index]; }
+ const T& operator[](size_t index) const { return data_[index]; }
+ T* begin() { return data_; }
+ T* end() { return data_ + size_; }
+ const T* begin() const { return data_; }
+ const T* end() const { return data_ + size_; }
+
+private:
+ void grow(LamiaAstArena& arena) {
+ uint32_t new_capacity = capacity_ ? capacity_ * 2 : 4;
+ T* new_data = arena.allocate_array<T>(new_capacity);
+ if (size_) {
+ std::memcpy(new_data, data_, size_ * sizeof(T));
+ }
+ data_ = new_data;
+ capacity_ = new_capacity;
+ }
+};
+
+/**
+ * @brief Key/value entry of a LamiaPropertyList
+ */
+template<typename V>
+struct LamiaArenaProperty {
+ std::string_view key; // Interned in the owning arena
+ V value;
+};
+
+/**
+ * @brief Sorted property list with interned keys - flat replacement for std::map
+ */
+template<typename V>
+class LamiaPropertyList {
+private:
+ LamiaArenaVector<LamiaArenaProperty<V>> entries_;
+
+public:
+ /**
+ * @brief Insert or replace a property, keeping keys in sorted order
+ */
+ void set(LamiaAstArena& arena, std::string_view key, V value) {
+ size_t index = lower_bound(key);
+ if (index < entries_.size() && entries_[index].key == key) {
+ entries_[index].value = value;
+ return;
+ }
+ entries_.insert(arena, index, LamiaArenaProperty<V>{arena.intern(key), value});
+ }
+
+ const V* find(std::string_view key) const {
+ size_t index = lower_bound(key);
+ if (index < entries_.size() && entries_[index].key == key) {
+ return &entries_[index].value;
+ }
+ return nullptr;
+ }
+
+ size_t size() const { return entries_.size(); }
+ bool empty() const { return entries_.empty(); }
+ const LamiaArenaProperty<V>* begin() const { return entries_.begin(); }
+ const LamiaArenaProperty<V>* end() const { return entries_.end(); }
+
+private:
+ size_t lower_bound(std::string_view key) const {
+ size_t low = 0;
+ size_t high = entries_.size();
+ while (low < high) {
+ size_t mid = (low + high) / 2;
+ if (entries_[mid].key < key) {
+ low = mid + 1;
+ } else {
+ high = mid;
+ }
+ }
+ return low;
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
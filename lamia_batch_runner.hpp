@@ -0,0 +1,242 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA BATCH RUNNER v0.3.0c
+ * ==========================
+ *
+ * Whole-tree compilation support shared by the Lamia compilers
+ * - Source discovery from a directory tree or a manifest file
+ * - Work-stealing thread pool: each worker drains its own deque from the
+ *   back and steals from the front of its siblings when it runs dry
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief One source file of a batch compile
+ */
+struct LamiaBatchJob {
+ std::filesystem::path input; // Source file
+ std::filesystem::path relative_dir; // Parent directory relative to the batch root
+ std::string stem; // File name without .lamia
+
+ /**
+ * @brief Per-file output directory mirroring the source tree
+ */
+ std::filesystem::path output_dir(const std::filesystem::path& output_root) const {
+ return output_root / relative_dir / stem;
+ }
+};
+
+/**
+ * @brief Discover .lamia sources from a directory or a manifest file
+ *
+ * A manifest lists one file or directory per line, relative to the
+ * manifest's own directory; blank lines and lines starting with # are
+ * ignored. Results are sorted so batch output is deterministic.
+ */
+inline std::vector<LamiaBatchJob> collect_lamia_sources(const std::filesystem::path& input) {
+ namespace fs = std::filesystem;
+ std::vector<LamiaBatchJob> jobs;
+ std::error_code ec;
+
+ auto add_file = [&jobs](const fs::path& file, const fs::path& root) {
+ LamiaBatchJob job;
+ job.input = file;
+ job.relative_dir = file.parent_path().lexically_relative(root);
+ if (job.relative_dir == ".") {
+ job.relative_dir.clear();
+ }
+ job.stem = file.stem().string();
+ jobs.push_back(std::move(job));
+ };
+
+ auto add_tree = [&](const fs::path& dir, const fs::path& root) {
+ for (fs::recursive_directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end;
+ !ec && it != end; it.increment(ec)) {
+ if (it->is_regular_file(ec) && it->path().extension() == ".lamia") {
+ add_file(it->path(), root);
+ }
+ }
+ };
+
+ if (fs::is_directory(input, ec)) {
+ add_tree(input, input);
+ } else if (input.extension() == ".lamia") {
+ add_file(input, input.parent_path());
+ } else {
+ std::ifstream manifest(input);
+ fs::path base = input.parent_path();
+ std::string line;
+ while (std::getline(manifest, line)) {
+ line.erase(0, line.find_first_not_of(" \t"));
+ line.erase(line.find_last_not_of(" \t\r") + 1);
+ if (line.empty() || line[0] == '#') {
+ continue;
+ }
+
+ fs::path entry = fs::path(line).is_absolute() ? fs::path(line) : base / line;
+ if (fs::is_directory(entry, ec)) {
+ add_tree(entry, base);
+ } else if (fs::is_regular_file(entry, ec)) {
+ add_file(entry, base);
+ }
+ }
+ }
+
+ std::sort(jobs.begin(), jobs.end(), [](const LamiaBatchJob& a, const LamiaBatchJob& b) {
+ return a.input < b.input;
+ });
+ return jobs;
+}
+
+/**
+ * @brief Lamia Work-Stealing Pool - Fixed worker set with per-worker deques
+ */
+class LamiaWorkStealingPool {
+private:
+ struct WorkerQueue {
+ std::mutex mutex;
+ std::deque<std::function<void()>> tasks;
+ };
+
+ std::vector<std::unique_ptr<WorkerQueue>> queues_;
+ std::vector<std::thread> workers_;
+
+ std::atomic<size_t> queued_{0}; // Submitted but not yet started
+ std::atomic<size_t> pending_{0}; // Submitted but not yet finished
+ std::atomic<size_t> next_queue_{0};
+ bool stopping_ = false;
+
+ std::mutex idle_mutex_;
+ std::condition_variable work_available_;
+ std::condition_variable all_done_;
+
+ static inline thread_local size_t worker_index_ = SIZE_MAX;
+
+public:
+ explicit LamiaWorkStealingPool(size_t threads = std::thread::hardware_concurrency()) {
+ threads = std::max<size_t>(threads, 1);
+ for (size_t i = 0; i < threads; ++i) {
+ queues_.push_back(std::make_unique<WorkerQueue>());
+ }
+ for (size_t i = 0; i < threads; ++i) {
+ workers_.emplace_back([this, i]() { worker_loop(i); });
+ }
+ }
+
+ ~LamiaWorkStealingPool() {
+ {
+ std::lock_guard<std::mutex> lock(idle_mutex_);
+ stopping_ = true;
+ }
+ work_available_.notify_all();
+ for (auto& worker : workers_) {
+ worker.join();
+ }
+ }
+
+ LamiaWorkStealingPool(const LamiaWorkStealingPool&) = delete;
+ LamiaWorkStealingPool& operator=(const LamiaWorkStealingPool&) = delete;
+
+ size_t size() const { return workers_.size(); }
+
+ /**
+ * @brief Queue a task - workers push to their own deque, others round-robin
+ */
+ void submit(std::function<void()> task) {
+ size_t index = worker_index_ < queues_.size() ? worker_index_ : next_queue_++ % queues_.size();
+ pending_++; // Count before publishing so a fast worker never underflows
+ queued_++;
+ {
+ std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+ queues_[index]->tasks.push_back(std::move(task));
+ }
+
+ { std::lock_guard<std::mutex> lock(idle_mutex_); } // Pairs with the waiter's predicate check
+ work_available_.notify_one();
+ }
+
+ /**
+ * @brief Block until every submitted task has finished
+ */
+ void wait_idle() {
+ std::unique_lock<std::mutex> lock(idle_mutex_);
+ all_done_.wait(lock, [this]() { return pending_ == 0; });
+ }
+
+private:
+ void worker_loop(size_t index) {
+ worker_index_ = index;
+
+ while (true) {
+ std::function<void()> task;
+ if (pop_local(index, task) || steal(index, task)) {
+ queued_--;
+ try {
+ task();
+ } catch (...) {
+ // Tasks report their own failures; keep the worker alive
+ }
+ if (--pending_ == 0) {
+ std::lock_guard<std::mutex> lock(idle_mutex_);
+ all_done_.notify_all();
+ }
+ continue;
+ }
+
+ std::unique_lock<std::mutex> lock(idle_mutex_);
+ work_available_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+ if (stopping_ && queued_ == 0) {
+ return;
+ }
+ }
+ }
+
+ bool pop_local(size_t index, std::function<void()>& task) {
+ std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+ if (queues_[index]->tasks.empty()) {
+ return false;
+ }
+ task = std::move(queues_[index]->tasks.back());
+ queues_[index]->tasks.pop_back();
+ return true;
+ }
+
+ bool steal(size_t thief, std::function<void()>& task) {
+ for (size_t offset = 1; offset < queues_.size(); ++offset) {
+ WorkerQueue& victim = *queues_[(thief + offset) % queues_.size()];
+ std::lock_guard<std::mutex> lock(victim.mutex);
+ if (!victim.tasks.empty()) {
+ task = std::move(victim.tasks.front());
+ victim.tasks.pop_front();
+ return true;
+ }
+ }
+ return false;
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
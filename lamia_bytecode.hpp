@@ -0,0 +1,748 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA BYTECODE v0.3.0c
+ * ======================
+ *
+ * Compact, versioned bytecode for manifest bodies, run server-side
+ * without re-parsing
+ * - One .lbc module per source file: functions, constants, host imports,
+ *   parameter names, code words and a string pool
+ * - Every section is 8-byte aligned and position-independent, so a module
+ *   is used in place straight from an mmap of the file
+ * - The loader verifies every offset, register and operand once; the
+ *   interpreter then runs without bounds checks
+ * - Register machine: a call's arguments arrive in r0..rN-1, temporaries
+ *   follow, and calls take their arguments from a contiguous register run
+ *
+ * Layout (little-endian):
+ *   header | functions | constants | imports | parameters | code | strings
+ *
+ * Instructions are 32-bit words: opcode:8 a:8 b:8 c:8, or opcode:8 a:8
+ * bx:16 for constant loads. Calls are followed by one word holding the
+ * callee (an import or a function of the module).
+ *
+ * This header depends on nothing but the standard library and POSIX, so
+ * server code that cannot see the compiler's AST can load and run modules.
+ */
+
+#pragma once
+
+#include "lamia_source_buffer.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+namespace LamiaBytecode {
+
+constexpr char MAGIC[4] = {'L', 'M', 'B', 'C'};
+constexpr uint16_t VERSION = 1; // Bump on any layout or instruction change
+constexpr size_t MAX_REGISTERS = 256;
+constexpr size_t MAX_CALL_DEPTH = 256;
+
+enum Opcode : uint8_t {
+ LOAD_CONSTANT, // r[a] = constants[bx]
+ LOAD_NULL, // r[a] = null
+ MOVE, // r[a] = r[b]
+ MAKE_ARRAY, // r[a] = [r[b] .. r[b+c])
+ CALL_HOST, // r[a] = imports[next](r[b] .. r[b+c])
+ CALL, // r[a] = functions[next](r[b] .. r[b+c])
+ RETURN, // return r[a]
+ RETURN_NULL, // return null
+ OPCODE_COUNT
+};
+
+enum ConstantKind : uint32_t {
+ CONSTANT_NULL,
+ CONSTANT_BOOLEAN,
+ CONSTANT_NUMBER,
+ CONSTANT_STRING
+};
+
+struct Header {
+ char magic[4];
+ uint16_t version;
+ uint16_t header_size;
+ uint32_t function_count;
+ uint32_t constant_count;
+ uint32_t import_count;
+ uint32_t parameter_count;
+ uint32_t code_words;
+ uint32_t string_bytes;
+ uint32_t total_size;
+ uint32_t reserved;
+};
+
+struct Name {
+ uint32_t offset; // Into the string pool
+ uint32_t length;
+};
+
+struct Function {
+ Name name;
+ uint32_t code_offset; // In words
+ uint32_t code_length;
+ uint32_t first_parameter; // Into the parameter name table
+ uint16_t parameters;
+ uint16_t registers;
+};
+
+struct Constant {
+ uint32_t kind;
+ uint32_t length; // Strings
+ uint64_t bits; // String offset, boolean, or the number's IEEE bits
+};
+
+static_assert(sizeof(Header) == 40 && sizeof(Function) == 24 && sizeof(Constant) == 16 && sizeof(Name) == 8,
+ "bytecode structures are part of the file format");
+
+inline constexpr uint32_t encode(Opcode op, uint32_t a, uint32_t b = 0, uint32_t c = 0) {
+ return op | (a << 8) | (b << 16) | (c << 24);
+}
+
+inline constexpr uint32_t encode_wide(Opcode op, uint32_t a, uint32_t bx) {
+ return op | (a << 8) | (bx << 16);
+}
+
+inline constexpr size_t align8(size_t size) {
+ return (size + 7) & ~size_t(7);
+}
+
+} // namespace LamiaBytecode
+
+/**
+ * @brief Lamia Bytecode Value - A register's contents
+ *
+ * Trivially copyable: strings and arrays are views, into the module's
+ * string pool or into the LamiaBytecodeScratch of the running call.
+ */
+struct LamiaBytecodeValue {
+ enum class Kind : uint8_t { NULL_VALUE, BOOLEAN, NUMBER, STRING, ARRAY };
+
+ Kind kind = Kind::NULL_VALUE;
+ bool boolean = false;
+ double number = 0;
+ std::string_view text;
+ const LamiaBytecodeValue* elements = nullptr;
+ size_t size = 0;
+
+ static LamiaBytecodeValue of(bool value) {
+ LamiaBytecodeValue v;
+ v.kind = Kind::BOOLEAN;
+ v.boolean = value;
+ return v;
+ }
+
+ static LamiaBytecodeValue of(double value) {
+ LamiaBytecodeValue v;
+ v.kind = Kind::NUMBER;
+ v.number = value;
+ return v;
+ }
+
+ static LamiaBytecodeValue of(std::string_view value) {
+ LamiaBytecodeValue v;
+ v.kind = Kind::STRING;
+ v.text = value;
+ return v;
+ }
+
+ /**
+ * @brief Text form for callers that work on strings: strings unquoted, the rest as JSON
+ */
+ std::string to_string() const {
+ if (kind == Kind::STRING) {
+ return std::string(text);
+ }
+ std::string out;
+ append_json(out);
+ return out;
+ }
+
+ void append_json(std::string& out) const {
+ switch (kind) {
+ case Kind::NULL_VALUE:
+ out += "null";
+ break;
+ case Kind::BOOLEAN:
+ out += boolean ? "true" : "false";
+ break;
+ case Kind::NUMBER: {
+ char buffer[32];
+ int length = std::snprintf(buffer, sizeof(buffer), "%.15g", number);
+ out.append(buffer, static_cast<size_t>(length));
+ break;
+ }
+ case Kind::STRING:
+ out += '"';
+ for (char c : text) {
+ if (c == '"' || c == '\\') {
+ out += '\\';
+ out += c;
+ } else if (c == '\n') {
+ out += "\\n";
+ } else {
+ out += c;
+ }
+ }
+ out += '"';
+ break;
+ case Kind::ARRAY:
+ out += '[';
+ for (size_t i = 0; i < size; ++i) {
+ if (i > 0) out += ',';
+ elements[i].append_json(out);
+ }
+ out += ']';
+ break;
+ }
+ }
+};
+
+/**
+ * @brief Storage for one call: the register file plus strings and arrays made while it runs
+ *
+ * Values returned by a call view this storage, so read the result before
+ * clear() or the next call. Keep one per thread and reuse it.
+ */
+class LamiaBytecodeScratch {
+public:
+ std::vector<LamiaBytecodeValue> registers;
+
+ /**
+ * @brief Keep a string alive until clear() - for host functions that build text
+ */
+ std::string_view keep(std::string text) {
+ strings_.push_back(std::move(text));
+ return strings_.back();
+ }
+
+ LamiaBytecodeValue make_array(const LamiaBytecodeValue* elements, size_t count) {
+ arrays_.emplace_back(elements, elements + count);
+ LamiaBytecodeValue value;
+ value.kind = LamiaBytecodeValue::Kind::ARRAY;
+ value.elements = arrays_.back().data();
+ value.size = count;
+ return value;
+ }
+
+ void clear() {
+ strings_.clear();
+ arrays_.clear();
+ }
+
+private:
+ std::deque<std::string> strings_; // Deques never move their elements
+ std::deque<std::vector<LamiaBytecodeValue>> arrays_;
+};
+
+using LamiaHostFunction = std::function<LamiaBytecodeValue(const LamiaBytecodeValue* args, size_t count,
+ LamiaBytecodeScratch& scratch)>;
+using LamiaHostFunctions = std::map<std::string, LamiaHostFunction, std::less<>>;
+
+/**
+ * @brief Lamia Bytecode Writer - Assembles a module image
+ */
+class LamiaBytecodeWriter {
+public:
+ /**
+ * @brief Start a function; instructions added next belong to it
+ * @return The function's index, for CALL
+ */
+ uint32_t begin_function(std::string_view name, const std::vector<std::string_view>& parameters) {
+ LamiaBytecode::Function function{};
+ function.name = intern(name);
+ function.code_offset = static_cast<uint32_t>(code_.size());
+ function.first_parameter = static_cast<uint32_t>(parameters_.size());
+ function.parameters = static_cast<uint16_t>(parameters.size());
+ function.registers = static_cast<uint16_t>(parameters.size());
+ for (auto parameter : parameters) {
+ parameters_.push_back(intern(parameter));
+ }
+ functions_.push_back(function);
+ return static_cast<uint32_t>(functions_.size() - 1);
+ }
+
+ void end_function(size_t registers) {
+ auto& function = functions_.back();
+ function.code_length = static_cast<uint32_t>(code_.size()) - function.code_offset;
+ function.registers = static_cast<uint16_t>(std::max<size_t>(registers, function.parameters));
+ }
+
+ void emit(uint32_t word) {
+ code_.push_back(word);
+ }
+
+ uint32_t constant(std::nullptr_t) {
+ return add_constant({LamiaBytecode::CONSTANT_NULL, 0, 0});
+ }
+
+ uint32_t constant(bool value) {
+ return add_constant({LamiaBytecode::CONSTANT_BOOLEAN, 0, value ? 1u : 0u});
+ }
+
+ uint32_t constant(double value) {
+ LamiaBytecode::Constant constant{LamiaBytecode::CONSTANT_NUMBER, 0, 0};
+ std::memcpy(&constant.bits, &value, sizeof(value));
+ return add_constant(constant);
+ }
+
+ uint32_t constant(std::string_view value) {
+ LamiaBytecode::Name name = intern(value);
+ return add_constant({LamiaBytecode::CONSTANT_STRING, name.length, name.offset});
+ }
+
+ /**
+ * @brief Index of a host function import, added on first use
+ */
+ uint32_t import(std::string_view name) {
+ auto it = import_index_.find(name);
+ if (it != import_index_.end()) {
+ return it->second;
+ }
+ imports_.push_back(intern(name));
+ uint32_t index = static_cast<uint32_t>(imports_.size() - 1);
+ import_index_.emplace(std::string(name), index);
+ return index;
+ }
+
+ size_t constant_count() const { return constants_.size(); }
+
+ /**
+ * @brief The module image, ready to write to disk or load with LamiaBytecodeModule::from_bytes
+ */
+ std::string bytes() const {
+ using namespace LamiaBytecode;
+
+ Header header{};
+ std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+ header.version = VERSION;
+ header.header_size = sizeof(Header);
+ header.function_count = static_cast<uint32_t>(functions_.size());
+ header.constant_count = static_cast<uint32_t>(constants_.size());
+ header.import_count = static_cast<uint32_t>(imports_.size());
+ header.parameter_count = static_cast<uint32_t>(parameters_.size());
+ header.code_words = static_cast<uint32_t>(code_.size());
+ header.string_bytes = static_cast<uint32_t>(strings_.size());
+
+ std::string image;
+ append(image, &header, sizeof(header));
+ append(image, functions_.data(), functions_.size() * sizeof(Function));
+ append(image, constants_.data(), constants_.size() * sizeof(Constant));
+ append(image, imports_.data(), imports_.size() * sizeof(Name));
+ append(image, parameters_.data(), parameters_.size() * sizeof(Name));
+ append(image, code_.data(), code_.size() * sizeof(uint32_t));
+ append(image, strings_.data(), strings_.size());
+
+ uint32_t total_size = static_cast<uint32_t>(image.size());
+ std::memcpy(&image[offsetof(Header, total_size)], &total_size, sizeof(total_size));
+ return image;
+ }
+
+private:
+ std::vector<LamiaBytecode::Function> functions_;
+ std::vector<LamiaBytecode::Constant> constants_;
+ std::vector<LamiaBytecode::Name> imports_;
+ std::vector<LamiaBytecode::Name> parameters_;
+ std::vector<uint32_t> code_;
+ std::string strings_;
+ std::map<std::string, LamiaBytecode::Name, std::less<>> string_index_;
+ std::map<std::string, uint32_t, std::less<>> import_index_;
+ std::map<std::tuple<uint32_t, uint32_t, uint64_t>, uint32_t> constant_index_;
+
+ LamiaBytecode::Name intern(std::string_view text) {
+ auto it = string_index_.find(text);
+ if (it != string_index_.end()) {
+ return it->second;
+ }
+ LamiaBytecode::Name name{static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(text.size())};
+ strings_.append(text);
+ string_index_.emplace(std::string(text), name);
+ return name;
+ }
+
+ uint32_t add_constant(const LamiaBytecode::Constant& constant) {
+ auto key = std::make_tuple(constant.kind, constant.length, constant.bits);
+ auto it = constant_index_.find(key);
+ if (it != constant_index_.end()) {
+ return it->second;
+ }
+ constants_.push_back(constant);
+ uint32_t index = static_cast<uint32_t>(constants_.size() - 1);
+ constant_index_.emplace(key, index);
+ return index;
+ }
+
+ static void append(std::string& image, const void* data, size_t size) {
+ image.append(static_cast<const char*>(data), size);
+ image.resize(LamiaBytecode::align8(image.size()), '\0');
+ }
+};
+
+/**
+ * @brief Lamia Bytecode Module - A verified module image, mapped from disk or held in memory
+ */
+class LamiaBytecodeModule {
+private:
+ LamiaSourceBuffer file_;
+ std::vector<uint64_t> owned_; // from_bytes: 8-byte aligned copy
+ const char* data_ = nullptr;
+ size_t size_ = 0;
+ std::string error_;
+
+ const LamiaBytecode::Header* header_ = nullptr;
+ const LamiaBytecode::Function* functions_ = nullptr;
+ const LamiaBytecode::Constant* constants_ = nullptr;
+ const LamiaBytecode::Name* imports_ = nullptr;
+ const LamiaBytecode::Name* parameters_ = nullptr;
+ const uint32_t* code_ = nullptr;
+ const char* strings_ = nullptr;
+
+public:
+ LamiaBytecodeModule() = default;
+
+ /**
+ * @brief Map and verify a .lbc file
+ */
+ explicit LamiaBytecodeModule(const std::string& path) : file_(path) {
+ if (!file_.is_open()) {
+ error_ = "cannot read " + path;
+ return;
+ }
+ attach(file_.view().data(), file_.size());
+ }
+
+ static std::unique_ptr<LamiaBytecodeModule> from_bytes(std::string_view image) {
+ auto module = std::make_unique<LamiaBytecodeModule>();
+ module->owned_.resize((image.size() + 7) / 8 + 1); // Never empty, so data() is never null
+ std::memcpy(module->owned_.data(), image.data(), image.size());
+ module->attach(reinterpret_cast<const char*>(module->owned_.data()), image.size());
+ return module;
+ }
+
+ LamiaBytecodeModule(const LamiaBytecodeModule&) = delete;
+ LamiaBytecodeModule& operator=(const LamiaBytecodeModule&) = delete;
+
+ bool is_valid() const { return header_ != nullptr; }
+ const std::string& error() const { return error_; }
+
+ size_t function_count() const { return header_ ? header_->function_count : 0; }
+ size_t import_count() const { return header_ ? header_->import_count : 0; }
+ const LamiaBytecode::Function& function(size_t index) const { return functions_[index]; }
+ const LamiaBytecode::Constant& constant(size_t index) const { return constants_[index]; }
+ const uint32_t* code(const LamiaBytecode::Function& function) const { return code_ + function.code_offset; }
+
+ std::string_view name(const LamiaBytecode::Name& name) const {
+ return std::string_view(strings_ + name.offset, name.length);
+ }
+ std::string_view function_name(size_t index) const { return name(functions_[index].name); }
+ std::string_view import_name(size_t index) const { return name(imports_[index]); }
+ std::string_view parameter_name(const LamiaBytecode::Function& function, size_t index) const {
+ return name(parameters_[function.first_parameter + index]);
+ }
+
+ /**
+ * @brief Index of a function by name, or -1
+ */
+ long find_function(std::string_view name) const {
+ for (size_t i = 0; i < function_count(); ++i) {
+ if (function_name(i) == name) {
+ return static_cast<long>(i);
+ }
+ }
+ return -1;
+ }
+
+ LamiaBytecodeValue constant_value(size_t index) const {
+ const auto& constant = constants_[index];
+ switch (constant.kind) {
+ case LamiaBytecode::CONSTANT_BOOLEAN:
+ return LamiaBytecodeValue::of(constant.bits != 0);
+ case LamiaBytecode::CONSTANT_NUMBER: {
+ double number;
+ std::memcpy(&number, &constant.bits, sizeof(number));
+ return LamiaBytecodeValue::of(number);
+ }
+ case LamiaBytecode::CONSTANT_STRING:
+ return LamiaBytecodeValue::of(std::string_view(strings_ + constant.bits, constant.length));
+ default:
+ return LamiaBytecodeValue();
+ }
+ }
+
+private:
+ void attach(const char* data, size_t size) {
+ data_ = data;
+ size_ = size;
+ if (!verify()) {
+ header_ = nullptr;
+ }
+ }
+
+ bool fail(const std::string& message) {
+ error_ = message;
+ return false;
+ }
+
+ /**
+ * @brief Check everything the interpreter relies on, once, at load time
+ */
+ bool verify() {
+ using namespace LamiaBytecode;
+
+ if (size_ < sizeof(Header) || std::memcmp(data_, MAGIC, sizeof(MAGIC)) != 0) {
+ return fail("not a Lamia bytecode module");
+ }
+ const auto* header = reinterpret_cast<const Header*>(data_);
+ if (header->version != VERSION) {
+ return fail("unsupported bytecode version " + std::to_string(header->version) +
+ " (expected " + std::to_string(VERSION) + ")");
+ }
+ if (header->header_size != sizeof(Header) || header->total_size != size_) {
+ return fail("truncated or corrupt module");
+ }
+ header_ = header; // attach() clears it again if verification fails
+
+ // Section offsets follow from the counts; each must fit inside the image
+ size_t offset = sizeof(Header);
+ auto section = [&](size_t count, size_t element) -> const char* {
+ size_t bytes = count * element;
+ if (offset > size_ || bytes > size_ - offset) {
+ return nullptr;
+ }
+ const char* start = data_ + offset;
+ offset = align8(offset + bytes);
+ return start;
+ };
+ functions_ = reinterpret_cast<const Function*>(section(header->function_count, sizeof(Function)));
+ constants_ = reinterpret_cast<const Constant*>(section(header->constant_count, sizeof(Constant)));
+ imports_ = reinterpret_cast<const Name*>(section(header->import_count, sizeof(Name)));
+ parameters_ = reinterpret_cast<const Name*>(section(header->parameter_count, sizeof(Name)));
+ code_ = reinterpret_cast<const uint32_t*>(section(header->code_words, sizeof(uint32_t)));
+ strings_ = section(header->string_bytes, 1);
+ if (!functions_ || !constants_ || !imports_ || !parameters_ || !code_ || !strings_) {
+ return fail("truncated or corrupt module");
+ }
+
+ for (size_t i = 0; i < header->import_count; ++i) {
+ if (!verify_name(imports_[i])) return fail("import name out of range");
+ }
+ for (size_t i = 0; i < header->parameter_count; ++i) {
+ if (!verify_name(parameters_[i])) return fail("parameter name out of range");
+ }
+ for (size_t i = 0; i < header->constant_count; ++i) {
+ const auto& constant = constants_[i];
+ if (constant.kind > CONSTANT_STRING || (constant.kind == CONSTANT_STRING &&
+ (constant.bits > header->string_bytes || constant.length > header->string_bytes - constant.bits))) {
+ return fail("constant " + std::to_string(i) + " out of range");
+ }
+ }
+
+ for (size_t i = 0; i < header->function_count; ++i) {
+ if (!verify_function(functions_[i])) {
+ return false;
+ }
+ }
+ return true;
+ }
+
+ bool verify_function(const LamiaBytecode::Function& function) {
+ using namespace LamiaBytecode;
+
+ if (!verify_name(function.name) || function.code_offset > header_->code_words ||
+ function.code_length > header_->code_words - function.code_offset ||
+ function.first_parameter > header_->parameter_count ||
+ function.parameters > header_->parameter_count - function.first_parameter ||
+ function.registers < function.parameters || function.registers > MAX_REGISTERS) {
+ return fail("function table entry out of range");
+ }
+ std::string where = "function '" + std::string(name(function.name)) + "': ";
+
+ const uint32_t* code = code_ + function.code_offset;
+ size_t registers = function.registers;
+ auto reg = [registers](uint32_t r) { return r < registers; };
+ auto run = [registers](uint32_t first, uint32_t count) { return first + count <= registers; };
+
+ uint32_t last_op = OPCODE_COUNT; // None yet
+ for (size_t pc = 0; pc < function.code_length; ++pc) {
+ uint32_t word = code[pc];
+ uint32_t op = word & 0xFF, a = (word >> 8) & 0xFF, b = (word >> 16) & 0xFF, c = word >> 24;
+ bool ok = true;
+ switch (op) {
+ case LOAD_CONSTANT: ok = reg(a) && (word >> 16) < header_->constant_count; break;
+ case LOAD_NULL: ok = reg(a); break;
+ case MOVE: ok = reg(a) && reg(b); break;
+ case MAKE_ARRAY: ok = reg(a) && run(b, c); break;
+ case CALL_HOST:
+ case CALL: {
+ ok = reg(a) && run(b, c) && ++pc < function.code_length;
+ if (ok && op == CALL_HOST) {
+ ok = code[pc] < header_->import_count;
+ } else if (ok) {
+ ok = code[pc] < header_->function_count && functions_[code[pc]].parameters == c;
+ }
+ break;
+ }
+ case RETURN: ok = reg(a); break;
+ case RETURN_NULL: break;
+ default: ok = false;
+ }
+ if (!ok) {
+ return fail(where + "invalid instruction at " + std::to_string(pc));
+ }
+ last_op = op;
+ }
+
+ // No fall-through off the end: the last instruction returns. Its opcode
+ // is taken from the decode above - the last word may be a CALL operand
+ if (last_op != RETURN && last_op != RETURN_NULL) {
+ return fail(where + "does not end in a return");
+ }
+ return true;
+ }
+
+ bool verify_name(const LamiaBytecode::Name& name) const {
+ return name.offset <= header_->string_bytes && name.length <= header_->string_bytes - name.offset;
+ }
+};
+
+/**
+ * @brief Lamia Bytecode Interpreter - Runs a verified module
+ *
+ * Host imports are resolved against the given host functions once, at
+ * construction. After that the interpreter is immutable and can be shared
+ * by threads, each bringing its own LamiaBytecodeScratch.
+ */
+class LamiaBytecodeInterpreter {
+private:
+ std::shared_ptr<const LamiaBytecodeModule> module_;
+ std::vector<LamiaHostFunction> imports_; // Empty function: unresolved, fails when called
+
+public:
+ LamiaBytecodeInterpreter(std::shared_ptr<const LamiaBytecodeModule> module, const LamiaHostFunctions& host_functions)
+ : module_(std::move(module)) {
+ imports_.resize(module_->import_count());
+ for (size_t i = 0; i < imports_.size(); ++i) {
+ auto it = host_functions.find(module_->import_name(i));
+ if (it != host_functions.end()) {
+ imports_[i] = it->second;
+ }
+ }
+ }
+
+ const LamiaBytecodeModule& module() const { return *module_; }
+
+ /**
+ * @brief Host imports with no matching host function
+ */
+ std::vector<std::string> unresolved_imports() const {
+ std::vector<std::string> names;
+ for (size_t i = 0; i < imports_.size(); ++i) {
+ if (!imports_[i]) {
+ names.emplace_back(module_->import_name(i));
+ }
+ }
+ return names;
+ }
+
+ /**
+ * @brief Call a function; missing trailing arguments are null, extra ones are ignored
+ * @throws std::runtime_error on an unresolved import or runaway recursion
+ */
+ LamiaBytecodeValue call(size_t function, const LamiaBytecodeValue* args, size_t count,
+ LamiaBytecodeScratch& scratch) const {
+ const auto& entry = module_->function(function);
+ scratch.registers.resize(std::max<size_t>(scratch.registers.size(), entry.registers));
+ std::fill(scratch.registers.begin(), scratch.registers.begin() + entry.registers, LamiaBytecodeValue());
+ std::copy(args, args + std::min<size_t>(count, entry.parameters), scratch.registers.begin());
+ return run(function, 0, 0, scratch);
+ }
+
+private:
+ LamiaBytecodeValue run(size_t function, size_t base, size_t depth, LamiaBytecodeScratch& scratch) const {
+ using namespace LamiaBytecode;
+
+ if (depth >= MAX_CALL_DEPTH) {
+ throw std::runtime_error("Lamia bytecode: call depth limit reached in '" +
+ std::string(module_->function_name(function)) + "'");
+ }
+
+ const auto& entry = module_->function(function);
+ const uint32_t* pc = module_->code(entry);
+ // Re-read after every call: a nested frame may grow (and move) the register file
+ LamiaBytecodeValue* r = scratch.registers.data() + base;
+
+ while (true) {
+ uint32_t word = *pc++;
+ uint32_t a = (word >> 8) & 0xFF, b = (word >> 16) & 0xFF, c = word >> 24;
+ switch (static_cast<Opcode>(word & 0xFF)) {
+ case LOAD_CONSTANT:
+ r[a] = module_->constant_value(word >> 16);
+ break;
+ case LOAD_NULL:
+ r[a] = LamiaBytecodeValue();
+ break;
+ case MOVE:
+ r[a] = r[b];
+ break;
+ case MAKE_ARRAY:
+ r[a] = scratch.make_array(r + b, c);
+ break;
+ case CALL_HOST: {
+ const auto& host = imports_[*pc++];
+ if (!host) {
+ throw std::runtime_error("Lamia bytecode: unresolved host function '" +
+ std::string(module_->import_name(pc[-1])) + "'");
+ }
+ LamiaBytecodeValue result = host(r + b, c, scratch);
+ r = scratch.registers.data() + base;
+ r[a] = result;
+ break;
+ }
+ case CALL: {
+ uint32_t callee = *pc++;
+ size_t callee_base = base + entry.registers;
+ size_t needed = callee_base + module_->function(callee).registers;
+ if (scratch.registers.size() < needed) {
+ scratch.registers.resize(needed);
+ r = scratch.registers.data() + base;
+ }
+ // Temporaries start out null, never holding a value from an earlier call
+ LamiaBytecodeValue* frame = scratch.registers.data() + callee_base;
+ std::copy(r + b, r + b + c, frame);
+ std::fill(frame + c, frame + module_->function(callee).registers, LamiaBytecodeValue());
+ LamiaBytecodeValue result = run(callee, callee_base, depth + 1, scratch);
+ r = scratch.registers.data() + base;
+ r[a] = result;
+ break;
+ }
+ case RETURN:
+ return r[a];
+ case RETURN_NULL:
+ default:
+ return LamiaBytecodeValue();
+ }
+ }
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
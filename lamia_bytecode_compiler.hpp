@@ -0,0 +1,265 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA BYTECODE COMPILER v0.3.0c
+ * ===============================
+ *
+ * Lowers the manifest functions of a parsed program to a bytecode module
+ * - Each server-executable manifest becomes one bytecode function
+ * - Parameters live in the first registers; a bare identifier naming a
+ *   parameter reads it, any other bare identifier is text, as in the
+ *   generated script
+ * - A call to another manifest of the file is a direct CALL; any other
+ *   callee is a host function import, resolved when the module is loaded
+ * - Manifests that build UI (create, style_with, directives) are client
+ *   code: they are left out of the module and reported by skipped()
+ */
+
+#pragma once
+
+#include "lamia_bytecode.hpp"
+#include "lamia_language_specification.hpp"
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Bytecode Compiler - AST to LamiaBytecodeWriter, one visitor pass per function
+ */
+class LamiaBytecodeCompiler : public LamiaExpressionVisitor {
+private:
+ struct FunctionInfo {
+ uint32_t index;
+ size_t parameters;
+ };
+
+ LamiaBytecodeWriter writer_;
+ std::map<std::string_view, FunctionInfo> functions_;
+ std::vector<std::string> errors_;
+ std::vector<std::string> skipped_;
+
+ // State of the function being lowered
+ std::string_view function_name_;
+ std::map<std::string_view, uint32_t> parameter_registers_;
+ size_t next_register_ = 0;
+ size_t max_registers_ = 0;
+ uint32_t target_ = 0; // Register the visited expression writes
+
+public:
+ /**
+ * @brief Lower every server-executable manifest of program
+ * @return false if any of them could not be lowered (see errors())
+ */
+ bool compile(const LamiaExpression& program) {
+ program.accept(*this);
+ return errors_.empty();
+ }
+
+ /**
+ * @brief The module image (.lbc file contents)
+ */
+ std::string bytes() const { return writer_.bytes(); }
+
+ const std::vector<std::string>& errors() const { return errors_; }
+
+ /**
+ * @brief Manifests left out of the module because they build UI
+ */
+ const std::vector<std::string>& skipped() const { return skipped_; }
+
+ void visit(const LamiaProgram& node) override {
+ // Indexes first, so calls may refer to manifests declared further down
+ std::vector<const LamiaFunction*> functions;
+ for (const auto* declaration : node.declarations()) {
+ if (declaration->type != LamiaExpression::NodeType::FUNCTION_DEF) {
+ continue;
+ }
+ const auto& function = static_cast<const LamiaFunction&>(*declaration);
+ if (!server_executable(function)) {
+ skipped_.emplace_back(function.name());
+ } else if (!functions_.emplace(function.name(), FunctionInfo{static_cast<uint32_t>(functions.size()),
+ function.parameters().size()}).second) {
+ errors_.push_back("manifest '" + std::string(function.name()) + "' is defined twice");
+ } else {
+ functions.push_back(&function);
+ }
+ }
+
+ for (const auto* function : functions) {
+ lower_function(*function);
+ }
+ }
+
+ void visit(const LamiaFunction& node) override {
+ fail("nested manifest '" + std::string(node.name()) + "'");
+ }
+
+ void visit(const WidgetExpression& node) override {
+ fail("'" + std::string(node.name()) + "' builds UI");
+ }
+
+ void visit(const LamiaStyle& node) override {
+ fail("style_with '" + std::string(node.selector()) + "' builds UI");
+ }
+
+ void visit(const LamiaReturn&) override {
+ fail("return_light used as a value");
+ }
+
+ void visit(const LamiaLiteral& node) override {
+ if (node.type == LamiaExpression::NodeType::IDENTIFIER) {
+ auto parameter = parameter_registers_.find(std::get<std::string_view>(node.value()));
+ if (parameter != parameter_registers_.end()) {
+ if (parameter->second != target_) {
+ writer_.emit(LamiaBytecode::encode(LamiaBytecode::MOVE, target_, parameter->second));
+ }
+ return;
+ }
+ }
+
+ uint32_t constant = std::visit([this](const auto& value) { return writer_.constant(value); }, node.value());
+ if (constant > 0xFFFF) {
+ fail("more than 65536 distinct constants in the file");
+ return;
+ }
+ writer_.emit(LamiaBytecode::encode_wide(LamiaBytecode::LOAD_CONSTANT, target_, constant));
+ }
+
+ void visit(const LamiaArray& node) override {
+ uint32_t result = target_;
+ uint32_t first = lower_run(node.elements());
+ writer_.emit(LamiaBytecode::encode(LamiaBytecode::MAKE_ARRAY, result, first, node.elements().size()));
+ next_register_ = first;
+ }
+
+ void visit(const LamiaCall& node) override {
+ uint32_t result = target_;
+ const auto& arguments = node.arguments();
+
+ auto function = functions_.find(node.callee());
+ if (function != functions_.end() && function->second.parameters != arguments.size()) {
+ fail("'" + std::string(node.callee()) + "' takes " + std::to_string(function->second.parameters) +
+ " arguments, called with " + std::to_string(arguments.size()));
+ return;
+ }
+
+ uint32_t first = lower_run(arguments);
+ if (function != functions_.end()) {
+ writer_.emit(LamiaBytecode::encode(LamiaBytecode::CALL, result, first, arguments.size()));
+ writer_.emit(function->second.index);
+ } else {
+ writer_.emit(LamiaBytecode::encode(LamiaBytecode::CALL_HOST, result, first, arguments.size()));
+ writer_.emit(writer_.import(node.callee()));
+ }
+ next_register_ = first;
+ }
+
+private:
+ /**
+ * @brief Client code: anything but calls, values and return_light in the body
+ */
+ static bool server_executable(const LamiaFunction& function) {
+ for (const auto* statement : function.body()) {
+ switch (statement->type) {
+ case LamiaExpression::NodeType::FUNCTION_CALL:
+ case LamiaExpression::NodeType::LITERAL:
+ case LamiaExpression::NodeType::IDENTIFIER:
+ case LamiaExpression::NodeType::RETURN:
+ break;
+ default:
+ return false;
+ }
+ }
+ return true;
+ }
+
+ void lower_function(const LamiaFunction& function) {
+ function_name_ = function.name();
+ parameter_registers_.clear();
+
+ std::vector<std::string_view> parameters;
+ for (const auto& parameter : function.parameters()) {
+ parameter_registers_.emplace(parameter.name, static_cast<uint32_t>(parameters.size()));
+ parameters.push_back(parameter.name);
+ }
+ if (parameters.size() > LamiaBytecode::MAX_REGISTERS) {
+ fail("too many parameters");
+ return;
+ }
+ next_register_ = max_registers_ = parameters.size();
+
+ writer_.begin_function(function.name(), parameters);
+ bool returned = false;
+ for (const auto* statement : function.body()) {
+ uint32_t result = allocate();
+ if (statement->type == LamiaExpression::NodeType::RETURN) {
+ const auto* value = static_cast<const LamiaReturn&>(*statement).value();
+ if (value) {
+ lower(*value, result);
+ writer_.emit(LamiaBytecode::encode(LamiaBytecode::RETURN, result));
+ } else {
+ writer_.emit(LamiaBytecode::encode(LamiaBytecode::RETURN_NULL, 0));
+ }
+ returned = true;
+ break; // The rest of the body is unreachable
+ }
+ if (statement->type == LamiaExpression::NodeType::FUNCTION_CALL) {
+ lower(*statement, result); // Evaluated for its effects; the value is dropped
+ }
+ next_register_ = parameters.size();
+ }
+ if (!returned) {
+ writer_.emit(LamiaBytecode::encode(LamiaBytecode::RETURN_NULL, 0));
+ }
+ writer_.end_function(max_registers_);
+ }
+
+ void lower(const LamiaExpression& node, uint32_t target) {
+ target_ = target;
+ node.accept(*this);
+ }
+
+ /**
+ * @brief Evaluate values into consecutive fresh registers
+ * @return The first of them
+ */
+ template<typename Values>
+ uint32_t lower_run(const Values& values) {
+ uint32_t first = static_cast<uint32_t>(next_register_);
+ for (size_t i = 0; i < values.size(); ++i) {
+ allocate();
+ }
+ for (size_t i = 0; i < values.size(); ++i) {
+ lower(*values[i], first + static_cast<uint32_t>(i));
+ }
+ return first;
+ }
+
+ uint32_t allocate() {
+ size_t reg = next_register_++;
+ max_registers_ = std::max(max_registers_, next_register_);
+ if (next_register_ > LamiaBytecode::MAX_REGISTERS) {
+ fail("needs more than " + std::to_string(LamiaBytecode::MAX_REGISTERS) + " registers");
+ return 0;
+ }
+ return static_cast<uint32_t>(reg);
+ }
+
+ void fail(const std::string& message) {
+ std::string error = "manifest '" + std::string(function_name_) + "': " + message;
+ if (errors_.empty() || errors_.back() != error) {
+ errors_.push_back(error);
+ }
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
@@ -0,0 +1,200 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA COMPILATION CACHE v0.3.0c
+ * ===============================
+ *
+ * On-disk cache of compiler outputs keyed by content hash
+ * - Key covers the source bytes, compiler configuration and target list
+ * - Hits hardlink (or copy) the stored outputs and skip the whole pipeline
+ * - Entries are published with an atomic rename, so a crashed compile
+ *   never leaves a half-written entry behind
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Cache Key - Incremental 64-bit FNV-1a over length-prefixed parts
+ */
+class LamiaCacheKey {
+private:
+ static constexpr uint64_t FNV_OFFSET = 1469598103934665603ULL;
+ static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+ uint64_t hash_ = FNV_OFFSET;
+ uint64_t length_ = 0;
+
+public:
+ /**
+ * @brief Fold one component into the key
+ */
+ LamiaCacheKey& add(std::string_view part) {
+ // Length prefix keeps ("ab","c") and ("a","bc") distinct
+ uint64_t size = part.size();
+ for (int i = 0; i < 8; ++i) {
+ mix(static_cast<unsigned char>(size >> (i * 8)));
+ }
+ for (char c : part) {
+ mix(static_cast<unsigned char>(c));
+ }
+ length_ += part.size();
+ return *this;
+ }
+
+ /**
+ * @brief Hex form used as the cache entry directory name
+ */
+ std::string hex() const {
+ char buffer[40];
+ std::snprintf(buffer, sizeof(buffer), "%016llx-%llx",
+ static_cast<unsigned long long>(hash_), static_cast<unsigned long long>(length_));
+ return buffer;
+ }
+
+private:
+ void mix(unsigned char byte) {
+ hash_ ^= byte;
+ hash_ *= FNV_PRIME;
+ }
+};
+
+/**
+ * @brief Lamia Compile Cache - Stores and restores output file sets
+ */
+class LamiaCompileCache {
+private:
+ std::filesystem::path directory_;
+
+ static constexpr const char* MANIFEST_NAME = "outputs.manifest";
+
+public:
+ explicit LamiaCompileCache(std::filesystem::path directory) : directory_(std::move(directory)) {}
+
+ /**
+ * @brief Default cache location: a sibling of the output directory
+ */
+ static std::filesystem::path directory_for(const std::string& output_dir) {
+ std::filesystem::path output(output_dir);
+ if (!output.has_filename()) {
+ output = output.parent_path(); // Tolerate trailing separators
+ }
+ return output.parent_path() / ".lamia_cache";
+ }
+
+ const std::filesystem::path& directory() const { return directory_; }
+
+ /**
+ * @brief Materialise a cached entry into output_dir
+ * @return false on a miss or if any output could not be restored
+ */
+ bool restore(const std::string& key, const std::string& output_dir, std::vector<std::string>* restored = nullptr) const {
+ std::filesystem::path entry = directory_ / key;
+ std::ifstream manifest(entry / MANIFEST_NAME);
+ if (!manifest.is_open()) {
+ return false;
+ }
+
+ std::vector<std::string> files;
+ std::string name;
+ while (std::getline(manifest, name)) {
+ if (!name.empty()) {
+ files.push_back(name);
+ }
+ }
+
+ std::error_code ec;
+ std::filesystem::create_directories(output_dir, ec);
+
+ for (const auto& file : files) {
+ if (!link_or_copy(entry / file, std::filesystem::path(output_dir) / file)) {
+ return false;
+ }
+ }
+
+ if (restored) {
+ *restored = std::move(files);
+ }
+ return true;
+ }
+
+ /**
+ * @brief Record the named files from output_dir under key
+ */
+ bool store(const std::string& key, const std::string& output_dir, const std::vector<std::string>& files) const {
+ std::error_code ec;
+ std::filesystem::path entry = directory_ / key;
+ if (std::filesystem::exists(entry / MANIFEST_NAME, ec)) {
+ return true; // Another compile already published this entry
+ }
+
+ // Build the entry in a private staging directory, then publish atomically
+ std::filesystem::path staging = directory_ / (key + ".tmp" + std::to_string(staging_suffix()));
+ std::filesystem::remove_all(staging, ec);
+ if (!std::filesystem::create_directories(staging, ec)) {
+ return false;
+ }
+
+ std::ofstream manifest(staging / MANIFEST_NAME);
+ for (const auto& file : files) {
+ if (!link_or_copy(std::filesystem::path(output_dir) / file, staging / file)) {
+ std::filesystem::remove_all(staging, ec);
+ return false;
+ }
+ manifest << file << '\n';
+ }
+ manifest.close();
+
+ std::filesystem::rename(staging, entry, ec);
+ if (ec) {
+ std::filesystem::remove_all(staging, ec); // Lost the race or cannot rename
+ return std::filesystem::exists(entry / MANIFEST_NAME, ec);
+ }
+ return true;
+ }
+
+private:
+ /**
+ * @brief Hardlink when the filesystem allows it, otherwise copy
+ *
+ * Writers must replace output files (unlink + create) rather than
+ * truncate them, or they would rewrite the shared inode in the cache.
+ */
+ static bool link_or_copy(const std::filesystem::path& from, const std::filesystem::path& to) {
+ std::error_code ec;
+ std::filesystem::remove(to, ec);
+ std::filesystem::create_hard_link(from, to, ec);
+ if (!ec) {
+ return true;
+ }
+ ec.clear();
+ std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing, ec);
+ return !ec;
+ }
+
+ static unsigned long long staging_suffix() {
+ static const unsigned long long base = static_cast<unsigned long long>(
+ std::filesystem::file_time_type::clock::now().time_since_epoch().count());
+ static std::atomic<unsigned long long> counter{0};
+ return base + counter++;
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
@@ -16,6 +16,12 @@
  */
 
 #include "lamia_language_specification.hpp"
+#include "lamia_bytecode_compiler.hpp"
+#include "lamia_compile_cache.hpp"
+#include "lamia_batch_runner.hpp"
+#include "lamia_lexer.hpp"
+#include "lamia_simd_scan.hpp"
+#include "lamia_source_buffer.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -23,599 +29,617 @@
 #include <filesystem>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+extern char** environ;
 
 namespace MedusaServ {
 namespace Language {
 namespace Lamia {
 
 /**
- * @brief Lamia Lexer - Tokenizes .lamia source code
+ * @brief Lamia Compiler - Complete compilation pipeline
  */
-class LamiaLexer {
+class LamiaCompiler {
 private:
- std::string source_;
- size_t position_ = 0;
- size_t line_ = 1;
- size_t column_ = 1;
- std::vector<LamiaToken> tokens_;
- 
- // AI assistance tracking
- bool ai_mode_active_ = false;
- std::vector<std::string> ai_completions_;
+ LamiaConfig config_;
+ std::map<LamiaTranspiler::Target, std::unique_ptr<LamiaTranspiler>> transpilers_;
  
 public:
- explicit LamiaLexer(const std::string& source) : source_(source) {}
- 
- /**
- * @brief Tokenize complete source code - Ground-up lexical analysis
- */
- std::vector<LamiaToken> tokenize() {
- std::cout << "🔍 Lamia Lexer: Tokenizing source (" << source_.length() << " characters)" << std::endl;
- 
- tokens_.clear();
- position_ = 0;
- line_ = 1;
- column_ = 1;
- 
- while (position_ < source_.length()) {
- char current = peek_char();
- 
- if (std::isspace(current)) {
- handle_whitespace();
- } else if (current == '/' && peek_char(1) == '/') {
- handle_single_line_comment();
- } else if (current == '/' && peek_char(1) == '*') {
- handle_multi_line_comment();
- } else if (current == '"') {
- handle_string_literal();
- } else if (current == '`') {
- handle_template_literal();
- } else if (std::isdigit(current) || (current == '.' && std::isdigit(peek_char(1)))) {
- handle_number_literal();
- } else if (std::isalpha(current) || current == '_') {
- handle_identifier_or_keyword();
- } else if (is_operator_char(current)) {
- handle_operator();
- } else if (is_punctuation(current)) {
- handle_punctuation();
- } else {
- // Unknown character - create error token
- add_token(LamiaToken::Type::IDENTIFIER, std::string(1, current), "Unknown character");
- advance_char();
- }
- }
- 
- std::cout << "✅ Lamia Lexer: Generated " << tokens_.size() << " tokens" << std::endl;
- return tokens_;
- }
+ // Compilation statistics
+ struct CompilationStats {
+ size_t tokens_generated = 0;
+ size_t ast_nodes_created = 0;
+ size_t lines_of_output = 0;
+ std::chrono::milliseconds compilation_time{0};
+ size_t cache_hits = 0;
+ size_t cache_misses = 0;
+ std::vector<std::string> warnings;
+ std::vector<std::string> errors;
  
  /**
- * @brief Enable AI-assisted tokenization
+ * @brief Fold another compilation's statistics into this one
  */
- void enable_ai_mode() {
- ai_mode_active_ = true;
- std::cout << "🤖 AI-assisted tokenization enabled" << std::endl;
+ void merge(const CompilationStats& other) {
+ tokens_generated += other.tokens_generated;
+ ast_nodes_created += other.ast_nodes_created;
+ lines_of_output += other.lines_of_output;
+ compilation_time += other.compilation_time;
+ cache_hits += other.cache_hits;
+ cache_misses += other.cache_misses;
+ warnings.insert(warnings.end(), other.warnings.begin(), other.warnings.end());
+ errors.insert(errors.end(), other.errors.begin(), other.errors.end());
  }
+ };
  
-private:
  /**
- * @brief Handle whitespace and newlines
+ * @brief One artifact produced by compile_source
  */
- void handle_whitespace() {
- char current = peek_char();
+ struct GeneratedOutput {
+ std::string filename;
+ std::string content;
+ };
  
- if (current == '\n') {
- add_token(LamiaToken::Type::NEWLINE, "\\n");
- line_++;
- column_ = 1;
- } else {
- // Collect all consecutive whitespace
- std::string whitespace;
- while (position_ < source_.length() && std::isspace(peek_char()) && peek_char() != '\n') {
- whitespace += peek_char();
- advance_char();
- }
- if (!whitespace.empty()) {
- add_token(LamiaToken::Type::WHITESPACE, whitespace);
- }
- return; // Don't advance again
- }
+private:
+ CompilationStats stats_;
+ 
+ static constexpr const char* COMPILER_VERSION = "0.3.0c";
+ static constexpr const char* OUTPUT_REVISION = "5"; // Bump when the same source compiles differently
+ static constexpr const char* PURPLE_PAGES_FILENAME = "documentation.purple.html";
  
- advance_char();
+public:
+ explicit LamiaCompiler(const LamiaConfig& config = LamiaConfig{}) : config_(config) {
+ initialize_transpilers();
  }
  
  /**
- * @brief Handle single-line comments
+ * @brief Compile .lamia file to multiple targets
  */
- void handle_single_line_comment() {
- advance_char(); // Skip first /
- advance_char(); // Skip second /
+ bool compile_file(const std::string& input_path, const std::string& output_dir) {
+ log() << "🔥 Lamia Compiler: Starting compilation" << std::endl;
+ log() << " Input: " << input_path << std::endl;
+ log() << " Output: " << output_dir << std::endl;
  
- std::string comment = "//";
- while (position_ < source_.length() && peek_char() != '\n') {
- comment += peek_char();
- advance_char();
- }
+ auto start_time = std::chrono::high_resolution_clock::now();
  
- add_token(LamiaToken::Type::COMMENT, comment, "Single-line comment");
+ // Map the source file - the lexer scans it in place
+ LamiaSourceBuffer source(input_path);
+ if (!source.is_open() || source.empty()) {
+ std::cerr << "❌ Failed to read input file: " << input_path << std::endl;
+ return false;
  }
  
- /**
- * @brief Handle multi-line comments
- */
- void handle_multi_line_comment() {
- advance_char(); // Skip /
- advance_char(); // Skip *
+ // Incremental compilation - unchanged sources reuse their previous outputs
+ std::unique_ptr<LamiaCompileCache> cache;
+ std::string cache_key;
+ if (config_.enable_compilation_cache) {
+ cache = std::make_unique<LamiaCompileCache>(config_.compilation_cache_dir.empty() ?
+ LamiaCompileCache::directory_for(output_dir) :
+ std::filesystem::path(config_.compilation_cache_dir));
+ cache_key = compute_cache_key(input_path, source.view());
  
- std::string comment = "/*";
- while (position_ < source_.length() - 1) {
- if (peek_char() == '*' && peek_char(1) == '/') {
- comment += "*/";
- advance_char(); // *
- advance_char(); // /
- break;
+ std::vector<std::string> restored;
+ if (cache->restore(cache_key, output_dir, &restored)) {
+ stats_.cache_hits++;
+ for (const auto& filename : restored) {
+ log() << "♻️ Restored from cache: " << filename << std::endl;
  }
  
- if (peek_char() == '\n') {
- line_++;
- column_ = 1;
+ auto end_time = std::chrono::high_resolution_clock::now();
+ stats_.compilation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+ print_compilation_stats();
+ return true;
  }
- 
- comment += peek_char();
- advance_char();
+ stats_.cache_misses++;
  }
  
- add_token(LamiaToken::Type::COMMENT, comment, "Multi-line comment");
+ // Lexical analysis and parsing - tokens view the mapped `source`, nodes live in `arena`
+ LamiaTokenStream tokens;
+ LamiaAstArena arena;
+ const LamiaExpression* ast = analyze(source.view(), tokens, arena);
+ if (!ast) {
+ return false;
  }
  
- /**
- * @brief Handle string literals with interpolation support
- */
- void handle_string_literal() {
- advance_char(); // Skip opening quote
+ // Create output directory
+ std::filesystem::create_directories(output_dir);
  
- std::string literal = "\"";
- bool has_interpolation = false;
+ // Single AST walk streams every configured target straight into its file
+ struct TargetOutput {
+ const LamiaTranspiler* transpiler;
+ std::string filename;
+ std::unique_ptr<LamiaFileSink> sink;
+ std::unique_ptr<LamiaSourceMap> map; // Null: no source map for this output
+ };
  
- while (position_ < source_.length() && peek_char() != '"') {
- char current = peek_char();
+ bool success = true;
+ std::vector<TargetOutput> outputs;
+ std::vector<TargetSink> targets;
  
- if (current == '\\') {
- // Handle escape sequences
- literal += current;
- advance_char();
- if (position_ < source_.length()) {
- literal += peek_char();
- advance_char();
- }
- } else if (current == '$' && peek_char(1) == '{') {
- // String interpolation detected
- has_interpolation = true;
- literal += current;
- advance_char();
- } else {
- if (current == '\n') {
- line_++;
- column_ = 1;
+ for (const auto& [target, transpiler] : transpilers_) {
+ std::string filename = generate_output_filename(input_path, target);
+ auto sink = std::make_unique<LamiaFileSink>(output_dir + "/" + filename);
+ if (!sink->is_open()) {
+ std::cerr << "❌ Failed to write output file: " << output_dir << "/" << filename << std::endl;
+ success = false;
+ continue;
  }
- literal += current;
- advance_char();
+ std::unique_ptr<LamiaSourceMap> map;
+ if (maps_target(target)) {
+ map = std::make_unique<LamiaSourceMap>(source.view());
+ sink->set_source_map(map.get());
  }
+ targets.push_back({transpiler.get(), sink.get()});
+ outputs.push_back({transpiler.get(), filename, std::move(sink), std::move(map)});
  }
  
- if (position_ < source_.length()) {
- literal += peek_char(); // Closing quote
- advance_char();
- }
+ emit_targets(*ast, targets, config_.minify_output);
  
- LamiaToken::Type type = has_interpolation ? 
- LamiaToken::Type::STRING_INTERPOLATION : 
- LamiaToken::Type::LITERAL;
+ std::vector<std::string> generated_files;
  
- add_token(type, literal, has_interpolation ? "Interpolated string" : "String literal");
+ for (auto& output : outputs) {
+ if (output.map) {
+ write_source_map_link(*output.sink, output.transpiler->target(), output.filename + ".map");
  }
+ size_t newlines = output.sink->newlines_written();
  
- /**
- * @brief Handle template literals (backtick strings)
- */
- void handle_template_literal() {
- advance_char(); // Skip opening backtick
- 
- std::string literal = "`";
- 
- while (position_ < source_.length() && peek_char() != '`') {
- char current = peek_char();
- 
- if (current == '\\') {
- literal += current;
- advance_char();
- if (position_ < source_.length()) {
- literal += peek_char();
- advance_char();
- }
+ if (!output.sink->close()) {
+ std::cerr << "❌ Failed to write output file: " << output_dir << "/" << output.filename << std::endl;
+ success = false;
  } else {
- if (current == '\n') {
- line_++;
- column_ = 1;
+ log() << "✅ Generated: " << output.filename << std::endl;
+ stats_.lines_of_output += newlines + 1;
+ generated_files.push_back(output.filename);
+ success = within_bundle_budget(output.transpiler->target(), output.filename, output.sink->bytes_written()) && success;
+ }
+ 
+ if (output.map) {
+ std::string filename = output.filename + ".map";
+ LamiaFileSink sink(output_dir + "/" + filename);
+ sink.write(output.map->to_json(output.filename, map_source_name(input_path, output_dir)));
+ if (!sink.close()) {
+ std::cerr << "❌ Failed to write output file: " << output_dir << "/" << filename << std::endl;
+ success = false;
+ } else {
+ generated_files.push_back(filename);
  }
- literal += current;
- advance_char();
  }
  }
  
- if (position_ < source_.length()) {
- literal += peek_char(); // Closing backtick
- advance_char();
+ // Server-side bytecode for the manifests, loaded by the function registry without re-parsing
+ if (config_.generate_server_bytecode) {
+ std::string image;
+ std::string filename = bytecode_filename(input_path);
+ if (compile_bytecode(*ast, image)) {
+ LamiaFileSink sink(output_dir + "/" + filename);
+ sink.write(image);
+ if (!sink.close()) {
+ std::cerr << "❌ Failed to write output file: " << output_dir << "/" << filename << std::endl;
+ success = false;
+ } else {
+ log() << "✅ Generated: " << filename << std::endl;
+ generated_files.push_back(filename);
  }
- 
- add_token(LamiaToken::Type::TEMPLATE_LITERAL, literal, "Template literal");
+ } else {
+ success = false;
  }
- 
- /**
- * @brief Handle numeric literals (integers and floats)
- */
- void handle_number_literal() {
- std::string number;
- bool has_decimal = false;
- 
- // Handle leading decimal point
- if (peek_char() == '.') {
- has_decimal = true;
- number += peek_char();
- advance_char();
  }
  
- while (position_ < source_.length()) {
- char current = peek_char();
- 
- if (std::isdigit(current)) {
- number += current;
- advance_char();
- } else if (current == '.' && !has_decimal) {
- has_decimal = true;
- number += current;
- advance_char();
- } else if (current == 'e' || current == 'E') {
- // Scientific notation
- number += current;
- advance_char();
- 
- if (position_ < source_.length() && (peek_char() == '+' || peek_char() == '-')) {
- number += peek_char();
- advance_char();
- }
+ // WebAssembly module for the glue in the WEBASSEMBLY output, also written out for validators and hosts
+ if (transpilers_.count(LamiaTranspiler::Target::WEBASSEMBLY)) {
+ std::string filename = wasm_filename(input_path);
+ LamiaFileSink sink(output_dir + "/" + filename);
+ sink.write(compile_wasm(*ast));
+ if (!sink.close()) {
+ std::cerr << "❌ Failed to write output file: " << output_dir << "/" << filename << std::endl;
+ success = false;
  } else {
- break;
+ log() << "✅ Generated: " << filename << std::endl;
+ generated_files.push_back(filename);
  }
  }
  
- add_token(LamiaToken::Type::LITERAL, number, has_decimal ? "Float literal" : "Integer literal");
+ // Native executable, built from the MEDUSA_NATIVE output once that file is complete
+ if (config_.build_native_executable && success) {
+ for (const auto& output : outputs) {
+ if (output.transpiler->target() != LamiaTranspiler::Target::MEDUSA_NATIVE) {
+ continue;
  }
- 
- /**
- * @brief Handle identifiers and keywords
- */
- void handle_identifier_or_keyword() {
- std::string identifier;
- 
- while (position_ < source_.length()) {
- char current = peek_char();
- 
- if (std::isalnum(current) || current == '_') {
- identifier += current;
- advance_char();
+ std::string executable = std::filesystem::path(input_path).stem().string();
+ if (build_native_executable(output_dir + "/" + output.filename, output_dir + "/" + executable)) {
+ log() << "✅ Built: " << executable << std::endl;
+ generated_files.push_back(executable);
  } else {
- break;
+ success = false;
+ }
  }
  }
  
- // Check if it's a keyword
- LamiaToken::Type type = is_keyword(identifier) ? 
- LamiaToken::Type::KEYWORD : 
- LamiaToken::Type::IDENTIFIER;
+ auto end_time = std::chrono::high_resolution_clock::now();
+ stats_.compilation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
  
- std::string hint = is_keyword(identifier) ? "Lamia keyword" : "Identifier";
+ print_compilation_stats();
+ 
+ // Generate Purple-Pages documentation if enabled
+ if (config_.generate_purple_pages_docs &&
+ generate_purple_pages_documentation(input_path, output_dir)) {
+ generated_files.push_back(PURPLE_PAGES_FILENAME);
+ }
  
- // AI suggestion for identifiers
- if (ai_mode_active_ && type == LamiaToken::Type::IDENTIFIER) {
- hint += " (AI suggestions available)";
+ if (success && cache) {
+ cache->store(cache_key, output_dir, generated_files);
  }
  
- add_token(type, identifier, hint);
+ return success;
  }
  
  /**
- * @brief Handle operators (including multi-character)
+ * @brief Compile in-memory source to every configured target
+ *
+ * Produces the artifacts compile_file would write for a file named
+ * source_name, Purple-Pages documentation included, without touching
+ * the filesystem - so no native executable is built. Statistics describe
+ * this compilation only.
  */
- void handle_operator() {
- std::string op;
+ bool compile_source(std::string_view source, const std::string& source_name,
+ std::vector<GeneratedOutput>& outputs) {
+ stats_ = CompilationStats{};
+ outputs.clear();
+ auto start_time = std::chrono::high_resolution_clock::now();
  
- // Check for multi-character operators first
- if (position_ + 2 < source_.length()) {
- std::string three_char = source_.substr(position_, 3);
- if (is_three_char_operator(three_char)) {
- op = three_char;
- advance_char();
- advance_char();
- advance_char();
- add_token(LamiaToken::Type::OPERATOR, op, "Three-character operator");
- return;
- }
+ LamiaTokenStream tokens;
+ LamiaAstArena arena;
+ const LamiaExpression* ast = analyze(source, tokens, arena);
+ if (!ast) {
+ return false;
  }
  
- if (position_ + 1 < source_.length()) {
- std::string two_char = source_.substr(position_, 2);
- if (is_two_char_operator(two_char)) {
- op = two_char;
- advance_char();
- advance_char();
- add_token(LamiaToken::Type::OPERATOR, op, "Two-character operator");
- return;
- }
- }
+ // Sinks append to outputs[i].content, so reserve before taking references
+ outputs.reserve(transpilers_.size() * 2 + 3);
+ std::vector<std::unique_ptr<LamiaMemorySink>> sinks;
+ std::vector<std::unique_ptr<LamiaSourceMap>> maps;
+ std::vector<TargetSink> targets;
+ const std::string* es6_output = nullptr;
  
- // Single character operator
- op = peek_char();
- advance_char();
- add_token(LamiaToken::Type::OPERATOR, op, "Single-character operator");
+ for (const auto& [target, transpiler] : transpilers_) {
+ outputs.push_back({generate_output_filename(source_name, target), std::string()});
+ sinks.push_back(std::make_unique<LamiaMemorySink>(outputs.back().content));
+ maps.push_back(maps_target(target) ? std::make_unique<LamiaSourceMap>(source) : nullptr);
+ sinks.back()->set_source_map(maps.back().get());
+ targets.push_back({transpiler.get(), sinks.back().get()});
+ if (target == LamiaTranspiler::Target::JAVASCRIPT_ES6) {
+ es6_output = &outputs.back().content;
  }
- 
- /**
- * @brief Handle punctuation
- */
- void handle_punctuation() {
- std::string punct(1, peek_char());
- advance_char();
- add_token(LamiaToken::Type::PUNCTUATION, punct, "Punctuation");
  }
  
- /**
- * @brief Add token to collection
- */
- void add_token(LamiaToken::Type type, const std::string& value, const std::string& hint = "") {
- LamiaToken token;
- token.type = type;
- token.value = value;
- token.line = line_;
- token.column = column_ - value.length();
- token.position = position_ - value.length();
- token.semantic_hint = hint;
- token.is_ai_generated = false; // Lexer tokens are not AI generated
- token.confidence_score = 1.0;
+ emit_targets(*ast, targets, config_.minify_output);
  
- tokens_.push_back(token);
+ bool success = true;
+ for (size_t i = 0; i < targets.size(); ++i) {
+ if (maps[i]) {
+ write_source_map_link(*sinks[i], targets[i].transpiler->target(), outputs[i].filename + ".map");
  }
- 
- /**
- * @brief Peek at character without advancing
- */
- char peek_char(size_t offset = 0) const {
- size_t pos = position_ + offset;
- return pos < source_.length() ? source_[pos] : '\0';
+ stats_.lines_of_output += sinks[i]->newlines_written() + 1;
+ success = within_bundle_budget(targets[i].transpiler->target(), outputs[i].filename, outputs[i].content.size()) && success;
  }
- 
- /**
- * @brief Advance position and column
- */
- void advance_char() {
- if (position_ < source_.length()) {
- position_++;
- column_++;
+ for (size_t i = 0; i < targets.size(); ++i) {
+ if (maps[i]) {
+ outputs.push_back({outputs[i].filename + ".map", maps[i]->to_json(outputs[i].filename, source_name)});
  }
  }
  
- /**
- * @brief Check if string is a Lamia keyword
- */
- bool is_keyword(const std::string& str) const {
- static const std::set<std::string> keywords = {
- // Declaration keywords
- "create", "become", "invoke", "summon",
- 
- // Control flow
- "when", "otherwise", "while_shining", "for_each_star", "until_dark",
- 
- // Function keywords 
- "manifest", "return_light", "yield_radiance",
- 
- // Class/Object keywords
- "blueprint", "inherit_essence", "implement_facet",
+ if (config_.generate_server_bytecode) {
+ outputs.push_back({bytecode_filename(source_name), std::string()});
+ success = compile_bytecode(*ast, outputs.back().content) && success;
+ }
  
- // Async keywords
- "await_dawn", "promise_light", "emit_signal",
+ if (transpilers_.count(LamiaTranspiler::Target::WEBASSEMBLY)) {
+ outputs.push_back({wasm_filename(source_name), compile_wasm(*ast)});
+ }
  
- // Widget keywords
- "render_beauty", "style_with", "bind_data", "handle_touch",
+ auto end_time = std::chrono::high_resolution_clock::now();
+ stats_.compilation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
  
- // Type keywords
- "radiant", "shimmer", "lumina", "void_star",
- "constellation", "nebula", "galaxy", "prism",
- "crystal", "aurora", "widget", "theme", "vault", "portal"
- };
+ if (config_.generate_purple_pages_docs) {
+ outputs.push_back({PURPLE_PAGES_FILENAME, std::string()});
+ LamiaMemorySink doc(outputs.back().content);
+ write_documentation_content(doc, source_name, [&](LamiaOutputSink& out) {
+ if (es6_output) {
+ auto es6 = transpilers_.find(LamiaTranspiler::Target::JAVASCRIPT_ES6);
+ write_html_escaped(out, std::string_view(*es6_output).substr(prologue_size(*es6->second)));
+ }
+ });
+ }
  
- return keywords.find(str) != keywords.end();
+ return success;
  }
  
  /**
- * @brief Check if character can be part of an operator
+ * @brief Compile source string directly
  */
- bool is_operator_char(char c) const {
- return c == '+' || c == '-' || c == '*' || c == '/' || c == '%' ||
- c == '=' || c == '!' || c == '<' || c == '>' || c == '&' ||
- c == '|' || c == '^' || c == '~' || c == '?' || c == ':';
+ std::string compile_string(const std::string& source, LamiaTranspiler::Target target) {
+ auto transpiler_it = transpilers_.find(target);
+ if (transpiler_it == transpilers_.end()) {
+ return "// Unsupported target";
  }
  
- /**
- * @brief Check if character is punctuation
- */
- bool is_punctuation(char c) const {
- return c == '(' || c == ')' || c == '[' || c == ']' ||
- c == '{' || c == '}' || c == ',' || c == ';' ||
- c == '.' || c == '@' || c == '#';
+ LamiaLexer lexer(source);
+ LamiaTokenStream tokens = lexer.tokenize();
+ 
+ std::string output = transpiler_it->second->transpile(tokens);
+ return output.empty() ? "// Compilation failed" : output;
  }
  
  /**
- * @brief Check for three-character operators
+ * @brief Get compilation statistics
  */
- bool is_three_char_operator(const std::string& op) const {
- static const std::set<std::string> three_char_ops = {
- "<~>", "**>", "<<<", ">>>"
- };
- return three_char_ops.find(op) != three_char_ops.end();
+ const CompilationStats& get_stats() const {
+ return stats_;
  }
  
  /**
- * @brief Check for two-character operators
+ * @brief Cache key over everything that determines the generated outputs
  */
- bool is_two_char_operator(const std::string& op) const {
- static const std::set<std::string> two_char_ops = {
- "==", "!=", "<=", ">=", "&&", "||", "++", "--",
- "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=",
- "<<", ">>", "->", "~>", "<*", "**"
- };
- return two_char_ops.find(op) != two_char_ops.end();
+ std::string compute_cache_key(const std::string& input_path, std::string_view source) const {
+ LamiaCacheKey key;
+ key.add(COMPILER_VERSION);
+ key.add(OUTPUT_REVISION);
+ key.add(std::filesystem::path(input_path).stem().string()); // Output names derive from it
+ key.add(config_.fingerprint());
+ for (const auto& [target, transpiler] : transpilers_) {
+ key.add(std::to_string(static_cast<int>(target)));
  }
-};
-
-/**
- * @brief Lamia Compiler - Complete compilation pipeline
- */
-class LamiaCompiler {
-private:
- LamiaConfig config_;
- std::unique_ptr<LamiaLexer> lexer_;
- std::unique_ptr<LamiaParser> parser_;
- std::map<LamiaTranspiler::Target, std::unique_ptr<LamiaTranspiler>> transpilers_;
- 
- // Compilation statistics
- struct CompilationStats {
- size_t tokens_generated = 0;
- size_t ast_nodes_created = 0;
- size_t lines_of_output = 0;
- std::chrono::milliseconds compilation_time{0};
- std::vector<std::string> warnings;
- std::vector<std::string> errors;
- } stats_;
- 
-public:
- explicit LamiaCompiler(const LamiaConfig& config = LamiaConfig{}) : config_(config) {
- initialize_transpilers();
+ key.add(source);
+ return key.hex();
  }
  
+private:
  /**
- * @brief Compile .lamia file to multiple targets
+ * @brief Progress stream - stdout, or a discarding stream when silenced
  */
- bool compile_file(const std::string& input_path, const std::string& output_dir) {
- std::cout << "🔥 Lamia Compiler: Starting compilation" << std::endl;
- std::cout << " Input: " << input_path << std::endl;
- std::cout << " Output: " << output_dir << std::endl;
- 
- auto start_time = std::chrono::high_resolution_clock::now();
- 
- // Read source file
- std::string source = read_file(input_path);
- if (source.empty()) {
- std::cerr << "❌ Failed to read input file: " << input_path << std::endl;
- return false;
+ std::ostream& log() const {
+ thread_local std::ostream silent(nullptr);
+ return config_.verbose_output ? std::cout : silent;
  }
  
- // Lexical analysis
- lexer_ = std::make_unique<LamiaLexer>(source);
+ /**
+ * @brief Lex and parse - the tree lives in arena and views tokens, which view source
+ */
+ const LamiaExpression* analyze(std::string_view source, LamiaTokenStream& tokens, LamiaAstArena& arena) {
+ LamiaLexer lexer(source);
+ lexer.set_verbose(config_.verbose_output);
  if (config_.enable_ai_assistance) {
- lexer_->enable_ai_mode();
+ lexer.enable_ai_mode();
  }
  
- auto tokens = lexer_->tokenize();
+ tokens = lexer.tokenize();
  stats_.tokens_generated = tokens.size();
  
  if (tokens.empty()) {
  std::cerr << "❌ No tokens generated from source" << std::endl;
- return false;
+ stats_.errors.push_back("No tokens generated from source");
+ return nullptr;
  }
  
- // Parsing
- parser_ = std::make_unique<LamiaParser>(tokens);
+ LamiaParser parser(tokens, arena);
  if (config_.enable_ai_assistance) {
- parser_->enable_ai_assistance([this](const std::string& context) {
+ parser.enable_ai_assistance([this](const std::string& context) {
  return request_ai_completion(context);
  });
  }
  
- auto ast = parser_->parse();
- if (!ast) {
+ auto ast = parser.parse();
+ if (!ast || !parser.get_diagnostics().empty()) {
  std::cerr << "❌ Parsing failed" << std::endl;
- for (const auto& error : parser_->get_errors()) {
+ for (const auto& error : parser.get_errors()) {
  std::cerr << " Parse Error: " << error << std::endl;
  stats_.errors.push_back(error);
  }
- return false;
+ return nullptr;
  }
  
- stats_.ast_nodes_created = 1; // Simplified count
+ stats_.ast_nodes_created = arena.node_count();
+ return ast;
+ }
  
- // Create output directory
- std::filesystem::create_directories(output_dir);
+ /**
+ * @brief Enforce LamiaConfig::max_bundle_size_kb on an output the browser downloads
+ *
+ * Native C++ is not a bundle and has no budget; 0 disables the check.
+ */
+ bool within_bundle_budget(LamiaTranspiler::Target target, const std::string& filename, size_t bytes) {
+ if (config_.max_bundle_size_kb <= 0 || target == LamiaTranspiler::Target::MEDUSA_NATIVE ||
+ bytes <= static_cast<size_t>(config_.max_bundle_size_kb) * 1024) {
+ return true;
+ }
  
- // Transpile to all configured targets
- bool success = true;
+ std::string error = filename + " is " + std::to_string((bytes + 1023) / 1024) + " KB, over the " +
+ std::to_string(config_.max_bundle_size_kb) + " KB bundle budget (max_bundle_size_kb)";
+ std::cerr << "❌ Bundle too large: " << error << std::endl;
+ stats_.errors.push_back(error);
+ return false;
+ }
  
- for (auto& [target, transpiler] : transpilers_) {
- std::string output = transpiler->transpile(ast);
- std::string filename = generate_output_filename(input_path, target);
- std::string output_path = output_dir + "/" + filename;
+ /**
+ * @brief Lower the program's manifests to a bytecode module image
+ */
+ bool compile_bytecode(const LamiaExpression& ast, std::string& image) {
+ LamiaBytecodeCompiler compiler;
+ bool lowered = compiler.compile(ast);
+ for (const auto& name : compiler.skipped()) {
+ log() << "ℹ️ Bytecode: manifest '" << name << "' builds UI, left to the client" << std::endl;
+ }
+ for (const auto& error : compiler.errors()) {
+ std::cerr << "❌ Bytecode: " << error << std::endl;
+ stats_.errors.push_back(error);
+ }
+ if (lowered) {
+ image = compiler.bytes();
+ }
+ return lowered;
+ }
  
- if (!write_file(output_path, output)) {
- std::cerr << "❌ Failed to write output file: " << output_path << std::endl;
- success = false;
- } else {
- std::cout << "✅ Generated: " << filename << std::endl;
- stats_.lines_of_output += count_lines(output);
+ static std::string bytecode_filename(const std::string& input_path) {
+ return std::filesystem::path(input_path).stem().string() + ".lbc";
  }
+ 
+ /**
+ * @brief The WebAssembly module of the program's number and logic manifests
+ *
+ * Manifests that cannot compile stay in JavaScript, so this never fails.
+ */
+ std::string compile_wasm(const LamiaExpression& ast) {
+ LamiaWasmCompiler compiler;
+ compiler.compile(ast);
+ for (const auto& reason : compiler.skipped()) {
+ log() << "ℹ️ WebAssembly: manifest " << reason << ", left to JavaScript" << std::endl;
+ }
+ return compiler.bytes();
  }
  
- auto end_time = std::chrono::high_resolution_clock::now();
- stats_.compilation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+ static std::string wasm_filename(const std::string& input_path) {
+ return std::filesystem::path(input_path).stem().string() + ".wasm";
+ }
  
- print_compilation_stats();
+ /**
+ * @brief Whether a target's output gets a source map - native C++ never does
+ */
+ bool maps_target(LamiaTranspiler::Target target) const {
+ return config_.generate_source_maps && target != LamiaTranspiler::Target::MEDUSA_NATIVE;
+ }
  
- // Generate Purple-Pages documentation if enabled
- if (config_.generate_purple_pages_docs) {
- generate_purple_pages_documentation(input_path, output_dir, ast);
+ /**
+ * @brief Point an output at its map; HTML has no such comment, its map is found by name
+ *
+ * Detaches the map first: the comment itself is not mapped, and a mark
+ * left by a node that wrote nothing to this output is dropped.
+ */
+ static void write_source_map_link(LamiaOutputSink& out, LamiaTranspiler::Target target, const std::string& map_filename) {
+ out.set_source_map(nullptr);
+ if (target == LamiaTranspiler::Target::HTML5) {
+ return;
+ }
+ if (target == LamiaTranspiler::Target::CSS3) {
+ out << "\n/*# sourceMappingURL=" << map_filename << " */\n";
+ return;
+ }
+ out << "\n//# sourceMappingURL=" << map_filename << "\n";
  }
  
- return success;
+ /**
+ * @brief The source as a map in output_dir refers to it
+ */
+ static std::string map_source_name(const std::string& input_path, const std::string& output_dir) {
+ std::error_code ec;
+ auto relative = std::filesystem::relative(std::filesystem::absolute(input_path, ec), std::filesystem::absolute(output_dir, ec), ec);
+ return ec || relative.empty() ? std::filesystem::path(input_path).filename().string() : relative.generic_string();
  }
  
  /**
- * @brief Compile source string directly
+ * @brief Compile generated C++ into an executable with the system compiler
+ *
+ * The compiler's own diagnostics go straight to stderr; a failure to
+ * start it or a non-zero exit fails the compilation.
  */
- std::string compile_string(const std::string& source, LamiaTranspiler::Target target) {
- lexer_ = std::make_unique<LamiaLexer>(source);
- auto tokens = lexer_->tokenize();
+ bool build_native_executable(const std::string& source, const std::string& executable) {
+ std::vector<std::string> arguments{config_.native_compiler};
+ std::istringstream flags(config_.native_compiler_flags);
+ for (std::string flag; flags >> flag;) {
+ arguments.push_back(flag);
+ }
+ arguments.push_back("-I" + native_runtime_dir().string());
+ arguments.insert(arguments.end(), {source, "-o", executable});
  
- parser_ = std::make_unique<LamiaParser>(tokens);
- auto ast = parser_->parse();
+ std::vector<char*> argv;
+ for (auto& argument : arguments) {
+ argv.push_back(argument.data());
+ }
+ argv.push_back(nullptr);
  
- if (!ast) {
- return "// Compilation failed";
+ // Cached outputs are hardlinks: replace the executable, never write through it
+ std::error_code ec;
+ std::filesystem::remove(executable, ec);
+ 
+ pid_t pid = 0;
+ int status = 0;
+ int spawned = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+ if (spawned == 0) {
+ while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+ }
  }
  
- auto transpiler_it = transpilers_.find(target);
- if (transpiler_it != transpilers_.end()) {
- return transpiler_it->second->transpile(ast);
+ std::string error;
+ if (spawned != 0) {
+ error = "cannot run " + config_.native_compiler + ": " + std::strerror(spawned);
+ } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+ error = config_.native_compiler + " failed to build " + executable + " from " + source;
+ }
+ if (!error.empty()) {
+ std::cerr << "❌ Native build: " << error << std::endl;
+ stats_.errors.push_back(error);
+ return false;
+ }
+ return true;
  }
  
- return "// Unsupported target";
+ /**
+ * @brief Directory holding medusa_native_runtime.hpp
+ *
+ * The runtime ships beside the compiler's sources; failing that, the
+ * directory of the running compiler binary is searched.
+ */
+ std::filesystem::path native_runtime_dir() const {
+ if (!config_.native_runtime_dir.empty()) {
+ return config_.native_runtime_dir;
+ }
+ std::error_code ec;
+ auto runtime = std::filesystem::absolute(std::filesystem::path(__FILE__).parent_path() / "medusa_native_runtime.hpp", ec);
+ if (!ec && std::filesystem::exists(runtime, ec)) {
+ return runtime.parent_path();
+ }
+ return std::filesystem::read_symlink("/proc/self/exe", ec).parent_path();
  }
  
  /**
- * @brief Get compilation statistics
+ * @brief A transpiler and the sink its target streams into
  */
- const CompilationStats& get_stats() const {
- return stats_;
+ struct TargetSink {
+ const LamiaTranspiler* transpiler;
+ LamiaOutputSink* sink;
+ };
+ 
+ /**
+ * @brief One AST walk feeds every target - prologue, body and epilogue
+ */
+ static void emit_targets(const LamiaExpression& ast, const std::vector<TargetSink>& targets, bool minify) {
+ unsigned channels = 0;
+ for (const auto& target : targets) {
+ target.transpiler->write_prologue(*target.sink);
+ channels |= target.transpiler->channel();
+ }
+ 
+ LamiaEmitter emitter(channels, minify);
+ for (const auto& target : targets) {
+ emitter.attach(target.transpiler->channel(), *target.sink);
+ }
+ emitter.emit(ast);
+ 
+ for (const auto& target : targets) {
+ target.transpiler->write_epilogue(*target.sink, ast);
+ }
  }
  
-private:
  /**
  * @brief Initialize transpilers for all targets
  */
@@ -635,34 +659,11 @@ private:
  std::make_unique<LamiaTranspiler>(LamiaTranspiler::Target::JAVASCRIPT_ES6);
  }
  
- std::cout << "🔧 Initialized " << transpilers_.size() << " transpilers" << std::endl;
- }
- 
- /**
- * @brief Read file contents
- */
- std::string read_file(const std::string& path) {
- std::ifstream file(path);
- if (!file.is_open()) {
- return "";
- }
- 
- std::stringstream buffer;
- buffer << file.rdbuf();
- return buffer.str();
- }
- 
- /**
- * @brief Write file contents
- */
- bool write_file(const std::string& path, const std::string& content) {
- std::ofstream file(path);
- if (!file.is_open()) {
- return false;
+ for (auto& [target, transpiler] : transpilers_) {
+ transpiler->set_minify(config_.minify_output);
  }
  
- file << content;
- return true;
+ log() << "🔧 Initialized " << transpilers_.size() << " transpilers" << std::endl;
  }
  
  /**
@@ -686,19 +687,12 @@ private:
  case LamiaTranspiler::Target::MEDUSA_NATIVE:
  return base_name + ".cpp";
  case LamiaTranspiler::Target::WEBASSEMBLY:
- return base_name + ".wasm";
+ return base_name + ".wasm.js"; // The module itself is <name>.wasm
  default:
  return base_name + ".out";
  }
  }
  
- /**
- * @brief Count lines in string
- */
- size_t count_lines(const std::string& content) {
- return std::count(content.begin(), content.end(), '\n') + 1;
- }
- 
  /**
  * @brief Request AI completion (placeholder)
  */
@@ -711,25 +705,26 @@ private:
  * @brief Print compilation statistics
  */
  void print_compilation_stats() {
- std::cout << "\n📊 COMPILATION STATISTICS:" << std::endl;
- std::cout << " Tokens Generated: " << stats_.tokens_generated << std::endl;
- std::cout << " AST Nodes: " << stats_.ast_nodes_created << std::endl;
- std::cout << " Output Lines: " << stats_.lines_of_output << std::endl;
- std::cout << " Compilation Time: " << stats_.compilation_time.count() << "ms" << std::endl;
- std::cout << " Warnings: " << stats_.warnings.size() << std::endl;
- std::cout << " Errors: " << stats_.errors.size() << std::endl;
+ log() << "\n📊 COMPILATION STATISTICS:" << std::endl;
+ log() << " Tokens Generated: " << stats_.tokens_generated << std::endl;
+ log() << " AST Nodes: " << stats_.ast_nodes_created << std::endl;
+ log() << " Output Lines: " << stats_.lines_of_output << std::endl;
+ log() << " Compilation Time: " << stats_.compilation_time.count() << "ms" << std::endl;
+ log() << " Cache Hits/Misses: " << stats_.cache_hits << "/" << stats_.cache_misses << std::endl;
+ log() << " Warnings: " << stats_.warnings.size() << std::endl;
+ log() << " Errors: " << stats_.errors.size() << std::endl;
  
  if (!stats_.warnings.empty()) {
- std::cout << "\n⚠️ WARNINGS:" << std::endl;
+ log() << "\n⚠️ WARNINGS:" << std::endl;
  for (const auto& warning : stats_.warnings) {
- std::cout << " " << warning << std::endl;
+ log() << " " << warning << std::endl;
  }
  }
  
  if (!stats_.errors.empty()) {
- std::cout << "\n❌ ERRORS:" << std::endl;
+ log() << "\n❌ ERRORS:" << std::endl;
  for (const auto& error : stats_.errors) {
- std::cout << " " << error << std::endl;
+ log() << " " << error << std::endl;
  }
  }
  }
@@ -737,32 +732,37 @@ private:
  /**
  * @brief Generate Purple-Pages documentation
  */
- void generate_purple_pages_documentation(const std::string& input_path, 
- const std::string& output_dir,
- std::shared_ptr<LamiaExpression> ast) {
- std::cout << "📖 Generating Purple-Pages documentation..." << std::endl;
- 
- std::string doc_content = generate_documentation_content(input_path, ast);
- std::string doc_path = output_dir + "/documentation.purple.html";
+ bool generate_purple_pages_documentation(const std::string& input_path, 
+ const std::string& output_dir) {
+ log() << "📖 Generating Purple-Pages documentation..." << std::endl;
  
- if (write_file(doc_path, doc_content)) {
- std::cout << "✅ Purple-Pages documentation generated: documentation.purple.html" << std::endl;
+ LamiaFileSink doc(output_dir + "/" + PURPLE_PAGES_FILENAME);
+ if (!doc.is_open()) {
+ return false;
  }
+ write_documentation_content(doc, input_path, [&](LamiaOutputSink& out) {
+ write_generated_javascript(out, input_path, output_dir);
+ });
+ if (!doc.close()) {
+ return false;
+ }
+ log() << "✅ Purple-Pages documentation generated: " << PURPLE_PAGES_FILENAME << std::endl;
+ return true;
  }
  
  /**
  * @brief Generate documentation content
  */
- std::string generate_documentation_content(const std::string& input_path,
- std::shared_ptr<LamiaExpression> ast) {
- std::stringstream doc;
+ void write_documentation_content(LamiaOutputSink& doc, const std::string& input_path,
+ const std::function<void(LamiaOutputSink&)>& write_code) {
+ std::string source_name = std::filesystem::path(input_path).filename().string();
  
  doc << "<!DOCTYPE html>\n";
  doc << "<html lang=\"en\">\n";
  doc << "<head>\n";
  doc << " <meta charset=\"UTF-8\">\n";
  doc << " <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n";
- doc << " <title>Purple-Pages: " << std::filesystem::path(input_path).filename().string() << "</title>\n";
+ doc << " <title>Purple-Pages: " << source_name << "</title>\n";
  doc << " <style>\n";
  doc << " body { font-family: 'Courier New', monospace; background: #1a1a2e; color: #eee; }\n";
  doc << " .purple-header { background: linear-gradient(45deg, #8B5CF6, #A855F7); padding: 20px; }\n";
@@ -775,40 +775,518 @@ private:
  doc << "<body>\n";
  doc << " <div class=\"purple-header\">\n";
  doc << " <h1>🔮 Purple-Pages Documentation</h1>\n";
- doc << " <p>Lamia Language: " << std::filesystem::path(input_path).filename().string() << "</p>\n";
+ doc << " <p>Lamia Language: " << source_name << "</p>\n";
  doc << " </div>\n";
  doc << " <div class=\"content\">\n";
  doc << " <h2>📊 Compilation Details</h2>\n";
  doc << " <ul>\n";
- doc << " <li>Tokens: " << stats_.tokens_generated << "</li>\n";
- doc << " <li>Compilation Time: " << stats_.compilation_time.count() << "ms</li>\n";
- doc << " <li>Output Lines: " << stats_.lines_of_output << "</li>\n";
+ doc << " <li>Tokens: " << std::to_string(stats_.tokens_generated) << "</li>\n";
+ doc << " <li>Compilation Time: " << std::to_string(stats_.compilation_time.count()) << "ms</li>\n";
+ doc << " <li>Output Lines: " << std::to_string(stats_.lines_of_output) << "</li>\n";
  doc << " </ul>\n";
  doc << " <h2>🎯 Generated Code</h2>\n";
  doc << " <div class=\"code-block\">\n";
- doc << " <pre>" << html_escape(ast->to_javascript()) << "</pre>\n";
+ doc << " <pre>";
+ write_code(doc);
+ doc << "</pre>\n";
  doc << " </div>\n";
  doc << " </div>\n";
  doc << "</body>\n";
  doc << "</html>\n";
+ }
+ 
+ /**
+ * @brief Stream the ES6 body back from its output file, HTML-escaped, chunk by chunk
+ */
+ void write_generated_javascript(LamiaOutputSink& doc, const std::string& input_path,
+ const std::string& output_dir) {
+ auto es6 = transpilers_.find(LamiaTranspiler::Target::JAVASCRIPT_ES6);
+ if (es6 == transpilers_.end()) {
+ return;
+ }
+ 
+ std::ifstream javascript(output_dir + "/" + generate_output_filename(input_path, es6->first), std::ios::binary);
+ javascript.seekg(static_cast<std::streamoff>(prologue_size(*es6->second)));
+ 
+ std::unique_ptr<char[]> chunk(new char[LamiaOutputSink::CHUNK_SIZE]);
+ while (javascript.read(chunk.get(), LamiaOutputSink::CHUNK_SIZE) || javascript.gcount() > 0) {
+ write_html_escaped(doc, std::string_view(chunk.get(), static_cast<size_t>(javascript.gcount())));
+ }
+ }
  
- return doc.str();
+ /**
+ * @brief Length of the banner a target writes ahead of the generated body
+ */
+ static size_t prologue_size(const LamiaTranspiler& transpiler) {
+ std::string banner;
+ LamiaMemorySink sink(banner);
+ transpiler.write_prologue(sink);
+ return banner.size();
  }
  
  /**
  * @brief Escape HTML characters
  */
- std::string html_escape(const std::string& input) {
- std::string result = input;
- std::regex lt("<");
- std::regex gt(">");
- std::regex amp("&");
+ static void write_html_escaped(LamiaOutputSink& out, std::string_view input) {
+ size_t run = 0;
+ for (size_t i = 0; i < input.size(); ++i) {
+ std::string_view entity;
+ switch (input[i]) {
+ case '&': entity = "&amp;"; break;
+ case '<': entity = "&lt;"; break;
+ case '>': entity = "&gt;"; break;
+ default: continue;
+ }
+ out << input.substr(run, i - run) << entity;
+ run = i + 1;
+ }
+ out << input.substr(run);
+ }
+};
+
+/**
+ * @brief Lamia Batch Compiler - Compiles whole source trees on a work-stealing pool
+ *
+ * Every file gets its own LamiaCompiler (and so its own lexer, parser,
+ * arena and transpilers); workers share nothing but the report.
+ */
+class LamiaBatchCompiler {
+private:
+ LamiaConfig config_;
+ size_t jobs_;
+ 
+public:
+ LamiaBatchCompiler(const LamiaConfig& config, size_t jobs) : config_(config), jobs_(jobs) {
+ config_.verbose_output = false; // Workers would interleave their progress output
+ }
+ 
+ /**
+ * @brief Compile every .lamia file under input (directory or manifest)
+ *
+ * Outputs mirror the source tree: src/a/page.lamia -> output/a/page/.
+ */
+ bool compile_tree(const std::string& input, const std::string& output_dir) {
+ std::vector<LamiaBatchJob> jobs = collect_lamia_sources(input);
+ if (jobs.empty()) {
+ std::cerr << "❌ No .lamia sources found in: " << input << std::endl;
+ return false;
+ }
+ 
+ // One cache for the whole tree rather than one per output directory
+ LamiaConfig config = config_;
+ if (config.compilation_cache_dir.empty()) {
+ config.compilation_cache_dir = LamiaCompileCache::directory_for(output_dir).string();
+ }
+ 
+ std::cout << "🔥 Lamia Batch Compiler: " << jobs.size() << " sources, "
+ << std::max<size_t>(jobs_, 1) << " workers" << std::endl;
+ 
+ auto start_time = std::chrono::high_resolution_clock::now();
+ 
+ std::mutex report_mutex;
+ LamiaCompiler::CompilationStats total;
+ std::vector<std::string> failed;
+ size_t completed = 0;
+ 
+ {
+ LamiaWorkStealingPool pool(jobs_);
+ for (const auto& job : jobs) {
+ pool.submit([&, job]() {
+ LamiaCompiler compiler(config);
+ bool ok = compiler.compile_file(job.input.string(), job.output_dir(output_dir).string());
+ 
+ std::lock_guard<std::mutex> lock(report_mutex);
+ total.merge(compiler.get_stats());
+ if (!ok) {
+ failed.push_back(job.input.string());
+ }
+ std::cout << (ok ? "✅ [" : "❌ [") << ++completed << "/" << jobs.size() << "] "
+ << job.input.string() << " (" << compiler.get_stats().compilation_time.count() << "ms)" << std::endl;
+ });
+ }
+ pool.wait_idle();
+ }
+ 
+ auto end_time = std::chrono::high_resolution_clock::now();
+ auto wall_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+ 
+ print_batch_report(jobs.size(), failed, total, wall_time);
+ return failed.empty();
+ }
+ 
+private:
+ void print_batch_report(size_t sources, const std::vector<std::string>& failed,
+ const LamiaCompiler::CompilationStats& total,
+ std::chrono::milliseconds wall_time) {
+ std::cout << "\n📊 BATCH COMPILATION STATISTICS:" << std::endl;
+ std::cout << " Sources: " << sources << " (" << failed.size() << " failed)" << std::endl;
+ std::cout << " Tokens Generated: " << total.tokens_generated << std::endl;
+ std::cout << " AST Nodes: " << total.ast_nodes_created << std::endl;
+ std::cout << " Output Lines: " << total.lines_of_output << std::endl;
+ std::cout << " Compile Time (sum): " << total.compilation_time.count() << "ms" << std::endl;
+ std::cout << " Wall Time: " << wall_time.count() << "ms" << std::endl;
+ std::cout << " Cache Hits/Misses: " << total.cache_hits << "/" << total.cache_misses << std::endl;
+ std::cout << " Warnings: " << total.warnings.size() << std::endl;
+ std::cout << " Errors: " << total.errors.size() << std::endl;
+ 
+ if (!failed.empty()) {
+ std::cout << "\n❌ FAILED SOURCES:" << std::endl;
+ for (const auto& path : failed) {
+ std::cout << " " << path << std::endl;
+ }
+ }
+ 
+ if (!total.errors.empty()) {
+ std::cout << "\n❌ ERRORS:" << std::endl;
+ for (const auto& error : total.errors) {
+ std::cout << " " << error << std::endl;
+ }
+ }
+ }
+};
+
+/**
+ * @brief Lamia Compile Server - Long-lived compiler behind a Unix domain socket
+ *
+ * Editors and MedusaServ send source bytes and get every artifact back
+ * without paying process start-up, transpiler set-up or a cache lookup on
+ * disk. Warm compilers are pooled per worker and recent results are kept
+ * in memory. A connection may carry any number of requests:
+ *
+ *   COMPILE <source_name> <byte_count>\n<source bytes>
+ *     -> OK <output_count> <microseconds>\n, then per output
+ *        <filename> <byte_count>\n<bytes>
+ *     -> ERROR <byte_count>\n<message>
+ *   PING\n  -> PONG\n
+ *   STATS\n -> STATS <requests> <cache_hits> <cache_misses>\n
+ */
+class LamiaCompileServer {
+public:
+ static constexpr size_t MAX_SOURCE_BYTES = 64 * 1024 * 1024;
+ static constexpr size_t RESULT_CACHE_BYTES = 64 * 1024 * 1024;
+ static constexpr int IDLE_TIMEOUT_SECONDS = 30; // Frees the worker held by a silent client
+ 
+private:
+ using Outputs = std::vector<LamiaCompiler::GeneratedOutput>;
+ 
+ LamiaConfig config_;
+ std::string socket_path_;
+ size_t workers_;
+ 
+ // Warm compilers, checked out for the duration of one request
+ std::mutex compilers_mutex_;
+ std::vector<std::unique_ptr<LamiaCompiler>> idle_compilers_;
+ 
+ // Recent results, least recently used at the back
+ struct CachedResult {
+ std::string key;
+ std::shared_ptr<const Outputs> outputs;
+ size_t bytes;
+ };
+ std::mutex results_mutex_;
+ std::list<CachedResult> results_;
+ std::unordered_map<std::string, std::list<CachedResult>::iterator> result_index_;
+ size_t result_bytes_ = 0;
+ 
+ std::atomic<size_t> requests_{0};
+ std::atomic<size_t> cache_hits_{0};
+ std::atomic<size_t> cache_misses_{0};
+ 
+ static inline volatile std::sig_atomic_t stop_requested_ = 0;
+ 
+public:
+ LamiaCompileServer(const LamiaConfig& config, std::string socket_path, size_t workers)
+ : config_(config), socket_path_(std::move(socket_path)), workers_(std::max<size_t>(workers, 1)) {
+ config_.verbose_output = false; // Workers would interleave their progress output
+ config_.enable_compilation_cache = false; // Results are cached in memory instead
+ }
+ 
+ /**
+ * @brief Accept and serve connections until SIGINT or SIGTERM
+ */
+ bool serve() {
+ int listen_fd = open_listener();
+ if (listen_fd < 0) {
+ std::cerr << "❌ Cannot listen on " << socket_path_ << ": " << std::strerror(errno) << std::endl;
+ return false;
+ }
+ 
+ // No SA_RESTART: a signal interrupts accept() so the loop can exit
+ struct sigaction action {};
+ action.sa_handler = [](int) { stop_requested_ = 1; };
+ sigemptyset(&action.sa_mask);
+ sigaction(SIGINT, &action, nullptr);
+ sigaction(SIGTERM, &action, nullptr);
+ 
+ // Pay transpiler set-up once per worker before the first request
+ for (size_t i = 0; i < workers_; ++i) {
+ idle_compilers_.push_back(std::make_unique<LamiaCompiler>(config_));
+ }
+ 
+ std::cout << "🔥 Lamia Compile Server: listening on " << socket_path_
+ << " with " << workers_ << " workers" << std::endl;
+ 
+ // Workers inherit a blocked mask, so only this thread's accept() sees the signal
+ sigset_t stop_signals;
+ sigemptyset(&stop_signals);
+ sigaddset(&stop_signals, SIGINT);
+ sigaddset(&stop_signals, SIGTERM);
+ pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+ 
+ {
+ LamiaWorkStealingPool pool(workers_);
+ pthread_sigmask(SIG_UNBLOCK, &stop_signals, nullptr);
+ 
+ while (!stop_requested_) {
+ int client_fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+ if (client_fd < 0) {
+ if (errno == EINTR || errno == ECONNABORTED) {
+ continue;
+ }
+ std::cerr << "❌ accept failed: " << std::strerror(errno) << std::endl;
+ break;
+ }
+ 
+ timeval timeout{IDLE_TIMEOUT_SECONDS, 0};
+ ::setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+ pool.submit([this, client_fd]() {
+ serve_connection(client_fd);
+ ::close(client_fd);
+ });
+ }
+ 
+ ::close(listen_fd);
+ ::unlink(socket_path_.c_str());
+ pool.wait_idle();
+ }
+ 
+ std::cout << "🛑 Lamia Compile Server stopped after " << requests_ << " requests ("
+ << cache_hits_ << " cache hits)" << std::endl;
+ return true;
+ }
+ 
+private:
+ /**
+ * @brief Buffered reads of request lines and payloads from one client
+ */
+ class RequestReader {
+ private:
+ int fd_;
+ char buffer_[16 * 1024];
+ size_t begin_ = 0;
+ size_t end_ = 0;
+ 
+ public:
+ explicit RequestReader(int fd) : fd_(fd) {}
+ 
+ /**
+ * @brief Next line without its newline - false at end of stream or past max_length
+ */
+ bool read_line(std::string& line, size_t max_length = 4096) {
+ line.clear();
+ while (true) {
+ const char* start = buffer_ + begin_;
+ const char* newline = LamiaScan::find(start, buffer_ + end_, '\n');
+ line.append(start, newline);
+ begin_ = static_cast<size_t>(newline - buffer_);
+ if (newline != buffer_ + end_) {
+ ++begin_;
+ return true;
+ }
+ if (line.size() > max_length || !fill()) {
+ return false;
+ }
+ }
+ }
+ 
+ /**
+ * @brief Exactly size bytes, buffered remainder first
+ */
+ bool read_exact(std::string& out, size_t size) {
+ out.resize(size);
+ size_t copied = std::min(size, end_ - begin_);
+ std::memcpy(out.data(), buffer_ + begin_, copied);
+ begin_ += copied;
+ 
+ while (copied < size) {
+ ssize_t count = ::recv(fd_, out.data() + copied, size - copied, 0);
+ if (count < 0 && errno == EINTR) {
+ continue;
+ }
+ if (count <= 0) {
+ return false;
+ }
+ copied += static_cast<size_t>(count);
+ }
+ return true;
+ }
+ 
+ private:
+ bool fill() {
+ begin_ = end_ = 0;
+ while (true) {
+ ssize_t count = ::recv(fd_, buffer_, sizeof(buffer_), 0);
+ if (count < 0 && errno == EINTR) {
+ continue;
+ }
+ if (count <= 0) {
+ return false;
+ }
+ end_ = static_cast<size_t>(count);
+ return true;
+ }
+ }
+ };
+ 
+ int open_listener() {
+ sockaddr_un address{};
+ address.sun_family = AF_UNIX;
+ if (socket_path_.empty() || socket_path_.size() >= sizeof(address.sun_path)) {
+ errno = ENAMETOOLONG;
+ return -1;
+ }
+ std::memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+ 
+ int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+ if (fd < 0) {
+ return -1;
+ }
+ ::unlink(socket_path_.c_str()); // Stale socket from a previous run
+ if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+ ::listen(fd, SOMAXCONN) < 0) {
+ int saved = errno;
+ ::close(fd);
+ errno = saved;
+ return -1;
+ }
+ return fd;
+ }
+ 
+ void serve_connection(int client_fd) {
+ RequestReader reader(client_fd);
+ LamiaSocketSink out(client_fd);
+ std::string line;
+ std::string source;
+ 
+ while (out.ok() && reader.read_line(line)) {
+ std::istringstream request(line);
+ std::string command;
+ request >> command;
+ 
+ if (command == "COMPILE") {
+ std::string source_name;
+ size_t size = 0;
+ if (!(request >> source_name >> size) || size > MAX_SOURCE_BYTES) {
+ write_error(out, "Malformed COMPILE request: " + line);
+ return; // Payload length unknown - the stream cannot be resynchronised
+ }
+ if (!reader.read_exact(source, size)) {
+ return;
+ }
+ handle_compile(out, source_name, source);
+ } else if (command == "PING") {
+ out << "PONG\n";
+ } else if (command == "STATS") {
+ out << "STATS " << std::to_string(requests_) << ' ' << std::to_string(cache_hits_)
+ << ' ' << std::to_string(cache_misses_) << '\n';
+ } else {
+ write_error(out, "Unknown command: " + command);
+ }
+ out.flush();
+ }
+ }
+ 
+ void handle_compile(LamiaOutputSink& out, const std::string& source_name, const std::string& source) {
+ auto start_time = std::chrono::steady_clock::now();
+ requests_++;
  
- result = std::regex_replace(result, amp, "&amp;");
- result = std::regex_replace(result, lt, "&lt;");
- result = std::regex_replace(result, gt, "&gt;");
+ std::unique_ptr<LamiaCompiler> compiler = checkout_compiler();
+ std::string key = compiler->compute_cache_key(source_name, source);
+ 
+ std::shared_ptr<const Outputs> outputs = lookup_result(key);
+ std::string error;
+ if (outputs) {
+ cache_hits_++;
+ } else {
+ cache_misses_++;
+ auto generated = std::make_shared<Outputs>();
+ if (compiler->compile_source(source, source_name, *generated)) {
+ outputs = generated;
+ store_result(key, outputs);
+ } else {
+ error = "Compilation failed";
+ for (const auto& message : compiler->get_stats().errors) {
+ error += "\n" + message;
+ }
+ }
+ }
+ checkin_compiler(std::move(compiler));
+ 
+ if (!outputs) {
+ write_error(out, error);
+ return;
+ }
+ 
+ auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+ out << "OK " << std::to_string(outputs->size()) << ' ' << std::to_string(elapsed.count()) << '\n';
+ for (const auto& output : *outputs) {
+ out << output.filename << ' ' << std::to_string(output.content.size()) << '\n' << output.content;
+ }
+ }
+ 
+ static void write_error(LamiaOutputSink& out, const std::string& message) {
+ out << "ERROR " << std::to_string(message.size()) << '\n' << message;
+ }
+ 
+ std::unique_ptr<LamiaCompiler> checkout_compiler() {
+ {
+ std::lock_guard<std::mutex> lock(compilers_mutex_);
+ if (!idle_compilers_.empty()) {
+ auto compiler = std::move(idle_compilers_.back());
+ idle_compilers_.pop_back();
+ return compiler;
+ }
+ }
+ return std::make_unique<LamiaCompiler>(config_);
+ }
+ 
+ void checkin_compiler(std::unique_ptr<LamiaCompiler> compiler) {
+ std::lock_guard<std::mutex> lock(compilers_mutex_);
+ idle_compilers_.push_back(std::move(compiler));
+ }
+ 
+ std::shared_ptr<const Outputs> lookup_result(const std::string& key) {
+ std::lock_guard<std::mutex> lock(results_mutex_);
+ auto it = result_index_.find(key);
+ if (it == result_index_.end()) {
+ return nullptr;
+ }
+ results_.splice(results_.begin(), results_, it->second);
+ return it->second->outputs;
+ }
  
- return result;
+ void store_result(const std::string& key, std::shared_ptr<const Outputs> outputs) {
+ size_t bytes = key.size();
+ for (const auto& output : *outputs) {
+ bytes += output.filename.size() + output.content.size();
+ }
+ if (bytes > RESULT_CACHE_BYTES) {
+ return;
+ }
+ 
+ std::lock_guard<std::mutex> lock(results_mutex_);
+ if (result_index_.count(key)) {
+ return; // Another worker compiled the same source concurrently
+ }
+ results_.push_front({key, std::move(outputs), bytes});
+ result_index_[key] = results_.begin();
+ result_bytes_ += bytes;
+ 
+ while (result_bytes_ > RESULT_CACHE_BYTES) {
+ result_bytes_ -= results_.back().bytes;
+ result_index_.erase(results_.back().key);
+ results_.pop_back();
+ }
  }
 };
 
@@ -823,13 +1301,38 @@ public:
  std::cout << "\"Shining\" - Optimized for AI & Human Collaboration" << std::endl;
  std::cout << "═══════════════════════════════════" << std::endl;
  
- if (argc < 2) {
- print_usage(argv[0]);
- return 1;
+ // Positional arguments plus --jobs N / -j N for batch mode, --serve PATH, --minify, --bytecode, --native, --wasm and --no-source-maps
+ std::vector<std::string> positional;
+ std::string serve_socket;
+ size_t jobs = 0;
+ bool minify = false;
+ bool bytecode = false;
+ bool native = false;
+ bool wasm = false;
+ bool source_maps = true;
+ for (int i = 1; i < argc; ++i) {
+ std::string arg = argv[i];
+ if (arg == "--minify") {
+ minify = true;
+ } else if (arg == "--bytecode") {
+ bytecode = true;
+ } else if (arg == "--native") {
+ native = true;
+ } else if (arg == "--wasm") {
+ wasm = true;
+ } else if (arg == "--no-source-maps") {
+ source_maps = false;
+ } else if (arg == "--serve" && i + 1 < argc) {
+ serve_socket = argv[++i];
+ } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+ jobs = std::strtoul(argv[++i], nullptr, 10);
+ if (jobs == 0) {
+ jobs = std::thread::hardware_concurrency();
+ }
+ } else {
+ positional.push_back(arg);
+ }
  }
- 
- std::string input_file = argv[1];
- std::string output_dir = argc > 2 ? argv[2] : "./output";
  
  // Create compiler with default configuration
  LamiaConfig config;
@@ -840,6 +1343,44 @@ public:
  LamiaTranspiler::Target::HTML5,
  LamiaTranspiler::Target::CSS3
  };
+ config.minify_output = minify;
+ config.generate_source_maps = source_maps;
+ config.generate_server_bytecode = bytecode;
+ if (wasm) {
+ config.additional_targets.push_back(LamiaTranspiler::Target::WEBASSEMBLY);
+ }
+ if (native) {
+ config.additional_targets.push_back(LamiaTranspiler::Target::MEDUSA_NATIVE);
+ config.build_native_executable = true;
+ if (const char* cxx = std::getenv("CXX"); cxx && *cxx) {
+ config.native_compiler = cxx;
+ }
+ }
+ 
+ if (!serve_socket.empty()) {
+ LamiaCompileServer server(config, serve_socket, jobs ? jobs : std::thread::hardware_concurrency());
+ return server.serve() ? 0 : 1;
+ }
+ 
+ if (positional.empty()) {
+ print_usage(argv[0]);
+ return 1;
+ }
+ 
+ std::string input_file = positional[0];
+ std::string output_dir = positional.size() > 1 ? positional[1] : "./output";
+ 
+ // Directories and manifests always go through the batch compiler
+ if (jobs > 0 || std::filesystem::is_directory(input_file) ||
+ std::filesystem::path(input_file).extension() != ".lamia") {
+ LamiaBatchCompiler batch(config, jobs ? jobs : std::thread::hardware_concurrency());
+ if (batch.compile_tree(input_file, output_dir)) {
+ std::cout << "\n🎉 Batch compilation completed successfully!" << std::endl;
+ return 0;
+ }
+ std::cout << "\n💥 Batch compilation failed!" << std::endl;
+ return 1;
+ }
  
  LamiaCompiler compiler(config);
  
@@ -858,18 +1399,35 @@ public:
  
 private:
  static void print_usage(const char* program_name) {
- std::cout << "\nUsage: " << program_name << " <input.lamia> [output_directory]" << std::endl;
+ std::cout << "\nUsage: " << program_name << " <input.lamia|directory|manifest> [output_directory] [--jobs N] [--minify] [--bytecode] [--native] [--wasm] [--no-source-maps]" << std::endl;
+ std::cout << " " << program_name << " --serve <socket_path> [--jobs N] [--minify]" << std::endl;
  std::cout << "\nOptions:" << std::endl;
  std::cout << " input.lamia Lamia source file to compile" << std::endl;
+ std::cout << " directory Compile every .lamia file in the tree" << std::endl;
+ std::cout << " manifest Text file listing sources or directories, one per line" << std::endl;
  std::cout << " output_directory Directory for generated files (default: ./output)" << std::endl;
+ std::cout << " --jobs N, -j N Parallel workers for batch and server mode (0: one per core)" << std::endl;
+ std::cout << " --serve PATH Run as a compile server on a Unix domain socket" << std::endl;
+ std::cout << " --minify Emit compact JS/HTML/CSS (no comments, layout or long local names)" << std::endl;
+ std::cout << " --bytecode Also emit server-side bytecode for the manifests (*.lbc)" << std::endl;
+ std::cout << " --native Also emit Medusa Native C++ and build it with $CXX (default c++)" << std::endl;
+ std::cout << " --wasm Also compile number and logic manifests to WebAssembly" << std::endl;
+ std::cout << " --no-source-maps Skip the *.map files, e.g. for production builds" << std::endl;
  std::cout << "\nExample:" << std::endl;
  std::cout << " " << program_name << " my_app.lamia ./dist" << std::endl;
+ std::cout << " " << program_name << " ./src ./dist --jobs 8" << std::endl;
+ std::cout << " " << program_name << " --serve /run/medusa/lamia.sock" << std::endl;
  std::cout << "\nGenerated files:" << std::endl;
  std::cout << " *.js JavaScript ES6 output" << std::endl;
  std::cout << " *.ts TypeScript output" << std::endl;
  std::cout << " *.html HTML5 output" << std::endl;
  std::cout << " *.css CSS3 output" << std::endl;
- std::cout << " *.cpp Medusa Native C++ output" << std::endl;
+ std::cout << " *.cpp Medusa Native C++ output (--native)" << std::endl;
+ std::cout << " <name> Native executable rendering the page (--native)" << std::endl;
+ std::cout << " *.lbc Server-side manifest bytecode (--bytecode)" << std::endl;
+ std::cout << " *.wasm WebAssembly module of the manifests (--wasm)" << std::endl;
+ std::cout << " *.wasm.js JavaScript that loads it, for the browser (--wasm)" << std::endl;
+ std::cout << " *.map Source maps back to the .lamia lines" << std::endl;
  std::cout << " *.purple.html Purple-Pages documentation" << std::endl;
  }
 };
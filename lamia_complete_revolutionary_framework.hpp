@@ -44,6 +44,7 @@
 
 #pragma once
 
+#include "lamia_extensible_architecture.hpp"
 #include "lamia_server_client_functions.hpp"
 #include "lamia_block_editor.hpp"
 #include "lamia_wysiwyg_editor.hpp"
@@ -0,0 +1,118 @@
+/**
+ * LAMIA EMITTER TEST v0.3.0c
+ * ==========================
+ *
+ * One LamiaEmitter walk over every channel must write what a walk per
+ * channel (to_javascript(), to_html(), to_css(), to_medusa_native())
+ * writes, for properties that are not literals: parameter reads,
+ * identifiers, arrays, calls, objects and child widgets. The script,
+ * style and native output for them is pinned here. Their HTML attributes
+ * are not: anything but a literal is written in script syntax without
+ * escaping, and a call writes nothing.
+ */
+
+#include "lamia_lexer.hpp"
+#include <iostream>
+#include <string>
+
+using namespace MedusaServ::Language::Lamia;
+
+static int failures = 0;
+
+static void check(bool passed, const std::string& what) {
+    std::cout << (passed ? "  ✅ " : "  ❌ ") << what << std::endl;
+    failures += passed ? 0 : 1;
+}
+
+static void check_output(const std::string& output, const std::string& expected, const std::string& what) {
+    check(output.find(expected) != std::string::npos, what);
+    if (output.find(expected) == std::string::npos) {
+        std::cout << "    expected:\n" << expected << "\n    in:\n" << output << std::endl;
+    }
+}
+
+static const char* const SOURCE =
+    "create PROFILE_CARD {\n"
+    "    name: display_name\n"
+    "    tags: [\"admin\", 2, true]\n"
+    "    width: compute_width(3, \"px\")\n"
+    "    style: { weight: \"bold\" }\n"
+    "    create RADIANT_TEXT { content: \"Hi\" }\n"
+    "}\n"
+    "manifest greet(user) {\n"
+    "    create RADIANT_TEXT { content: user }\n"
+    "    return_light format_name(user)\n"
+    "}\n"
+    "style_with \".card\" {\n"
+    "    padding: spacing\n"
+    "}\n";
+
+static void test_non_literal_properties() {
+    std::cout << "🔍 Non-literal properties" << std::endl;
+    std::string source = SOURCE;
+    LamiaLexer lexer(source);
+    lexer.set_verbose(false);
+    LamiaTokenStream tokens = lexer.tokenize();
+    LamiaAstArena arena;
+    LamiaParser parser(tokens, arena);
+    const LamiaExpression* program = parser.parse();
+    check(parser.get_errors().empty(), "parses without errors");
+
+    LamiaEmitter emitter(LamiaEmitter::ALL_CHANNELS);
+    emitter.emit(*program);
+    const auto& buffers = emitter.buffers();
+    check(buffers.javascript == program->to_javascript(), "JavaScript matches a JavaScript-only walk");
+    check(buffers.html == program->to_html(), "HTML matches an HTML-only walk");
+    check(buffers.css == program->to_css(), "CSS matches a CSS-only walk");
+    check(buffers.native == program->to_medusa_native(), "native matches a native-only walk");
+
+    check_output(buffers.javascript,
+                 "MedusaWidget.create('PROFILE_CARD', {\n"
+                 " theme: 'medusa-default',\n"
+                 " name: \"display_name\",\n"
+                 " style: \"weight: \\\"bold\\\"\",\n"
+                 " tags: [\"admin\", 2.000000, true],\n"
+                 " width: compute_width(3.000000, \"px\"),\n"
+                 " children: [\n"
+                 " MedusaWidget.create('RADIANT_TEXT', {\n"
+                 " theme: 'medusa-default',\n"
+                 " content: \"Hi\",\n"
+                 "}),\n"
+                 " ]\n"
+                 "})",
+                 "JavaScript: identifier, object, array, call and child");
+    check_output(buffers.javascript,
+                 "function greet(user) {\n"
+                 " MedusaWidget.create('RADIANT_TEXT', {\n"
+                 " theme: 'medusa-default',\n"
+                 " content: user,\n"
+                 "});\n"
+                 " return format_name(user);\n"
+                 "}",
+                 "JavaScript: a parameter is read, not quoted");
+    check_output(buffers.css, ".card {\n padding: \"spacing\";\n}", "CSS: an identifier value");
+    check_output(buffers.native,
+                 "MedusaNative::mount(MedusaNative::Widget(\"PROFILE_CARD\", \"medusa-default\", "
+                 "{{\"name\", MedusaNative::LamiaRadiant(\"display_name\")}, "
+                 "{\"style\", MedusaNative::LamiaRadiant(\"weight: \\\"bold\\\"\")}, "
+                 "{\"tags\", MedusaNative::LamiaConstellation({MedusaNative::LamiaRadiant(\"admin\"), "
+                 "MedusaNative::LamiaShimmer(2.000000), MedusaNative::LamiaLumina(true)})}, "
+                 "{\"width\", MedusaNative::call(\"compute_width\", {MedusaNative::LamiaShimmer(3.000000), "
+                 "MedusaNative::LamiaRadiant(\"px\")})}}, "
+                 "{MedusaNative::Widget(\"RADIANT_TEXT\", \"medusa-default\", {{\"content\", MedusaNative::LamiaRadiant(\"Hi\")}})}));",
+                 "native: the same properties");
+    check_output(buffers.native,
+                 " MedusaNative::mount(MedusaNative::Widget(\"RADIANT_TEXT\", \"medusa-default\", {{\"content\", user}}));\n"
+                 " return MedusaNative::call(\"format_name\", {user});",
+                 "native: a parameter is read, not quoted");
+}
+
+int main() {
+    std::cout << "🔮 Testing LamiaEmitter v0.3.0c" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    test_non_literal_properties();
+
+    std::cout << (failures ? "❌ " : "✅ ") << failures << " failed" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,330 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA INCREMENTAL PARSER v0.3.0c
+ * ================================
+ *
+ * Keeps a .lamia document parsed while it is being edited
+ * - The document is a run of blocks: whole lines holding one top-level
+ *   statement (manifest, create, style_with, directive) and the trivia
+ *   above it
+ * - Each block keeps its subtree, diagnostics and rendered output
+ * - An edit re-lexes and re-parses only the blocks it touches; every
+ *   other block keeps its subtree and its rendered output
+ *
+ * Neither the lexer nor the parser carries state from one top-level
+ * statement to the next, so the lines after an edited region lex and
+ * parse exactly as before and the region can be reparsed on its own.
+ * An edit that leaves the region open at its end (an unclosed '{',
+ * comment or string, or "@startup" waiting for its function) grows the
+ * region until it closes again.
+ */
+
+#pragma once
+
+#include "lamia_language_specification.hpp"
+#include "lamia_lexer.hpp"
+#include "lamia_simd_scan.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Incremental Document - Source text plus a block-wise parse of it
+ */
+class LamiaIncrementalDocument {
+public:
+ /**
+ * @brief Work done by one edit
+ */
+ struct EditStats {
+ size_t relexed_bytes = 0;
+ size_t blocks_reparsed = 0;
+ size_t blocks_reused = 0;
+ };
+
+private:
+ struct Block {
+ size_t length = 0; // Source bytes, through the closing newline
+ size_t newlines = 0; // Line breaks inside those bytes
+ std::shared_ptr<LamiaAstArena> arena; // Shared by the blocks of one reparse, with the text they were parsed from
+ const LamiaProgram* tree = nullptr;
+ std::vector<LamiaParser::Diagnostic> diagnostics; // Lines counted from the block's first line
+ LamiaEmitter::Buffers output;
+ bool rendered = false;
+ };
+
+ std::string text_;
+ std::vector<Block> blocks_;
+
+ // The whole-document tree borrows the blocks' subtrees
+ LamiaAstArena program_arena_;
+ const LamiaProgram* program_ = nullptr;
+
+public:
+ explicit LamiaIncrementalDocument(std::string_view text = {}) {
+ set_text(text);
+ }
+
+ LamiaIncrementalDocument(const LamiaIncrementalDocument&) = delete;
+ LamiaIncrementalDocument& operator=(const LamiaIncrementalDocument&) = delete;
+
+ /**
+ * @brief Replace the whole document (a full parse)
+ */
+ EditStats set_text(std::string_view text) {
+ return apply_edit(0, text_.size(), text);
+ }
+
+ /**
+ * @brief Replace deleted bytes at offset with inserted
+ *
+ * Offsets past the end are clamped to it. Lexing and parsing cost is
+ * proportional to the blocks the edit touches; locating them is one
+ * pass over the block list.
+ */
+ EditStats apply_edit(size_t offset, size_t deleted, std::string_view inserted) {
+ offset = std::min(offset, text_.size());
+ deleted = std::min(deleted, text_.size() - offset);
+
+ // Blocks end in a newline, so the edit cannot reach back into the block before offset
+ size_t first = 0, region_begin = 0;
+ while (first + 1 < blocks_.size() && region_begin + blocks_[first].length <= offset) {
+ region_begin += blocks_[first++].length;
+ }
+
+ // Through the block holding the first byte after the deleted range
+ size_t end = first, region_end = region_begin;
+ while (end < blocks_.size() && (end == first || region_end <= offset + deleted)) {
+ region_end += blocks_[end++].length;
+ }
+
+ text_.replace(offset, deleted, inserted);
+ region_end = region_end - deleted + inserted.size();
+
+ EditStats stats;
+ std::vector<Block> replacement;
+ while (true) {
+ stats.relexed_bytes += region_end - region_begin;
+ if (split_region(region_begin, region_end, replacement)) {
+ break;
+ }
+ // Still open at the boundary: at least double the region, so a long run stays linear
+ size_t target = 2 * (region_end - region_begin);
+ do {
+ region_end += blocks_[end++].length;
+ } while (end < blocks_.size() && region_end - region_begin < target);
+ }
+
+ stats.blocks_reparsed = replacement.size();
+ stats.blocks_reused = blocks_.size() - (end - first);
+ blocks_.erase(blocks_.begin() + first, blocks_.begin() + end);
+ blocks_.insert(blocks_.begin() + first, std::make_move_iterator(replacement.begin()),
+ std::make_move_iterator(replacement.end()));
+ program_ = nullptr;
+ return stats;
+ }
+
+ const std::string& text() const { return text_; }
+ size_t block_count() const { return blocks_.size(); }
+
+ /**
+ * @brief Whole-document tree, assembled from the block subtrees
+ *
+ * Valid until the next edit.
+ */
+ const LamiaProgram& program() {
+ if (!program_) {
+ program_arena_.reset();
+ auto* program = program_arena_.create<LamiaProgram>();
+ for (const auto& block : blocks_) {
+ for (const auto* declaration : block.tree->declarations()) {
+ program->add_declaration(program_arena_, declaration);
+ }
+ }
+ program_ = program;
+ }
+ return *program_;
+ }
+
+ /**
+ * @brief Emit one channel, rendering only blocks that changed since the last call
+ *
+ * Matches emitting program() in one pass: declarations are joined by a
+ * blank line on every web channel. Native C++ is one translation unit
+ * (declarations, definitions, then the page), so it is always emitted
+ * from program() whole.
+ */
+ std::string render(LamiaEmitter::Channel channel) {
+ if (channel == LamiaEmitter::NATIVE) {
+ LamiaEmitter emitter(LamiaEmitter::NATIVE);
+ emitter.emit(program());
+ return std::move(emitter.buffers().native);
+ }
+ 
+ std::string result;
+ bool first = true;
+ for (auto& block : blocks_) {
+ if (block.tree->declarations().empty()) {
+ continue;
+ }
+ if (!block.rendered) {
+ LamiaEmitter emitter(LamiaEmitter::WEB_CHANNELS);
+ emitter.emit(*block.tree);
+ block.output = std::move(emitter.buffers());
+ block.rendered = true;
+ }
+ if (!first) {
+ result += "\n\n";
+ }
+ result += channel_output(block.output, channel);
+ first = false;
+ }
+ return result;
+ }
+
+ /**
+ * @brief Syntax errors of the whole document, formatted as the parser does
+ */
+ std::vector<std::string> errors() const {
+ std::vector<std::string> errors;
+ size_t line = 1;
+ for (const auto& block : blocks_) {
+ for (auto diagnostic : block.diagnostics) {
+ if (diagnostic.line) {
+ diagnostic.line += line - 1;
+ }
+ errors.push_back(diagnostic.to_string());
+ }
+ line += block.newlines;
+ }
+ return errors;
+ }
+
+private:
+ /**
+ * @brief Lex and parse [begin, end), cutting it into blocks
+ * @return false when the region is still open at end (nothing is cut)
+ */
+ bool split_region(size_t begin, size_t end, std::vector<Block>& blocks) {
+ blocks.clear();
+
+ // Reused blocks outlive text_'s buffer: lex a copy their arena owns, so
+ // no view in the subtrees (source_location included) points into text_
+ auto arena = std::make_shared<LamiaAstArena>();
+ char* copy = arena->allocate_array<char>(end - begin);
+ std::memcpy(copy, text_.data() + begin, end - begin);
+ std::string_view region(copy, end - begin);
+
+ LamiaLexer lexer(region);
+ lexer.set_verbose(false);
+ LamiaTokenStream tokens = lexer.tokenize();
+
+ LamiaParser parser(tokens, *arena);
+ parser.parse();
+ const auto& statements = parser.get_statements();
+
+ if (end < text_.size() && (tokens.empty() || tokens[tokens.size() - 1].type != LamiaToken::Type::NEWLINE ||
+ (!statements.empty() && statements.back().end >= tokens.size()) || has_open_comment(tokens))) {
+ return false;
+ }
+
+ // Cut after the line on which a statement ends, unless the next statement starts on it
+ size_t block_begin = 0;
+ auto statement = statements.begin();
+ while (block_begin < tokens.size()) {
+ auto last = statement;
+ size_t cut = tokens.size(); // No statements left: trailing blank lines and comments
+ for (; statement != statements.end(); ++statement) {
+ cut = statement->end;
+ while (cut < tokens.size() && tokens[cut].type != LamiaToken::Type::NEWLINE) {
+ ++cut;
+ }
+ cut = std::min(cut + 1, tokens.size());
+ if (statement + 1 == statements.end() || (statement + 1)->begin >= cut) {
+ ++statement;
+ break;
+ }
+ }
+
+ Block block;
+ block.arena = arena;
+ auto* tree = arena->create<LamiaProgram>();
+ for (; last != statement; ++last) {
+ if (last->declaration) {
+ tree->add_declaration(*arena, last->declaration);
+ }
+ }
+ block.tree = tree;
+
+ size_t from = tokens[block_begin].position;
+ size_t to = cut < tokens.size() ? tokens[cut].position : region.size();
+ block.length = to - from;
+ block.newlines = LamiaScan::count_newlines(region.data() + from, region.data() + to, nullptr);
+ block.diagnostics = diagnostics_between(parser.get_diagnostics(), tokens[block_begin].line,
+ cut < tokens.size() ? tokens[cut].line : 0);
+ blocks.push_back(std::move(block));
+ block_begin = cut;
+ }
+ return true;
+ }
+
+ /**
+ * @brief Diagnostics on lines [first_line, end_line) - end_line 0 means to the end -
+ *        renumbered from the block's first line
+ */
+ static std::vector<LamiaParser::Diagnostic> diagnostics_between(const std::vector<LamiaParser::Diagnostic>& diagnostics,
+ size_t first_line, size_t end_line) {
+ std::vector<LamiaParser::Diagnostic> selected;
+ for (const auto& diagnostic : diagnostics) {
+ if (diagnostic.line == 0 ? end_line == 0 :
+ diagnostic.line >= first_line && (end_line == 0 || diagnostic.line < end_line)) {
+ selected.push_back(diagnostic);
+ if (selected.back().line) {
+ selected.back().line -= first_line - 1;
+ }
+ }
+ }
+ return selected;
+ }
+
+ /**
+ * @brief An unterminated block comment swallows everything after the region too
+ */
+ static bool has_open_comment(const LamiaTokenStream& tokens) {
+ for (size_t i = tokens.size(); i-- > 0 && i + 2 >= tokens.size();) {
+ std::string_view value = tokens[i].value;
+ if (tokens[i].type == LamiaToken::Type::COMMENT && value.substr(0, 2) == "/*" &&
+ (value.size() < 4 || value.substr(value.size() - 2) != "*/")) {
+ return true;
+ }
+ }
+ return false;
+ }
+
+ static const std::string& channel_output(const LamiaEmitter::Buffers& output, LamiaEmitter::Channel channel) {
+ switch (channel) {
+ case LamiaEmitter::HTML:
+ return output.html;
+ case LamiaEmitter::CSS:
+ return output.css;
+ case LamiaEmitter::NATIVE:
+ return output.native;
+ default:
+ return output.javascript;
+ }
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
@@ -0,0 +1,75 @@
+/**
+ * LAMIA INCREMENTAL PARSER TEST v0.3.0c
+ * =====================================
+ *
+ * Blocks an edit does not touch keep their subtrees while the document's
+ * text is reallocated under them; rendering must match a full parse.
+ * Run it under AddressSanitizer (-fsanitize=address) to catch a subtree
+ * that still points into the old text.
+ */
+
+#include "lamia_incremental_parser.hpp"
+#include <iostream>
+#include <string>
+
+using namespace MedusaServ::Language::Lamia;
+
+static int failures = 0;
+
+static void check(bool passed, const std::string& what) {
+    std::cout << (passed ? "  ✅ " : "  ❌ ") << what << std::endl;
+    failures += passed ? 0 : 1;
+}
+
+static std::string full_render(const std::string& text, LamiaEmitter::Channel channel) {
+    LamiaLexer lexer(text);
+    lexer.set_verbose(false);
+    LamiaTokenStream tokens = lexer.tokenize();
+    LamiaAstArena arena;
+    LamiaParser parser(tokens, arena);
+    const LamiaExpression* program = parser.parse();
+    LamiaEmitter emitter(channel);
+    emitter.emit(*program);
+    auto& buffers = emitter.buffers();
+    switch (channel) {
+        case LamiaEmitter::HTML: return buffers.html;
+        case LamiaEmitter::CSS: return buffers.css;
+        case LamiaEmitter::NATIVE: return buffers.native;
+        default: return buffers.javascript;
+    }
+}
+
+static void test_reused_blocks_survive_reallocation() {
+    std::cout << "🔍 Reused blocks after the text moves" << std::endl;
+    LamiaIncrementalDocument document(
+        "@render {\n    <div class=\"card\">Hello</div>\n}\n"
+        "create RADIANT_HEADING {\n    content: \"Title\"\n    size: 24\n}\n"
+        "style_with \".card\" {\n    border-radius: 8px\n}\n"
+        "@plugin_metadata {\n    @name \"demo\" priority=high\n}\n");
+    check(document.errors().empty(), "the document parses");
+
+    std::string padding = "\n";
+    for (int i = 0; i < 2000; ++i) {
+        padding += "create PANEL { title: \"Panel " + std::to_string(i) + "\" }\n";
+    }
+    auto stats = document.apply_edit(document.text().size(), 0, padding); // About 100KB: the text reallocates
+    check(stats.blocks_reused == 3, "the blocks before the edit are reused (" + std::to_string(stats.blocks_reused) + ")");
+
+    const auto& declarations = document.program().declarations();
+    check(!declarations.empty() && declarations[0]->source_location == "@", "reused subtrees still read their source text");
+
+    for (auto channel : {LamiaEmitter::NATIVE, LamiaEmitter::JAVASCRIPT, LamiaEmitter::HTML, LamiaEmitter::CSS}) {
+        check(document.render(channel) == full_render(document.text(), channel),
+              "channel " + std::to_string(channel) + " matches a full parse");
+    }
+}
+
+int main() {
+    std::cout << "🔮 Testing LamiaIncrementalDocument v0.3.0c" << std::endl;
+    std::cout << "===========================================" << std::endl;
+
+    test_reused_blocks_survive_reallocation();
+
+    std::cout << (failures ? "❌ " : "✅ ") << failures << " failed" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA KEYWORDS v0.3.0c
+ * ======================
+ *
+ * Reserved words and operators of the Lamia Language
+ * - LamiaKeywords names every reserved word
+ * - LamiaLexicon classifies candidate tokens through perfect-hash tables
+ *   built at compile time: one table probe and one compare, no allocation
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Syntax Elements - AI-optimized keywords
+ */
+struct LamiaKeywords {
+ // Declaration Keywords - Natural language inspired
+ static constexpr const char* CREATE = "create"; // Variable declaration
+ static constexpr const char* BECOME = "become"; // Assignment
+ static constexpr const char* INVOKE = "invoke"; // Function call
+ static constexpr const char* SUMMON = "summon"; // Import/require
+ 
+ // Control Flow - Intuitive semantics
+ static constexpr const char* WHEN = "when"; // If statement
+ static constexpr const char* OTHERWISE = "otherwise"; // Else statement
+ static constexpr const char* WHILE_SHINING = "while_shining"; // While loop
+ static constexpr const char* FOR_EACH_STAR = "for_each_star"; // For loop
+ static constexpr const char* UNTIL_DARK = "until_dark"; // Do-while loop
+ 
+ // Function Keywords - AI-friendly semantics
+ static constexpr const char* MANIFEST = "manifest"; // Function definition
+ static constexpr const char* RETURN_LIGHT = "return_light"; // Return statement
+ static constexpr const char* YIELD_RADIANCE = "yield_radiance"; // Yield
+ 
+ // Class/Object Keywords - Visual metaphors
+ static constexpr const char* BLUEPRINT = "blueprint"; // Class definition
+ static constexpr const char* INHERIT_ESSENCE = "inherit_essence"; // Inheritance
+ static constexpr const char* IMPLEMENT_FACET = "implement_facet"; // Interface impl
+ 
+ // Async Keywords - Dynamic semantics
+ static constexpr const char* AWAIT_DAWN = "await_dawn"; // Await
+ static constexpr const char* PROMISE_LIGHT = "promise_light"; // Promise
+ static constexpr const char* EMIT_SIGNAL = "emit_signal"; // Emit/Event
+ 
+ // Widget-specific Keywords
+ static constexpr const char* RENDER_BEAUTY = "render_beauty"; // Render UI
+ static constexpr const char* STYLE_WITH = "style_with"; // Apply styling
+ static constexpr const char* BIND_DATA = "bind_data"; // Data binding
+ static constexpr const char* HANDLE_TOUCH = "handle_touch"; // Event handling
+};
+
+/**
+ * @brief Compile-time perfect hash set over a fixed word list
+ *
+ * The constructor searches for a seed that maps every word to its own
+ * slot. The hash samples the length and the first, middle and last
+ * characters, so probing costs the same for any word length. A word list
+ * that admits no seed fails to compile.
+ */
+template<size_t N, size_t SLOTS>
+class LamiaPerfectHashSet {
+private:
+ static_assert(SLOTS && (SLOTS & (SLOTS - 1)) == 0, "Slot count must be a power of two");
+ static_assert(N < SLOTS && N < 256, "Word list too large for the table");
+
+ std::string_view words_[N];
+ uint8_t slots_[SLOTS]; // Word index + 1, 0 for an empty slot
+ uint32_t seed_ = 0;
+ size_t min_length_ = SIZE_MAX;
+ size_t max_length_ = 0;
+
+public:
+ constexpr explicit LamiaPerfectHashSet(const std::string_view (&words)[N]) : words_{}, slots_{} {
+ for (size_t i = 0; i < N; ++i) {
+ words_[i] = words[i];
+ min_length_ = words[i].size() < min_length_ ? words[i].size() : min_length_;
+ max_length_ = words[i].size() > max_length_ ? words[i].size() : max_length_;
+ }
+ for (uint32_t seed = 1; seed < 1000000; ++seed) {
+ if (try_seed(seed)) {
+ seed_ = seed;
+ return;
+ }
+ }
+ throw std::logic_error("No perfect hash seed for word list"); // Compile error in constant evaluation
+ }
+
+ constexpr bool contains(std::string_view word) const {
+ if (word.size() < min_length_ || word.size() > max_length_) {
+ return false;
+ }
+ uint8_t entry = slots_[hash(word, seed_) & (SLOTS - 1)];
+ return entry != 0 && words_[entry - 1] == word;
+ }
+
+ constexpr size_t size() const { return N; }
+
+private:
+ static constexpr uint32_t hash(std::string_view word, uint32_t seed) {
+ uint32_t h = seed ^ (static_cast<uint32_t>(word.size()) * 0x9E3779B1u);
+ h = (h ^ static_cast<uint8_t>(word[0])) * 0x01000193u;
+ h = (h ^ static_cast<uint8_t>(word[word.size() / 2])) * 0x01000193u;
+ h = (h ^ static_cast<uint8_t>(word[word.size() - 1])) * 0x01000193u;
+ return h ^ (h >> 15);
+ }
+
+ constexpr bool try_seed(uint32_t seed) {
+ for (size_t i = 0; i < SLOTS; ++i) {
+ slots_[i] = 0;
+ }
+ for (size_t i = 0; i < N; ++i) {
+ size_t slot = hash(words_[i], seed) & (SLOTS - 1);
+ if (slots_[slot] != 0) {
+ return false;
+ }
+ slots_[slot] = static_cast<uint8_t>(i + 1);
+ }
+ return true;
+ }
+};
+
+/**
+ * @brief Lamia Lexicon - Token classification tables for the lexer
+ */
+struct LamiaLexicon {
+ static constexpr std::string_view KEYWORD_LIST[] = {
+ // Declaration keywords
+ LamiaKeywords::CREATE, LamiaKeywords::BECOME, LamiaKeywords::INVOKE, LamiaKeywords::SUMMON,
+
+ // Control flow
+ LamiaKeywords::WHEN, LamiaKeywords::OTHERWISE, LamiaKeywords::WHILE_SHINING,
+ LamiaKeywords::FOR_EACH_STAR, LamiaKeywords::UNTIL_DARK,
+
+ // Function keywords
+ LamiaKeywords::MANIFEST, LamiaKeywords::RETURN_LIGHT, LamiaKeywords::YIELD_RADIANCE,
+
+ // Class/Object keywords
+ LamiaKeywords::BLUEPRINT, LamiaKeywords::INHERIT_ESSENCE, LamiaKeywords::IMPLEMENT_FACET,
+
+ // Async keywords
+ LamiaKeywords::AWAIT_DAWN, LamiaKeywords::PROMISE_LIGHT, LamiaKeywords::EMIT_SIGNAL,
+
+ // Widget keywords
+ LamiaKeywords::RENDER_BEAUTY, LamiaKeywords::STYLE_WITH, LamiaKeywords::BIND_DATA, LamiaKeywords::HANDLE_TOUCH,
+
+ // Type keywords
+ "radiant", "shimmer", "lumina", "void_star",
+ "constellation", "nebula", "galaxy", "prism",
+ "crystal", "aurora", "widget", "theme", "vault", "portal"
+ };
+
+ static constexpr std::string_view TWO_CHAR_OPERATOR_LIST[] = {
+ "==", "!=", "<=", ">=", "&&", "||", "++", "--",
+ "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=",
+ "<<", ">>", "->", "~>", "<*", "**"
+ };
+
+ static constexpr std::string_view THREE_CHAR_OPERATOR_LIST[] = {
+ "<~>", "**>", "<<<", ">>>"
+ };
+
+ static constexpr LamiaPerfectHashSet<std::size(KEYWORD_LIST), 128> KEYWORDS{KEYWORD_LIST};
+ static constexpr LamiaPerfectHashSet<std::size(TWO_CHAR_OPERATOR_LIST), 64> TWO_CHAR_OPERATORS{TWO_CHAR_OPERATOR_LIST};
+ static constexpr LamiaPerfectHashSet<std::size(THREE_CHAR_OPERATOR_LIST), 16> THREE_CHAR_OPERATORS{THREE_CHAR_OPERATOR_LIST};
+
+ static constexpr bool is_keyword(std::string_view word) { return KEYWORDS.contains(word); }
+ static constexpr bool is_two_char_operator(std::string_view op) { return TWO_CHAR_OPERATORS.contains(op); }
+ static constexpr bool is_three_char_operator(std::string_view op) { return THREE_CHAR_OPERATORS.contains(op); }
+};
+
+static_assert(LamiaLexicon::is_keyword("manifest") && !LamiaLexicon::is_keyword("manifests"), "Keyword table is inconsistent");
+static_assert(LamiaLexicon::is_two_char_operator("->") && !LamiaLexicon::is_two_char_operator("=>"), "Operator table is inconsistent");
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
@@ -23,12 +23,23 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <deque>
+#include <algorithm>
 #include <map>
+#include <set>
 #include <memory>
 #include <variant>
 #include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
 #include "medusa_architecture_core.hpp"
+#include "lamia_ast_arena.hpp"
+#include "lamia_keywords.hpp"
+#include "lamia_output_sink.hpp"
+#include "lamia_wasm.hpp"
 
 namespace MedusaServ {
 namespace Language {
@@ -61,45 +72,6 @@ enum class LamiaType {
  PORTAL // Network/API type
 };
 
-/**
- * @brief Lamia Syntax Elements - AI-optimized keywords
- */
-struct LamiaKeywords {
- // Declaration Keywords - Natural language inspired
- static constexpr const char* CREATE = "create"; // Variable declaration
- static constexpr const char* BECOME = "become"; // Assignment
- static constexpr const char* INVOKE = "invoke"; // Function call
- static constexpr const char* SUMMON = "summon"; // Import/require
- 
- // Control Flow - Intuitive semantics
- static constexpr const char* WHEN = "when"; // If statement
- static constexpr const char* OTHERWISE = "otherwise"; // Else statement
- static constexpr const char* WHILE_SHINING = "while_shining"; // While loop
- static constexpr const char* FOR_EACH_STAR = "for_each_star"; // For loop
- static constexpr const char* UNTIL_DARK = "until_dark"; // Do-while loop
- 
- // Function Keywords - AI-friendly semantics
- static constexpr const char* MANIFEST = "manifest"; // Function definition
- static constexpr const char* RETURN_LIGHT = "return_light"; // Return statement
- static constexpr const char* YIELD_RADIANCE = "yield_radiance"; // Yield
- 
- // Class/Object Keywords - Visual metaphors
- static constexpr const char* BLUEPRINT = "blueprint"; // Class definition
- static constexpr const char* INHERIT_ESSENCE = "inherit_essence"; // Inheritance
- static constexpr const char* IMPLEMENT_FACET = "implement_facet"; // Interface impl
- 
- // Async Keywords - Dynamic semantics
- static constexpr const char* AWAIT_DAWN = "await_dawn"; // Await
- static constexpr const char* PROMISE_LIGHT = "promise_light"; // Promise
- static constexpr const char* EMIT_SIGNAL = "emit_signal"; // Emit/Event
- 
- // Widget-specific Keywords
- static constexpr const char* RENDER_BEAUTY = "render_beauty"; // Render UI
- static constexpr const char* STYLE_WITH = "style_with"; // Apply styling
- static constexpr const char* BIND_DATA = "bind_data"; // Data binding
- static constexpr const char* HANDLE_TOUCH = "handle_touch"; // Event handling
-};
-
 /**
  * @brief Lamia Social Media Protocols - Revolutionary social ecosystem integration
  */
@@ -334,28 +306,109 @@ struct LamiaOperators {
 
 /**
  * @brief Lamia Token - Basic lexical unit
+ *
+ * Tokens do not own their text: value is a view into the source buffer
+ * held by the LamiaTokenStream, and the semantic hint is an id into the
+ * stream's LamiaHintTable. Lexing therefore allocates nothing per token.
  */
 struct LamiaToken {
  enum class Type {
- KEYWORD, IDENTIFIER, LITERAL, OPERATOR, 
+ KEYWORD, IDENTIFIER, LITERAL, OPERATOR,
  PUNCTUATION, COMMENT, WHITESPACE, NEWLINE,
  STRING_INTERPOLATION, TEMPLATE_LITERAL
  };
- 
- Type type;
- std::string value;
- size_t line;
- size_t column;
- size_t position;
- 
+
+ Type type = Type::IDENTIFIER;
+ std::string_view value; // View into LamiaTokenStream::source
+ size_t line = 0;
+ size_t column = 0;
+ size_t position = 0;
+
  // AI-friendly metadata
- std::string semantic_hint; // For AI code completion
+ uint16_t hint_id = 0; // Interned hint for AI code completion
  bool is_ai_generated = false; // Track AI vs human authorship
  double confidence_score = 1.0; // AI confidence in token
 };
 
+/**
+ * @brief Lamia Hint Table - Interned semantic hints shared by a token stream
+ */
+class LamiaHintTable {
+private:
+ std::deque<std::string> hints_{std::string()}; // Id 0 is the empty hint
+ std::map<std::string, uint16_t, std::less<>> index_;
+
+public:
+ uint16_t intern(std::string_view hint) {
+ auto it = index_.find(hint);
+ if (it != index_.end()) {
+ return it->second;
+ }
+
+ uint16_t id = static_cast<uint16_t>(hints_.size());
+ hints_.emplace_back(hint);
+ index_.emplace(std::string(hint), id);
+ return id;
+ }
+
+ std::string_view lookup(uint16_t id) const {
+ return id < hints_.size() ? std::string_view(hints_[id]) : std::string_view();
+ }
+};
+
+/**
+ * @brief Lamia Token Stream - Lexer output consumed by parser and transpilers
+ *
+ * The source buffer is borrowed, not copied: it must outlive the stream.
+ */
+struct LamiaTokenStream {
+ std::string_view source;
+ std::vector<LamiaToken> tokens;
+ LamiaHintTable hints;
+
+ size_t size() const { return tokens.size(); }
+ bool empty() const { return tokens.empty(); }
+ const LamiaToken& operator[](size_t index) const { return tokens[index]; }
+ std::vector<LamiaToken>::const_iterator begin() const { return tokens.begin(); }
+ std::vector<LamiaToken>::const_iterator end() const { return tokens.end(); }
+
+ std::string_view semantic_hint(const LamiaToken& token) const {
+ return hints.lookup(token.hint_id);
+ }
+};
+
+class WidgetExpression;
+class LamiaLiteral;
+class LamiaFunction;
+class LamiaStyle;
+class LamiaCall;
+class LamiaReturn;
+class LamiaArray;
+class LamiaProgram;
+
+/**
+ * @brief Lamia Expression Visitor - Dispatch point for AST walks
+ */
+class LamiaExpressionVisitor {
+public:
+ virtual ~LamiaExpressionVisitor() = default;
+ virtual void visit(const WidgetExpression& node) = 0;
+ virtual void visit(const LamiaLiteral& node) = 0;
+ virtual void visit(const LamiaFunction& node) = 0;
+ virtual void visit(const LamiaStyle& node) = 0;
+ virtual void visit(const LamiaCall& node) = 0;
+ virtual void visit(const LamiaReturn& node) = 0;
+ virtual void visit(const LamiaArray& node) = 0;
+ virtual void visit(const LamiaProgram& node) = 0;
+};
+
 /**
  * @brief Lamia Expression - AST Node base
+ *
+ * Nodes are allocated in a per-compilation LamiaAstArena and never deleted
+ * individually, so every member is a view, a flat arena array or a scalar.
+ * Code generation lives in LamiaEmitter; the to_*() helpers render a single
+ * target through it.
  */
 class LamiaExpression {
 public:
@@ -363,23 +416,28 @@ public:
  LITERAL, IDENTIFIER, BINARY_OP, UNARY_OP,
  FUNCTION_CALL, WIDGET_CREATION, STYLE_APPLICATION,
  DATA_BINDING, EVENT_HANDLING, CONDITIONAL,
- LOOP, FUNCTION_DEF, CLASS_DEF, IMPORT
+ LOOP, FUNCTION_DEF, CLASS_DEF, IMPORT,
+ RETURN, PROGRAM
  };
  
  NodeType type;
  LamiaType data_type;
- std::string source_location;
+ std::string_view source_location;
  
  // AI assistance metadata
  bool requires_ai_completion = false;
- std::vector<std::string> ai_suggestions;
- std::string human_intent_description;
- 
- virtual ~LamiaExpression() = default;
- virtual std::string to_javascript() const = 0;
- virtual std::string to_html() const = 0;
- virtual std::string to_css() const = 0;
- virtual std::string to_medusa_native() const = 0;
+ LamiaArenaVector<std::string_view> ai_suggestions;
+ std::string_view human_intent_description;
+ 
+ virtual void accept(LamiaExpressionVisitor& visitor) const = 0;
+ 
+ std::string to_javascript() const;
+ std::string to_html() const;
+ std::string to_css() const;
+ std::string to_medusa_native() const;
+ 
+protected:
+ ~LamiaExpression() = default; // Arena-owned: never deleted through the base
 };
 
 /**
@@ -387,522 +445,2377 @@ public:
  */
 class WidgetExpression : public LamiaExpression {
 private:
- std::string widget_name_;
- std::map<std::string, std::shared_ptr<LamiaExpression>> properties_;
- std::vector<std::shared_ptr<LamiaExpression>> children_;
- std::string theme_name_;
+ std::string_view widget_name_;
+ LamiaPropertyList<const LamiaExpression*> properties_;
+ LamiaArenaVector<const LamiaExpression*> children_;
+ std::string_view theme_name_;
  
 public:
- WidgetExpression(const std::string& name, const std::string& theme = "medusa-default")
+ WidgetExpression(std::string_view name, std::string_view theme = "medusa-default")
  : widget_name_(name), theme_name_(theme) {
  type = NodeType::WIDGET_CREATION;
  data_type = LamiaType::WIDGET;
  }
  
- void add_property(const std::string& key, std::shared_ptr<LamiaExpression> value) {
- properties_[key] = value;
- }
- 
- void add_child(std::shared_ptr<LamiaExpression> child) {
- children_.push_back(child);
- }
- 
- std::string to_javascript() const override {
- std::string js = "MedusaWidget.create('" + widget_name_ + "', {\n";
- js += " theme: '" + theme_name_ + "',\n";
- 
- for (const auto& [key, value] : properties_) {
- js += " " + key + ": " + value->to_javascript() + ",\n";
- }
- 
- if (!children_.empty()) {
- js += " children: [\n";
- for (const auto& child : children_) {
- js += " " + child->to_javascript() + ",\n";
- }
- js += " ]\n";
- }
- 
- js += "})";
- return js;
- }
- 
- std::string to_html() const override {
- std::string html = "<medusa-" + widget_name_ + " theme=\"" + theme_name_ + "\"";
- 
- for (const auto& [key, value] : properties_) {
- html += " " + key + "=\"" + value->to_html() + "\"";
- }
- 
- if (children_.empty()) {
- html += " />";
- } else {
- html += ">\n";
- for (const auto& child : children_) {
- html += " " + child->to_html() + "\n";
- }
- html += "</medusa-" + widget_name_ + ">";
- }
- 
- return html;
+ void add_property(LamiaAstArena& arena, std::string_view key, const LamiaExpression* value) {
+ properties_.set(arena, key, value);
  }
  
- std::string to_css() const override {
- return "medusa-" + widget_name_ + "[theme=\"" + theme_name_ + "\"] { /* Generated styling */ }";
+ void add_child(LamiaAstArena& arena, const LamiaExpression* child) {
+ children_.push_back(arena, child);
  }
  
- std::string to_medusa_native() const override {
- std::string native = "MedusaNative::" + widget_name_ + "_widget widget;\n";
- native += "widget.set_theme(\"" + theme_name_ + "\");\n";
- 
- for (const auto& [key, value] : properties_) {
- native += "widget.set_property(\"" + key + "\", " + value->to_medusa_native() + ");\n";
- }
+ std::string_view name() const { return widget_name_; }
+ std::string_view theme() const { return theme_name_; }
+ const LamiaPropertyList<const LamiaExpression*>& properties() const { return properties_; }
+ const LamiaArenaVector<const LamiaExpression*>& children() const { return children_; }
  
- return native;
- }
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
 };
 
 /**
  * @brief Lamia Literal - Primitive values
  */
 class LamiaLiteral : public LamiaExpression {
+public:
+ using Value = std::variant<std::string_view, double, bool, std::nullptr_t>;
+ 
 private:
- std::variant<std::string, double, bool, std::nullptr_t> value_;
+ Value value_;
  
 public:
+ bool verbatim = false; // Text taken as written (a raw directive body), not the inside of a Lamia string
+ 
  template<typename T>
  LamiaLiteral(T value) : value_(value) {
  type = NodeType::LITERAL;
  
- if constexpr (std::is_same_v<T, std::string>) {
+ if constexpr (std::is_convertible_v<T, std::string_view>) {
  data_type = LamiaType::RADIANT;
- } else if constexpr (std::is_arithmetic_v<T>) {
- data_type = LamiaType::SHIMMER;
  } else if constexpr (std::is_same_v<T, bool>) {
  data_type = LamiaType::LUMINA;
+ } else if constexpr (std::is_arithmetic_v<T>) {
+ data_type = LamiaType::SHIMMER;
  } else {
  data_type = LamiaType::VOID_STAR;
  }
  }
  
- std::string to_javascript() const override {
- return std::visit([](const auto& v) -> std::string {
- using T = std::decay_t<decltype(v)>;
- if constexpr (std::is_same_v<T, std::string>) {
- return "\"" + v + "\"";
- } else if constexpr (std::is_same_v<T, double>) {
- return std::to_string(v);
- } else if constexpr (std::is_same_v<T, bool>) {
- return v ? "true" : "false";
- } else {
- return "null";
- }
- }, value_);
- }
- 
- std::string to_html() const override {
- return to_javascript(); // HTML attributes use similar syntax
- }
+ const Value& value() const { return value_; }
  
- std::string to_css() const override {
- return to_javascript(); // CSS values use similar syntax
- }
- 
- std::string to_medusa_native() const override {
- return std::visit([](const auto& v) -> std::string {
- using T = std::decay_t<decltype(v)>;
- if constexpr (std::is_same_v<T, std::string>) {
- return "LamiaRadiant(\"" + v + "\")";
- } else if constexpr (std::is_same_v<T, double>) {
- return "LamiaShimmer(" + std::to_string(v) + ")";
- } else if constexpr (std::is_same_v<T, bool>) {
- return std::string("LamiaLumina(") + (v ? "true" : "false") + ")";
- } else {
- return "LamiaVoidStar()";
- }
- }, value_);
- }
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
 };
 
 /**
  * @brief Lamia Function - AI-optimized function definition
  */
 class LamiaFunction : public LamiaExpression {
+public:
+ struct Parameter {
+ std::string_view name;
+ LamiaType type;
+ };
+ 
 private:
- std::string name_;
- std::vector<std::pair<std::string, LamiaType>> parameters_;
- std::vector<std::shared_ptr<LamiaExpression>> body_;
+ std::string_view name_;
+ LamiaArenaVector<Parameter> parameters_;
+ LamiaArenaVector<const LamiaExpression*> body_;
  LamiaType return_type_;
  
  // AI assistance features
- std::string ai_intent_description_;
- std::vector<std::string> auto_generated_tests_;
+ std::string_view ai_intent_description_;
+ LamiaArenaVector<std::string_view> auto_generated_tests_;
  bool is_ai_suggested_ = false;
  
 public:
- LamiaFunction(const std::string& name, LamiaType return_type = LamiaType::VOID_STAR)
+ LamiaFunction(std::string_view name, LamiaType return_type = LamiaType::VOID_STAR)
  : name_(name), return_type_(return_type) {
  type = NodeType::FUNCTION_DEF;
  data_type = LamiaType::GALAXY;
  }
  
- void add_parameter(const std::string& name, LamiaType type) {
- parameters_.emplace_back(name, type);
+ void add_parameter(LamiaAstArena& arena, std::string_view name, LamiaType type) {
+ parameters_.push_back(arena, {arena.intern(name), type});
  }
  
- void add_statement(std::shared_ptr<LamiaExpression> stmt) {
- body_.push_back(stmt);
+ void add_statement(LamiaAstArena& arena, const LamiaExpression* stmt) {
+ body_.push_back(arena, stmt);
  }
  
- void set_ai_intent(const std::string& intent) {
- ai_intent_description_ = intent;
+ void set_ai_intent(LamiaAstArena& arena, std::string_view intent) {
+ ai_intent_description_ = arena.intern(intent);
  requires_ai_completion = true;
  }
  
- std::string to_javascript() const override {
- std::string js = "function " + name_ + "(";
- 
- for (size_t i = 0; i < parameters_.size(); ++i) {
- if (i > 0) js += ", ";
- js += parameters_[i].first;
- }
- 
- js += ") {\n";
- 
- // Add AI intent as comment for debugging
- if (!ai_intent_description_.empty()) {
- js += " // AI Intent: " + ai_intent_description_ + "\n";
- }
+ std::string_view name() const { return name_; }
+ LamiaType return_type() const { return return_type_; }
+ std::string_view ai_intent() const { return ai_intent_description_; }
+ const LamiaArenaVector<Parameter>& parameters() const { return parameters_; }
+ const LamiaArenaVector<const LamiaExpression*>& body() const { return body_; }
  
- for (const auto& stmt : body_) {
- js += " " + stmt->to_javascript() + ";\n";
- }
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
+};
+
+/**
+ * @brief Lamia Style Declaration - AI-optimized CSS alternative
+ */
+class LamiaStyle : public LamiaExpression {
+private:
+ std::string_view selector_;
+ LamiaPropertyList<const LamiaExpression*> properties_;
+ std::string_view theme_context_;
  
- js += "}";
- return js;
+public:
+ LamiaStyle(std::string_view selector, std::string_view theme = "medusa-default")
+ : selector_(selector), theme_context_(theme) {
+ type = NodeType::STYLE_APPLICATION;
+ data_type = LamiaType::THEME;
  }
  
- std::string to_html() const override {
- return "<!-- Function: " + name_ + " -->"; // Functions don't translate to HTML
+ void add_property(LamiaAstArena& arena, std::string_view property, const LamiaExpression* value) {
+ properties_.set(arena, property, value);
  }
  
- std::string to_css() const override {
- return "/* Function: " + name_ + " */"; // Functions don't translate to CSS
- }
+ std::string_view selector() const { return selector_; }
+ std::string_view theme_context() const { return theme_context_; }
+ const LamiaPropertyList<const LamiaExpression*>& properties() const { return properties_; }
  
- std::string to_medusa_native() const override {
- std::string native = lamia_type_to_cpp_type(return_type_) + " " + name_ + "(";
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
+};
+
+/**
+ * @brief Lamia Call - Invocation of a named function
+ */
+class LamiaCall : public LamiaExpression {
+private:
+ std::string_view callee_;
+ LamiaArenaVector<const LamiaExpression*> arguments_;
  
- for (size_t i = 0; i < parameters_.size(); ++i) {
- if (i > 0) native += ", ";
- native += lamia_type_to_cpp_type(parameters_[i].second) + " " + parameters_[i].first;
+public:
+ explicit LamiaCall(std::string_view callee) : callee_(callee) {
+ type = NodeType::FUNCTION_CALL;
+ data_type = LamiaType::VOID_STAR;
  }
  
- native += ") {\n";
- 
- for (const auto& stmt : body_) {
- native += " " + stmt->to_medusa_native() + ";\n";
+ void add_argument(LamiaAstArena& arena, const LamiaExpression* argument) {
+ arguments_.push_back(arena, argument);
  }
  
- native += "}";
- return native;
- }
+ std::string_view callee() const { return callee_; }
+ const LamiaArenaVector<const LamiaExpression*>& arguments() const { return arguments_; }
  
-private:
- std::string lamia_type_to_cpp_type(LamiaType type) const {
- switch (type) {
- case LamiaType::RADIANT: return "std::string";
- case LamiaType::SHIMMER: return "double";
- case LamiaType::LUMINA: return "bool";
- case LamiaType::VOID_STAR: return "void";
- case LamiaType::CONSTELLATION: return "std::vector<LamiaValue>";
- case LamiaType::NEBULA: return "std::map<std::string, LamiaValue>";
- case LamiaType::WIDGET: return "MedusaWidget";
- default: return "auto";
- }
- }
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
 };
 
 /**
- * @brief Lamia Style Declaration - AI-optimized CSS alternative
+ * @brief Lamia Return - return_light statement with an optional value
  */
-class LamiaStyle : public LamiaExpression {
+class LamiaReturn : public LamiaExpression {
 private:
- std::string selector_;
- std::map<std::string, std::shared_ptr<LamiaExpression>> properties_;
- std::string theme_context_;
+ const LamiaExpression* value_;
  
 public:
- LamiaStyle(const std::string& selector, const std::string& theme = "medusa-default")
- : selector_(selector), theme_context_(theme) {
- type = NodeType::STYLE_APPLICATION;
- data_type = LamiaType::THEME;
+ explicit LamiaReturn(const LamiaExpression* value = nullptr) : value_(value) {
+ type = NodeType::RETURN;
+ data_type = value ? value->data_type : LamiaType::VOID_STAR;
  }
  
- void add_property(const std::string& property, std::shared_ptr<LamiaExpression> value) {
- properties_[property] = value;
- }
+ const LamiaExpression* value() const { return value_; }
  
- std::string to_javascript() const override {
- std::string js = "MedusaTheme.applyStyle('" + selector_ + "', {\n";
- js += " theme: '" + theme_context_ + "',\n";
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
+};
+
+/**
+ * @brief Lamia Array - Constellation literal
+ */
+class LamiaArray : public LamiaExpression {
+private:
+ LamiaArenaVector<const LamiaExpression*> elements_;
  
- for (const auto& [prop, value] : properties_) {
- js += " '" + prop + "': " + value->to_javascript() + ",\n";
+public:
+ LamiaArray() {
+ type = NodeType::LITERAL;
+ data_type = LamiaType::CONSTELLATION;
  }
  
- js += "})";
- return js;
+ void add_element(LamiaAstArena& arena, const LamiaExpression* element) {
+ elements_.push_back(arena, element);
  }
  
- std::string to_html() const override {
- return "<style data-theme=\"" + theme_context_ + "\">\n" + to_css() + "\n</style>";
- }
+ const LamiaArenaVector<const LamiaExpression*>& elements() const { return elements_; }
  
- std::string to_css() const override {
- std::string css = selector_ + " {\n";
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
+};
+
+/**
+ * @brief Lamia Program - Top-level declarations of one source file, in order
+ */
+class LamiaProgram : public LamiaExpression {
+private:
+ LamiaArenaVector<const LamiaExpression*> declarations_;
  
- for (const auto& [prop, value] : properties_) {
- css += " " + prop + ": " + value->to_css() + ";\n";
+public:
+ LamiaProgram() {
+ type = NodeType::PROGRAM;
+ data_type = LamiaType::VOID_STAR;
  }
  
- css += "}";
- return css;
+ void add_declaration(LamiaAstArena& arena, const LamiaExpression* declaration) {
+ declarations_.push_back(arena, declaration);
  }
  
- std::string to_medusa_native() const override {
- std::string native = "MedusaTheme::Style style(\"" + selector_ + "\");\n";
- native += "style.set_theme_context(\"" + theme_context_ + "\");\n";
- 
- for (const auto& [prop, value] : properties_) {
- native += "style.set_property(\"" + prop + "\", " + value->to_medusa_native() + ");\n";
- }
+ const LamiaArenaVector<const LamiaExpression*>& declarations() const { return declarations_; }
  
- return native;
- }
+ void accept(LamiaExpressionVisitor& visitor) const override { visitor.visit(*this); }
 };
 
 /**
- * @brief Lamia Parser - AI-assisted parsing engine
+ * @brief Lamia Emitter - Single-pass multi-target code generation
+ *
+ * One walk over the AST appends to every requested channel at once.
+ * Sub-trees that a target does not render (e.g. widget children in CSS)
+ * are visited with that channel masked off rather than walked again.
+ *
+ * A channel with attached sinks streams straight into them; channels
+ * without sinks accumulate in buffers(). Sinks carrying a LamiaSourceMap
+ * get a mapping at the start of every statement, call and declaration.
+ *
+ * In minify mode the web channels (JavaScript, HTML, CSS) are written
+ * compact as they are generated: no indentation, line breaks or comments,
+ * manifest parameters renamed to short locals and CSS declarations
+ * collapsed to "prop:value". Native C++ output is the same in both modes.
+ *
+ * The native channel lowers a program to a C++ translation unit for
+ * medusa_native_runtime.hpp, written after the web channels' walk: its
+ * manifests become free functions of namespace LamiaProgram, declared
+ * before any is defined, and the remaining statements, in source order,
+ * the body of LamiaProgram::render_page. create and style_with build
+ * Widget values; as statements they mount on the page. A call to a
+ * manifest is a direct call, any other callee a host function.
  */
-class LamiaParser {
+class LamiaEmitter : public LamiaExpressionVisitor {
+public:
+ enum Channel : unsigned {
+ JAVASCRIPT = 1u << 0,
+ HTML = 1u << 1,
+ CSS = 1u << 2,
+ NATIVE = 1u << 3,
+ WEB_CHANNELS = JAVASCRIPT | HTML | CSS,
+ ALL_CHANNELS = WEB_CHANNELS | NATIVE
+ };
+ 
+ struct Buffers {
+ std::string javascript;
+ std::string html;
+ std::string css;
+ std::string native;
+ };
+ 
 private:
- std::vector<LamiaToken> tokens_;
- size_t current_token_ = 0;
- std::vector<std::string> parse_errors_;
+ unsigned active_;
+ bool minify_;
+ Buffers out_;
+ std::vector<LamiaOutputSink*> sinks_[4]; // Indexed by channel bit
+ bool mapped_ = false; // An attached sink records a source map
  
- // AI assistance state
- bool ai_completion_mode_ = false;
- std::function<std::vector<std::string>(const std::string&)> ai_completion_callback_;
+ // Native lowering state
+ std::map<std::string_view, const LamiaFunction*> native_manifests_; // Top-level manifests of the program
+ std::vector<std::string_view> native_locals_; // Nested manifests in scope (C++ lambdas)
+ const LamiaFunction* native_function_ = nullptr; // Manifest whose body is being lowered
+ 
+ // Script state
+ const LamiaFunction* script_function_ = nullptr; // Innermost manifest whose script body is being written
  
 public:
- explicit LamiaParser(const std::vector<LamiaToken>& tokens) 
- : tokens_(tokens) {}
+ explicit LamiaEmitter(unsigned channels = ALL_CHANNELS, bool minify = false)
+ : active_(channels), minify_(minify) {}
  
- void enable_ai_assistance(std::function<std::vector<std::string>(const std::string&)> callback) {
- ai_completion_mode_ = true;
- ai_completion_callback_ = callback;
- }
+ bool minify() const { return minify_; }
  
- std::shared_ptr<LamiaExpression> parse() {
- try {
- return parse_expression();
- } catch (const std::exception& e) {
- parse_errors_.push_back(e.what());
+ void emit(const LamiaExpression& root) {
+ root.accept(*this);
+ if (mapped_) {
+ // Whatever is written after the tree (epilogues) is no node's code
+ for (auto& sinks : sinks_) {
+ for (auto* sink : sinks) {
+ sink->unmap_source();
+ }
+ }
+ }
+ }
  
- if (ai_completion_mode_ && ai_completion_callback_) {
- // Request AI assistance for error recovery
- auto suggestions = ai_completion_callback_("Parse error: " + std::string(e.what()));
- // Implement error recovery with AI suggestions
+ /**
+ * @brief Stream one channel into sink instead of its buffer (several sinks may share a channel)
+ */
+ void attach(Channel channel, LamiaOutputSink& sink) {
+ sinks_[channel_index(channel)].push_back(&sink);
+ mapped_ |= sink.source_map() != nullptr;
  }
  
- return nullptr;
+ Buffers& buffers() { return out_; }
+ const Buffers& buffers() const { return out_; }
+ 
+ void visit(const WidgetExpression& node) override {
+ mark(node);
+ if (active_ & NATIVE) {
+ write_native_widget(node);
  }
+ write(JAVASCRIPT, "MedusaWidget.create('", node.name(), layout("', {\n theme: '", "',{theme:'"), node.theme(), "'");
+ write(HTML, "<medusa-", node.name(), " theme=\"", node.theme(), "\"");
+ if (!minify_) { // The rule is empty: minified output leaves it out
+ write(CSS, "medusa-", node.name(), "[theme=\"", node.theme(), "\"] { /* Generated styling */ }");
  }
  
- const std::vector<std::string>& get_errors() const {
- return parse_errors_;
+ // Script members are separated before each one, so the minified object has no trailing comma
+ for (const auto& [key, value] : node.properties()) {
+ write(JAVASCRIPT, layout(",\n ", ","), script_key(key), layout(": ", ":"));
+ write(HTML, " ", key, "=\"");
+ visit_masked(JAVASCRIPT | HTML, *value);
+ write(HTML, "\"");
  }
  
-private:
- std::shared_ptr<LamiaExpression> parse_expression() {
- // Simplified parsing - full implementation would be more complex
- LamiaToken current = peek_token();
- 
- if (current.value == "create") {
- return parse_widget_creation();
- } else if (current.value == "manifest") {
- return parse_function_definition();
- } else if (current.value == "style_with") {
- return parse_style_declaration();
+ if (node.children().empty()) {
+ write(HTML, layout(" />", "/>"));
  } else {
- return parse_literal();
+ write(JAVASCRIPT, layout(",\n children: [\n", ",children:["));
+ write(HTML, layout(">\n", ">"));
+ const auto& children = node.children();
+ for (size_t i = 0; i < children.size(); ++i) {
+ write(JAVASCRIPT, layout(" ", i > 0 ? "," : ""));
+ write(HTML, layout(" "));
+ visit_masked(JAVASCRIPT | HTML, *children[i]);
+ write(JAVASCRIPT, layout(",\n"));
+ write(HTML, layout("\n"));
  }
+ write(JAVASCRIPT, layout(" ]", "]"));
+ write(HTML, "</medusa-", node.name(), ">");
  }
  
- std::shared_ptr<LamiaExpression> parse_widget_creation() {
- consume_token(); // consume "create"
+ write(JAVASCRIPT, layout(node.children().empty() ? ",\n})" : "\n})", "})"));
+ }
  
- LamiaToken widget_type = consume_token();
- auto widget = std::make_shared<WidgetExpression>(widget_type.value);
+ void visit(const LamiaLiteral& node) override {
+ // HTML attributes and CSS values use the JavaScript literal syntax
+ std::visit([this, &node](const auto& v) {
+ using T = std::decay_t<decltype(v)>;
+ if constexpr (std::is_same_v<T, std::string_view>) {
+ size_t parameter = node.type == LamiaExpression::NodeType::IDENTIFIER ? script_parameter(v) : std::string::npos;
+ if (parameter != std::string::npos) {
+ write(JAVASCRIPT, minify_ ? local_name(parameter) : std::string(v)); // Reads the parameter, as every target does
+ write(CSS, "\"", v, "\"");
+ } else if (node.verbatim) {
+ write(JAVASCRIPT | CSS, script_string(v));
+ } else {
+ write(JAVASCRIPT | CSS, "\"", v, "\"");
+ }
+ if (active_ & HTML) {
+ write(HTML, "\"", html_text(v), "\"");
+ }
+ if (node.type == LamiaExpression::NodeType::IDENTIFIER && native_parameter(v)) {
+ write(NATIVE, native_name(v)); // Server-side, a parameter's name reads it
+ } else if (active_ & NATIVE) {
+ write(NATIVE, "MedusaNative::LamiaRadiant(", native_string(v, !node.verbatim), ")");
+ }
+ } else if constexpr (std::is_same_v<T, double>) {
+ std::string number = std::to_string(v);
+ write(WEB_CHANNELS, minify_ ? compact_number(number) : std::string_view(number));
+ write(NATIVE, "MedusaNative::LamiaShimmer(", number, ")");
+ } else if constexpr (std::is_same_v<T, bool>) {
+ write(WEB_CHANNELS, v ? "true" : "false");
+ write(NATIVE, "MedusaNative::LamiaLumina(", v ? "true" : "false", ")");
+ } else {
+ write(WEB_CHANNELS, "null");
+ write(NATIVE, "MedusaNative::LamiaVoidStar()");
+ }
+ }, node.value());
+ }
  
- // Parse properties and children...
- // Simplified for specification
+ void visit(const LamiaFunction& node) override {
+ mark(node);
+ if (active_ & NATIVE) {
+ write_native_function(node);
+ }
+ write(JAVASCRIPT, "function ", node.name(), "(");
+ if (!minify_) {
+ write(HTML, "<!-- Function: ", node.name(), " -->"); // Functions don't translate to HTML
+ write(CSS, "/* Function: ", node.name(), " */"); // Functions don't translate to CSS
+ }
  
- return widget;
+ // A bare identifier naming a parameter reads it under the same (possibly minified) name
+ const auto& parameters = node.parameters();
+ for (size_t i = 0; i < parameters.size(); ++i) {
+ if (i > 0) {
+ write(JAVASCRIPT, layout(", ", ","));
+ }
+ write(JAVASCRIPT, minify_ ? local_name(i) : std::string(parameters[i].name));
  }
  
- std::shared_ptr<LamiaExpression> parse_function_definition() {
- consume_token(); // consume "manifest"
+ write(JAVASCRIPT, layout(") {\n", "){"));
  
- LamiaToken function_name = consume_token();
- auto function = std::make_shared<LamiaFunction>(function_name.value);
+ // Add AI intent as comment for debugging
+ if (!node.ai_intent().empty() && !minify_) {
+ write(JAVASCRIPT, " // AI Intent: ", node.ai_intent(), "\n");
+ }
  
- // Parse parameters and body...
- // Simplified for specification
+ const LamiaFunction* enclosing = script_function_;
+ script_function_ = &node;
+ const auto& body = node.body();
+ for (size_t i = 0; i < body.size(); ++i) {
+ write(JAVASCRIPT, layout(" ", i > 0 ? ";" : ""));
+ visit_masked(JAVASCRIPT, *body[i]);
+ write(JAVASCRIPT, layout(";\n"));
+ }
+ script_function_ = enclosing;
  
- return function;
+ write(JAVASCRIPT, "}");
  }
  
- std::shared_ptr<LamiaExpression> parse_style_declaration() {
- consume_token(); // consume "style_with"
+ void visit(const LamiaStyle& node) override {
+ mark(node);
+ if (active_ & NATIVE) {
+ write_native_style(node);
+ }
+ write(JAVASCRIPT, "MedusaTheme.applyStyle('", node.selector(), layout("', {\n theme: '", "',{theme:'"),
+ node.theme_context(), "'");
+ write(HTML, "<style data-theme=\"", node.theme_context(), layout("\">\n", "\">"));
+ write(CSS | HTML, node.selector(), layout(" {\n", "{"));
  
- LamiaToken selector = consume_token();
- auto style = std::make_shared<LamiaStyle>(selector.value);
+ bool first = true;
+ for (const auto& [prop, value] : node.properties()) {
+ write(JAVASCRIPT, layout(",\n '", ",'"), prop, layout("': ", "':"));
+ write(CSS | HTML, layout(" ", first ? "" : ";"), prop, layout(": ", ":"));
+ visit_masked(JAVASCRIPT | CSS | HTML, *value);
+ write(CSS | HTML, layout(";\n"));
+ first = false;
+ }
  
- // Parse style properties...
- // Simplified for specification
+ write(JAVASCRIPT, layout(",\n})", "})"));
+ write(CSS | HTML, "}");
+ write(HTML, layout("\n</style>", "</style>"));
+ }
  
- return style;
+ void visit(const LamiaCall& node) override {
+ mark(node);
+ // Calls only run in script and native code
+ write(JAVASCRIPT, node.callee(), "(");
+ bool host = (active_ & NATIVE) && !native_callable(node.callee());
+ if (host) {
+ write(NATIVE, "MedusaNative::call(", native_string(node.callee(), false), ", {");
+ } else if (active_ & NATIVE) {
+ write(NATIVE, native_locals_has(node.callee()) ? "" : "LamiaProgram::", native_name(node.callee()), "(");
+ }
+ const auto& arguments = node.arguments();
+ for (size_t i = 0; i < arguments.size(); ++i) {
+ if (i > 0) {
+ write(JAVASCRIPT, layout(", ", ","));
+ write(NATIVE, ", ");
+ }
+ visit_masked(JAVASCRIPT | NATIVE, *arguments[i]);
+ }
+ write(JAVASCRIPT, ")");
+ write(NATIVE, host ? "})" : ")");
  }
  
- std::shared_ptr<LamiaExpression> parse_literal() {
- LamiaToken token = consume_token();
+ void visit(const LamiaReturn& node) override {
+ mark(node);
+ write(JAVASCRIPT | NATIVE, "return");
+ if (!node.value()) {
+ write(NATIVE, native_function_ ? " MedusaNative::LamiaVoidStar()" : "");
+ return;
+ }
+ write(JAVASCRIPT | NATIVE, " ");
+ write(NATIVE, native_function_ ? "" : "(void)("); // render_page returns nothing
+ visit_masked(JAVASCRIPT | NATIVE, *node.value());
+ write(NATIVE, native_function_ ? "" : ")");
+ }
  
- // Determine literal type and create appropriate LamiaLiteral
- if (token.value.front() == '"' && token.value.back() == '"') {
- std::string string_value = token.value.substr(1, token.value.length() - 2);
- return std::make_shared<LamiaLiteral>(string_value);
- } else if (token.value == "true" || token.value == "false") {
- return std::make_shared<LamiaLiteral>(token.value == "true");
- } else {
- try {
- double numeric_value = std::stod(token.value);
- return std::make_shared<LamiaLiteral>(numeric_value);
- } catch (...) {
- // Return as identifier or throw error
- return std::make_shared<LamiaLiteral>(token.value);
+ void visit(const LamiaArray& node) override {
+ write(WEB_CHANNELS, "[");
+ write(NATIVE, "MedusaNative::LamiaConstellation({");
+ const auto& elements = node.elements();
+ for (size_t i = 0; i < elements.size(); ++i) {
+ if (i > 0) {
+ write(WEB_CHANNELS, layout(", ", ","));
+ write(NATIVE, ", ");
  }
+ elements[i]->accept(*this);
  }
+ write(WEB_CHANNELS, "]");
+ write(NATIVE, "})");
  }
  
- LamiaToken peek_token() const {
- if (current_token_ < tokens_.size()) {
- return tokens_[current_token_];
- }
- return LamiaToken{}; // Empty token
+ void visit(const LamiaProgram& node) override {
+ if (active_ & NATIVE) {
+ write_native_program(node);
  }
  
- LamiaToken consume_token() {
- if (current_token_ < tokens_.size()) {
- return tokens_[current_token_++];
+ unsigned saved = active_;
+ active_ &= WEB_CHANNELS;
+ const auto& declarations = node.declarations();
+ for (size_t i = 0; active_ && i < declarations.size(); ++i) {
+ if (i > 0) {
+ // Statements still need a terminator once the line breaks are gone
+ write(JAVASCRIPT, layout("\n\n", ";"));
+ write(HTML | CSS, layout("\n\n"));
  }
- throw std::runtime_error("Unexpected end of input");
+ declarations[i]->accept(*this);
+ }
+ active_ = saved;
  }
-};
-
-/**
- * @brief Lamia Transpiler - Multi-target code generation
- */
-class LamiaTranspiler {
-public:
- enum class Target {
- JAVASCRIPT_ES6,
- JAVASCRIPT_ES5,
- TYPESCRIPT,
- HTML5,
- CSS3,
- MEDUSA_NATIVE,
- WEBASSEMBLY
- };
  
 private:
- Target target_;
- std::map<std::string, std::string> optimization_flags_;
- 
-public:
- explicit LamiaTranspiler(Target target) : target_(target) {}
+ /**
+ * @brief Append text fragments to every active channel in the mask
+ */
+ template<typename... Parts>
+ void write(unsigned channels, const Parts&... parts) {
+ unsigned target = channels & active_;
+ if (target & JAVASCRIPT) append(sinks_[0], out_.javascript, parts...);
+ if (target & HTML) append(sinks_[1], out_.html, parts...);
+ if (target & CSS) append(sinks_[2], out_.css, parts...);
+ if (target & NATIVE) append(sinks_[3], out_.native, parts...);
+ }
  
- void set_optimization(const std::string& flag, const std::string& value) {
- optimization_flags_[flag] = value;
+ template<typename... Parts>
+ static void append(const std::vector<LamiaOutputSink*>& sinks, std::string& buffer, const Parts&... parts) {
+ if (sinks.empty()) {
+ (buffer.append(std::string_view(parts)), ...);
+ return;
+ }
+ for (auto* sink : sinks) {
+ (sink->write(std::string_view(parts)), ...);
+ }
  }
  
- std::string transpile(std::shared_ptr<LamiaExpression> ast) {
- switch (target_) {
- case Target::JAVASCRIPT_ES6:
- return transpile_to_javascript_es6(ast);
- case Target::TYPESCRIPT:
- return transpile_to_typescript(ast);
- case Target::HTML5:
- return transpile_to_html5(ast);
- case Target::CSS3:
- return transpile_to_css3(ast);
- case Target::MEDUSA_NATIVE:
- return transpile_to_medusa_native(ast);
- default:
- return ast->to_javascript(); // Fallback
+ static size_t channel_index(Channel channel) {
+ switch (channel) {
+ case JAVASCRIPT: return 0;
+ case HTML: return 1;
+ case CSS: return 2;
+ default: return 3;
  }
  }
  
-private:
- std::string transpile_to_javascript_es6(std::shared_ptr<LamiaExpression> ast) {
- std::string output = "// Generated from Lamia Language\n";
- output += "// Target: JavaScript ES6\n\n";
- output += ast->to_javascript();
- return output;
+ /**
+ * @brief Tell the source maps of the active channels that node's code starts here
+ */
+ void mark(const LamiaExpression& node) {
+ if (!mapped_ || node.source_location.empty()) {
+ return;
+ }
+ for (Channel channel : {JAVASCRIPT, HTML, CSS, NATIVE}) {
+ if (active_ & channel) {
+ for (auto* sink : sinks_[channel_index(channel)]) {
+ sink->map_source(node.source_location);
+ }
+ }
+ }
  }
  
- std::string transpile_to_typescript(std::shared_ptr<LamiaExpression> ast) {
- std::string output = "// Generated from Lamia Language\n";
- output += "// Target: TypeScript\n\n";
- output += "import { MedusaWidget, MedusaTheme } from '@medusa/core';\n\n";
- output += ast->to_javascript(); // Enhanced with TypeScript types
- return output;
+ /**
+ * @brief Visit a sub-tree with only the given channels enabled
+ */
+ void visit_masked(unsigned channels, const LamiaExpression& node) {
+ unsigned saved = active_;
+ active_ &= channels;
+ if (active_) {
+ node.accept(*this);
+ }
+ active_ = saved;
  }
  
- std::string transpile_to_html5(std::shared_ptr<LamiaExpression> ast) {
- std::string output = "<!DOCTYPE html>\n";
- output += "<!-- Generated from Lamia Language -->\n";
- output += "<html lang=\"en\">\n<head>\n";
- output += " <meta charset=\"UTF-8\">\n";
- output += " <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n";
- output += " <title>Lamia Generated Page</title>\n";
- output += " <link rel=\"stylesheet\" href=\"medusa-theme.css\">\n";
- output += "</head>\n<body>\n";
- output += ast->to_html();
- output += "\n <script src=\"medusa-runtime.js\"></script>\n";
- output += "</body>\n</html>";
- return output;
+ /**
+ * @brief Formatting text: pretty by default, minified (usually nothing) in minify mode
+ */
+ std::string_view layout(std::string_view pretty, std::string_view minified = {}) const {
+ return minify_ ? minified : pretty;
  }
  
- std::string transpile_to_css3(std::shared_ptr<LamiaExpression> ast) {
- std::string output = "/* Generated from Lamia Language */\n";
- output += "/* Target: CSS3 with Medusa Theme */\n\n";
- output += "@import url('medusa-base-theme.css');\n\n";
- output += ast->to_css();
- return output;
+ /**
+ * @brief Short script name for the index-th parameter: $a..$Z, then $ba...
+ *
+ * Lamia identifiers cannot contain '$', so these never shadow a callee.
+ */
+ static std::string local_name(size_t index) {
+ static constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+ std::string name = "$";
+ do {
+ name += letters[index % letters.size()];
+ index /= letters.size();
+ } while (index);
+ return name;
  }
  
- std::string transpile_to_medusa_native(std::shared_ptr<LamiaExpression> ast) {
- std::string output = "// Generated from Lamia Language\n";
- output += "// Target: Medusa Native C++\n\n";
- output += "#include \"medusa_native_runtime.hpp\"\n\n";
- output += ast->to_medusa_native();
- return output;
+ /**
+ * @brief std::to_string(double) without its trailing zeros ("1.500000" -> "1.5")
+ */
+ static std::string_view compact_number(std::string_view number) {
+ if (number.find('.') != std::string_view::npos) {
+ number = number.substr(0, number.find_last_not_of('0') + 1);
+ if (number.back() == '.') {
+ number.remove_suffix(1);
  }
-};
-
+ }
+ return number;
+ }
+ 
+ // ------------------------------------------------------------------
+ // Native lowering
+ // ------------------------------------------------------------------
+ 
+ void write_native_program(const LamiaProgram& node) {
+ unsigned saved = active_;
+ active_ = NATIVE;
+ native_manifests_.clear();
+ std::vector<const LamiaExpression*> statements;
+ for (const auto* declaration : node.declarations()) {
+ if (declaration->type == LamiaExpression::NodeType::FUNCTION_DEF) {
+ const auto* function = static_cast<const LamiaFunction*>(declaration);
+ native_manifests_.emplace(function->name(), function);
+ } else {
+ statements.push_back(declaration);
+ }
+ }
+ 
+ // Every manifest is declared before any is defined, so they may call each other in any order
+ write(NATIVE, "namespace LamiaProgram {\n\n");
+ for (const auto* declaration : node.declarations()) {
+ if (declaration->type == LamiaExpression::NodeType::FUNCTION_DEF) {
+ write_native_signature(static_cast<const LamiaFunction&>(*declaration), true);
+ write(NATIVE, ";\n");
+ }
+ }
+ for (const auto* declaration : node.declarations()) {
+ if (declaration->type == LamiaExpression::NodeType::FUNCTION_DEF) {
+ write(NATIVE, "\n");
+ declaration->accept(*this);
+ write(NATIVE, "\n");
+ }
+ }
+ 
+ write(NATIVE, "\nvoid render_page(MedusaNative::Page& page) {\n MedusaNative::PageScope scope(page);\n");
+ for (const auto* statement : statements) {
+ write_native_statement(*statement);
+ }
+ write(NATIVE, "}\n\n} // namespace LamiaProgram\n\n");
+ write(NATIVE, "#ifndef LAMIA_NATIVE_NO_MAIN\nint main() {\n return MedusaNative::run_page(LamiaProgram::render_page);\n}\n#endif\n");
+ active_ = saved;
+ }
+ 
+ /**
+ * @brief Every Lamia value is a LamiaValue; missing arguments default to null
+ */
+ void write_native_signature(const LamiaFunction& node, bool declaration) {
+ write(NATIVE, "MedusaNative::LamiaValue ", native_name(node.name()), "(");
+ const auto& parameters = node.parameters();
+ for (size_t i = 0; i < parameters.size(); ++i) {
+ write(NATIVE, i > 0 ? ", " : "", "MedusaNative::LamiaValue ", native_name(parameters[i].name),
+ declaration ? " = {}" : "");
+ }
+ write(NATIVE, ")");
+ }
+ 
+ /**
+ * @brief A top-level manifest is a free function, a nested one a lambda of the enclosing body
+ */
+ void write_native_function(const LamiaFunction& node) {
+ unsigned saved = active_;
+ active_ = NATIVE;
+ const LamiaFunction* enclosing = native_function_;
+ if (enclosing) {
+ write(NATIVE, "auto ", native_name(node.name()), " = [&](");
+ const auto& parameters = node.parameters();
+ for (size_t i = 0; i < parameters.size(); ++i) {
+ write(NATIVE, i > 0 ? ", " : "", "MedusaNative::LamiaValue ", native_name(parameters[i].name));
+ }
+ write(NATIVE, ") -> MedusaNative::LamiaValue {\n");
+ } else {
+ write_native_signature(node, false);
+ write(NATIVE, " {\n");
+ }
+ 
+ native_function_ = &node;
+ size_t locals = native_locals_.size();
+ for (const auto* statement : node.body()) {
+ write_native_statement(*statement);
+ }
+ write(NATIVE, " return MedusaNative::LamiaVoidStar();\n}");
+ native_locals_.resize(locals);
+ native_function_ = enclosing;
+ if (enclosing) {
+ native_locals_.push_back(node.name()); // Callable by the statements after it
+ }
+ active_ = saved;
+ }
+ 
+ /**
+ * @brief One statement of a manifest body or of the page: create and style_with mount
+ */
+ void write_native_statement(const LamiaExpression& statement) {
+ bool mounts = statement.type == LamiaExpression::NodeType::WIDGET_CREATION || statement.type == LamiaExpression::NodeType::STYLE_APPLICATION;
+ write(NATIVE, mounts ? " MedusaNative::mount(" : " ");
+ visit_masked(NATIVE, statement);
+ write(NATIVE, mounts ? ");\n" : ";\n");
+ }
+ 
+ void write_native_widget(const WidgetExpression& node) {
+ write(NATIVE, "MedusaNative::Widget(", native_string(node.name(), false), ", ",
+ native_string(node.theme(), false), ", {");
+ bool first = true;
+ for (const auto& [key, value] : node.properties()) {
+ write(NATIVE, first ? "{" : ", {", native_string(key, false), ", ");
+ visit_masked(NATIVE, *value);
+ write(NATIVE, "}");
+ first = false;
+ }
+ write(NATIVE, "}");
+ 
+ const auto& children = node.children();
+ if (!children.empty()) {
+ write(NATIVE, ", {");
+ for (size_t i = 0; i < children.size(); ++i) {
+ write(NATIVE, i > 0 ? ", " : "");
+ write_native_child(*children[i]);
+ }
+ write(NATIVE, "}");
+ }
+ write(NATIVE, ")");
+ }
+ 
+ /**
+ * @brief Widgets and styles nest as they are; values become text children
+ */
+ void write_native_child(const LamiaExpression& child) {
+ switch (child.type) {
+ case LamiaExpression::NodeType::WIDGET_CREATION:
+ case LamiaExpression::NodeType::STYLE_APPLICATION:
+ visit_masked(NATIVE, child);
+ break;
+ case LamiaExpression::NodeType::FUNCTION_DEF:
+ case LamiaExpression::NodeType::RETURN:
+ write(NATIVE, "MedusaNative::Text()"); // Statements, not values: nothing to show
+ break;
+ default:
+ write(NATIVE, "MedusaNative::Text(");
+ visit_masked(NATIVE, child);
+ write(NATIVE, ")");
+ break;
+ }
+ }
+ 
+ void write_native_style(const LamiaStyle& node) {
+ write(NATIVE, "MedusaNative::Style(", native_string(node.selector(), false), ", ",
+ native_string(node.theme_context(), false), ", {");
+ bool first = true;
+ for (const auto& [prop, value] : node.properties()) {
+ write(NATIVE, first ? "{" : ", {", native_string(prop, false), ", ");
+ visit_masked(NATIVE, *value);
+ write(NATIVE, "}");
+ first = false;
+ }
+ write(NATIVE, "})");
+ }
+ 
+ /**
+ * @brief Index of the script function's parameter called name, npos if none
+ *
+ * Only the innermost manifest's parameters: minified nested manifests
+ * reuse the same local names, so an outer one may be shadowed.
+ */
+ size_t script_parameter(std::string_view name) const {
+ if (script_function_) {
+ const auto& parameters = script_function_->parameters();
+ for (size_t i = 0; i < parameters.size(); ++i) {
+ if (parameters[i].name == name) {
+ return i;
+ }
+ }
+ }
+ return std::string::npos;
+ }
+ 
+ bool native_parameter(std::string_view name) const {
+ if (native_function_) {
+ for (const auto& parameter : native_function_->parameters()) {
+ if (parameter.name == name) {
+ return true;
+ }
+ }
+ }
+ return false;
+ }
+ 
+ bool native_locals_has(std::string_view name) const {
+ for (auto local : native_locals_) {
+ if (local == name) {
+ return true;
+ }
+ }
+ return false;
+ }
+ 
+ bool native_callable(std::string_view callee) const {
+ return native_locals_has(callee) || native_manifests_.count(callee);
+ }
+ 
+ /**
+ * @brief Lamia name as a C++ identifier: keywords and generated names get a trailing '_'
+ */
+ static std::string native_name(std::string_view name) {
+ static constexpr std::string_view reserved[] = {
+ "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+ "case", "catch", "char", "char16_t", "char32_t", "char8_t", "class", "co_await", "co_return",
+ "co_yield", "compl", "concept", "const", "const_cast", "consteval", "constexpr", "constinit",
+ "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+ "explicit", "export", "extern", "float", "for", "friend", "goto", "if", "inline", "int", "long",
+ "main", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+ "or_eq", "page", "private", "protected", "public", "register", "reinterpret_cast", "render_page",
+ "requires", "return", "scope", "short", "signed", "sizeof", "static", "static_assert",
+ "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "try", "typedef",
+ "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t",
+ "while", "xor", "xor_eq"
+ };
+ std::string result(name);
+ for (auto word : reserved) {
+ if (word == name) {
+ result += '_';
+ break;
+ }
+ }
+ return result;
+ }
+ 
+ /**
+ * @brief A JavaScript string literal holding text exactly as written
+ *
+ * "</" is written "<\/" so the literal can't close an inline <script>.
+ */
+ static std::string script_string(std::string_view text) {
+ std::string out = "\"";
+ for (size_t i = 0; i < text.size(); ++i) {
+ char c = text[i];
+ switch (c) {
+ case '"': out += "\\\""; break;
+ case '\\': out += "\\\\"; break;
+ case '\n': out += "\\n"; break;
+ case '\r': out += "\\r"; break;
+ case '\t': out += "\\t"; break;
+ case '/': out += i > 0 && text[i - 1] == '<' ? "\\/" : "/"; break;
+ default:
+ if (static_cast<unsigned char>(c) < 0x20) {
+ static const char digits[] = "0123456789abcdef";
+ out += "\\x";
+ out += digits[(c >> 4) & 0xF];
+ out += digits[c & 0xF];
+ } else if (text.compare(i, 3, "\xE2\x80\xA8") == 0 || text.compare(i, 3, "\xE2\x80\xA9") == 0) {
+ out += text[i + 2] == '\xA8' ? "\\u2028" : "\\u2029"; // Line terminators inside JavaScript strings
+ i += 2;
+ } else {
+ out += c;
+ }
+ break;
+ }
+ }
+ out += '"';
+ return out;
+ }
+ 
+ /**
+ * @brief A property name - quoted unless it is an identifier ("@function f()" makes "f()")
+ */
+ static std::string script_key(std::string_view key) {
+ bool identifier = !key.empty() && !std::isdigit(static_cast<unsigned char>(key[0]));
+ for (char c : key) {
+ identifier = identifier && (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$');
+ }
+ return identifier ? std::string(key) : script_string(key);
+ }
+ 
+ /**
+ * @brief Text with the characters HTML gives meaning to written as entities
+ */
+ static std::string html_text(std::string_view text) {
+ std::string out;
+ out.reserve(text.size());
+ for (char c : text) {
+ switch (c) {
+ case '&': out += "&amp;"; break;
+ case '<': out += "&lt;"; break;
+ case '>': out += "&gt;"; break;
+ case '"': out += "&quot;"; break;
+ default: out += c; break;
+ }
+ }
+ return out;
+ }
+ 
+ /**
+ * @brief A C++ string literal holding text
+ *
+ * With lamia_escapes the text is the inside of a Lamia string: its
+ * escapes are decoded as the script would decode them and written back
+ * as octal bytes, so C++ reads the same characters.
+ */
+ static std::string native_string(std::string_view text, bool lamia_escapes) {
+ std::string out = "\"";
+ auto octal = [&out](unsigned char byte) {
+ const char digits[] = {'\\', static_cast<char>('0' + (byte >> 6)),
+ static_cast<char>('0' + ((byte >> 3) & 7)), static_cast<char>('0' + (byte & 7))};
+ out.append(digits, sizeof(digits));
+ };
+ auto utf8 = [&octal](uint32_t code_point) {
+ if (code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+ code_point = 0xFFFD;
+ }
+ if (code_point < 0x80) {
+ octal(static_cast<unsigned char>(code_point));
+ } else if (code_point < 0x800) {
+ octal(static_cast<unsigned char>(0xC0 | (code_point >> 6)));
+ octal(static_cast<unsigned char>(0x80 | (code_point & 0x3F)));
+ } else if (code_point < 0x10000) {
+ octal(static_cast<unsigned char>(0xE0 | (code_point >> 12)));
+ octal(static_cast<unsigned char>(0x80 | ((code_point >> 6) & 0x3F)));
+ octal(static_cast<unsigned char>(0x80 | (code_point & 0x3F)));
+ } else {
+ octal(static_cast<unsigned char>(0xF0 | (code_point >> 18)));
+ octal(static_cast<unsigned char>(0x80 | ((code_point >> 12) & 0x3F)));
+ octal(static_cast<unsigned char>(0x80 | ((code_point >> 6) & 0x3F)));
+ octal(static_cast<unsigned char>(0x80 | (code_point & 0x3F)));
+ }
+ };
+ auto hex = [&text](size_t& i, size_t digits, uint32_t& value) {
+ value = 0;
+ for (size_t end = i + digits; i < end; ++i) {
+ if (i >= text.size() || !std::isxdigit(static_cast<unsigned char>(text[i]))) {
+ return false;
+ }
+ value = value * 16 + static_cast<uint32_t>(std::isdigit(static_cast<unsigned char>(text[i])) ?
+ text[i] - '0' : (text[i] | 0x20) - 'a' + 10);
+ }
+ return true;
+ };
+ 
+ for (size_t i = 0; i < text.size(); ++i) {
+ char c = text[i];
+ if (c == '\\' && lamia_escapes && i + 1 < text.size()) {
+ char escape = text[++i];
+ size_t start = i + 1;
+ uint32_t value = 0;
+ switch (escape) {
+ case 'n': out += "\\n"; continue;
+ case 'r': out += "\\r"; continue;
+ case 't': out += "\\t"; continue;
+ case 'b': out += "\\b"; continue;
+ case 'f': out += "\\f"; continue;
+ case 'v': out += "\\v"; continue;
+ case '0': octal(0); continue;
+ case '\n': continue; // Line continuation
+ case 'x':
+ if (hex(start, 2, value)) {
+ utf8(value);
+ i = start - 1;
+ continue;
+ }
+ break;
+ case 'u':
+ if (start < text.size() && text[start] == '{') {
+ size_t close = text.find('}', start);
+ size_t digits = close == std::string_view::npos ? 0 : close - start - 1;
+ ++start;
+ if (digits > 0 && digits <= 6 && hex(start, digits, value)) {
+ utf8(value);
+ i = close;
+ continue;
+ }
+ } else if (hex(start, 4, value)) {
+ // A high surrogate followed by an escaped low one is a single character
+ uint32_t low = 0;
+ size_t next = start + 2;
+ if (value >= 0xD800 && value <= 0xDBFF && start + 1 < text.size() && text[start] == '\\' &&
+ text[start + 1] == 'u' && hex(next, 4, low) && low >= 0xDC00 && low <= 0xDFFF) {
+ value = 0x10000 + ((value - 0xD800) << 10) + (low - 0xDC00);
+ start = next;
+ }
+ utf8(value);
+ i = start - 1;
+ continue;
+ }
+ break;
+ default:
+ break;
+ }
+ c = escape; // Any other escaped character stands for itself
+ }
+ 
+ if (c == '"' || c == '\\') {
+ out += '\\';
+ out += c;
+ } else if (c == '\n') {
+ out += "\\n";
+ } else if (c == '\r') {
+ out += "\\r";
+ } else if (c == '\t') {
+ out += "\\t";
+ } else if (static_cast<unsigned char>(c) < 0x20 || c == 0x7F) {
+ octal(static_cast<unsigned char>(c));
+ } else {
+ out += c;
+ }
+ }
+ out += '"';
+ return out;
+ }
+};
+
+inline std::string LamiaExpression::to_javascript() const {
+ LamiaEmitter emitter(LamiaEmitter::JAVASCRIPT);
+ emitter.emit(*this);
+ return std::move(emitter.buffers().javascript);
+}
+
+inline std::string LamiaExpression::to_html() const {
+ LamiaEmitter emitter(LamiaEmitter::HTML);
+ emitter.emit(*this);
+ return std::move(emitter.buffers().html);
+}
+
+inline std::string LamiaExpression::to_css() const {
+ LamiaEmitter emitter(LamiaEmitter::CSS);
+ emitter.emit(*this);
+ return std::move(emitter.buffers().css);
+}
+
+inline std::string LamiaExpression::to_medusa_native() const {
+ LamiaEmitter emitter(LamiaEmitter::NATIVE);
+ emitter.emit(*this);
+ return std::move(emitter.buffers().native);
+}
+
+/**
+ * @brief Lamia Parser - Recursive-descent parser with panic-mode recovery
+ *
+ * One forward pass over the token stream, at most two significant tokens
+ * of lookahead and no backtracking. A syntax error is recorded with its
+ * line and column, the parser skips to the end of the offending statement
+ * or block member, and parsing resumes there - so one pass reports every
+ * error. The returned tree holds everything that parsed; callers treat
+ * any recorded error as a failed compilation.
+ *
+ * Grammar (newlines, ',' and ';' separate statements and members):
+ *
+ *   program     := { statement }
+ *   statement   := function | widget | style | directive
+ *                | 'return_light' [ value ] | value
+ *   function    := 'manifest' name '(' [ param { ',' param } ] ')'
+ *                  [ '->' type ] [ '@' name ] block
+ *   param       := name [ ':' type ]
+ *   widget      := 'create' name [ theme ] [ '{' { member } '}' ]
+ *   style       := 'style_with' selector '{' { css-name ':' css-value } '}'
+ *   directive   := '@' name { argument } [ '{' { member } '}' | raw ]
+ *   member      := name ':' value | statement
+ *   value       := string | number | 'true' | 'false' | 'null'
+ *                | '[' [ value { ',' value } ] ']' | raw
+ *                | name { '.' name } [ '(' [ value { ',' value } ] ')' ]
+ *   raw         := '{' text with balanced braces '}'
+ *
+ * Directive arguments are runs of adjacent tokens: key="value" sets a
+ * property, a lone literal becomes a child and any other word is a flag;
+ * "::" only separates arguments. A directive holding a single literal
+ * ("@version "1.0"") is a property of its block, and one directly above
+ * a function ("@startup") annotates it. Markup and script bodies - HTML
+ * in @render, script in @lamia_code, see raw_body() - are kept as one
+ * verbatim string child holding the text between their braces, as are
+ * "@{...}" arguments and object values. Every string in the tree is
+ * copied into the arena; only source_location views the source.
+ */
+class LamiaParser {
+public:
+ /**
+ * @brief One recorded syntax error; line 0 means no source position
+ */
+ struct Diagnostic {
+ size_t line = 0;
+ size_t column = 0;
+ std::string message;
+ 
+ std::string to_string() const {
+ if (line == 0) {
+ return message;
+ }
+ return "line " + std::to_string(line) + ":" + std::to_string(column) + ": " + message;
+ }
+ };
+ 
+ /**
+ * @brief Token range [begin, end) of one top-level statement
+ *
+ * declaration is nullptr when the statement failed to parse.
+ */
+ struct Statement {
+ size_t begin = 0;
+ size_t end = 0;
+ const LamiaExpression* declaration = nullptr;
+ };
+ 
+private:
+ const LamiaTokenStream& tokens_; // Borrowed - parser never copies the stream
+ LamiaAstArena& arena_; // Owns every node this parser creates
+ size_t current_token_ = 0;
+ std::vector<Diagnostic> diagnostics_;
+ std::vector<Statement> statements_;
+ bool reported_end_of_input_ = false;
+ 
+ static constexpr size_t MAX_PARSE_ERRORS = 100; // Past this, the rest of the input is skipped
+ 
+ /**
+ * @brief Unwinds to the enclosing statement list - never escapes parse()
+ */
+ struct SyntaxError {};
+ 
+ // AI assistance state
+ bool ai_completion_mode_ = false;
+ std::function<std::vector<std::string>(const std::string&)> ai_completion_callback_;
+ 
+public:
+ LamiaParser(const LamiaTokenStream& tokens, LamiaAstArena& arena)
+ : tokens_(tokens), arena_(arena) {}
+ LamiaParser(LamiaTokenStream&&, LamiaAstArena&) = delete; // Tokens view the stream's lifetime
+ 
+ void enable_ai_assistance(std::function<std::vector<std::string>(const std::string&)> callback) {
+ ai_completion_mode_ = true;
+ ai_completion_callback_ = callback;
+ }
+ 
+ /**
+ * @brief Parse the stream - the returned tree lives as long as the arena
+ */
+ const LamiaExpression* parse() {
+ auto* program = arena_.create<LamiaProgram>();
+ 
+ skip_separators();
+ while (!at_end()) {
+ Statement statement;
+ statement.begin = current_token_;
+ if (check("}")) {
+ report(peek(), "Unmatched '}'");
+ ++current_token_;
+ } else {
+ try {
+ statement.declaration = parse_statement(nullptr);
+ program->add_declaration(arena_, statement.declaration);
+ } catch (const SyntaxError&) {
+ synchronize();
+ }
+ }
+ statement.end = current_token_;
+ statements_.push_back(statement);
+ skip_separators();
+ }
+ 
+ return program;
+ }
+ 
+ /**
+ * @brief Errors formatted as "line L:C: message"
+ */
+ std::vector<std::string> get_errors() const {
+ std::vector<std::string> errors;
+ errors.reserve(diagnostics_.size());
+ for (const auto& diagnostic : diagnostics_) {
+ errors.push_back(diagnostic.to_string());
+ }
+ return errors;
+ }
+ 
+ const std::vector<Diagnostic>& get_diagnostics() const {
+ return diagnostics_;
+ }
+ 
+ /**
+ * @brief Top-level statements in source order - where the incremental reparser may cut
+ */
+ const std::vector<Statement>& get_statements() const {
+ return statements_;
+ }
+ 
+private:
+ // ------------------------------------------------------------------
+ // Statements
+ // ------------------------------------------------------------------
+ 
+ /**
+ * @brief One statement; parent receives directives that read as its properties
+ * @return nullptr when the statement became a property of parent
+ */
+ const LamiaExpression* parse_statement(WidgetExpression* parent) {
+ const LamiaToken& start = peek();
+ if (check(LamiaKeywords::MANIFEST)) {
+ return located(parse_function(), start);
+ } else if (check(LamiaKeywords::CREATE)) {
+ return located(parse_widget(), start);
+ } else if (check(LamiaKeywords::STYLE_WITH)) {
+ return located(parse_style(), start);
+ } else if (check(LamiaKeywords::RETURN_LIGHT)) {
+ return located(parse_return(), start);
+ } else if (check("@")) {
+ return located(parse_directive(parent), start);
+ }
+ return parse_value();
+ }
+ 
+ /**
+ * @brief Record the token a node starts at, for source maps; nodes placed earlier keep theirs
+ *
+ * The node was just created by this parser, so it is never really const.
+ */
+ static const LamiaExpression* located(const LamiaExpression* node, const LamiaToken& start) {
+ if (node && node->source_location.empty()) {
+ const_cast<LamiaExpression*>(node)->source_location = start.value;
+ }
+ return node;
+ }
+ 
+ const LamiaExpression* parse_function() {
+ advance(); // manifest
+ std::string_view name = expect_name("function name");
+ 
+ std::vector<LamiaFunction::Parameter> parameters;
+ expect("(", "after the function name");
+ skip_newlines();
+ if (!check(")")) {
+ do {
+ skip_newlines();
+ LamiaFunction::Parameter parameter{expect_name("parameter name"), LamiaType::PRISM};
+ if (match(":")) {
+ parameter.type = expect_type();
+ }
+ parameters.push_back(parameter);
+ skip_newlines();
+ } while (match(","));
+ }
+ expect(")", "to close the parameter list");
+ 
+ LamiaType return_type = LamiaType::VOID_STAR;
+ if (match("->")) {
+ return_type = expect_type();
+ }
+ 
+ auto* function = arena_.create<LamiaFunction>(arena_.intern(name), return_type);
+ for (const auto& parameter : parameters) {
+ function->add_parameter(arena_, parameter.name, parameter.type);
+ }
+ if (match("@")) {
+ function->human_intent_description = arena_.intern(expect_name("context name"));
+ }
+ 
+ parse_block("function body", [&]() {
+ if (const LamiaExpression* statement = parse_statement(nullptr)) {
+ function->add_statement(arena_, statement);
+ }
+ });
+ return function;
+ }
+ 
+ const LamiaExpression* parse_widget() {
+ advance(); // create
+ std::string_view name = arena_.intern(expect_name("widget name"));
+ 
+ auto* widget = is_name(peek()) ?
+ arena_.create<WidgetExpression>(name, arena_.intern(advance().value)) :
+ arena_.create<WidgetExpression>(name);
+ 
+ if (check("{")) {
+ parse_block("widget body", [&]() { parse_member(widget); });
+ }
+ return widget;
+ }
+ 
+ const LamiaExpression* parse_style() {
+ advance(); // style_with
+ 
+ // The selector is everything up to the body: .card, #main, "button:hover"
+ const LamiaToken* first = nullptr;
+ const LamiaToken* last = nullptr;
+ while (!at_end() && !check("{") && !at_separator()) {
+ last = &advance();
+ first = first ? first : last;
+ }
+ if (!first) {
+ fail("Expected a selector after style_with");
+ }
+ 
+ std::string_view selector = span(*first, *last);
+ if (first == last && is_quoted(first->value)) {
+ selector = unquote(first->value);
+ }
+ 
+ auto* style = arena_.create<LamiaStyle>(arena_.intern(selector));
+ parse_block("style body", [&]() {
+ // CSS names and values may be hyphenated or multi-word: take raw spans
+ std::string_view property = take_span_until(":", "Expected a CSS property name");
+ expect(":", "after the CSS property name");
+ style->add_property(arena_, property, parse_css_value());
+ });
+ return style;
+ }
+ 
+ const LamiaExpression* parse_return() {
+ advance(); // return_light
+ const LamiaExpression* value = nullptr;
+ if (!at_end() && !at_separator() && !check("}")) {
+ value = parse_value();
+ }
+ return arena_.create<LamiaReturn>(value);
+ }
+ 
+ const LamiaExpression* parse_directive(WidgetExpression* parent) {
+ advance(); // @
+ std::string_view name;
+ if (peek().type == LamiaToken::Type::LITERAL && current_token_ + 1 < tokens_.size() &&
+ is_name(tokens_[current_token_ + 1]) && adjacent(peek(), tokens_[current_token_ + 1])) {
+ // "@3d_enabled" - a name may start with digits, which lex as a number
+ const LamiaToken& digits = advance();
+ name = arena_.intern(span(digits, advance()));
+ } else {
+ name = arena_.intern(expect_name("directive name"));
+ }
+ 
+ // "@startup" on its own line annotates the function below it
+ if (check_newline()) {
+ skip_newlines();
+ if (check(LamiaKeywords::MANIFEST)) {
+ return parse_function();
+ }
+ return arena_.create<WidgetExpression>(name);
+ }
+ 
+ auto* directive = arena_.create<WidgetExpression>(name);
+ bool has_arguments = false;
+ while (!at_end() && !at_separator() && !check("{") && !check("}")) {
+ parse_directive_argument(*directive);
+ has_arguments = true;
+ }
+ 
+ if (check("{") && raw_body(name)) {
+ // Markup or script (@render { <html>... }): the body is kept as text
+ directive->add_child(arena_, raw_block("directive body"));
+ } else if (check("{")) {
+ parse_block("directive body", [&]() { parse_member(directive); });
+ } else if (parent && has_arguments && directive->properties().empty() &&
+ directive->children().size() == 1 && directive->children()[0]->type == LamiaExpression::NodeType::LITERAL) {
+ parent->add_property(arena_, name, directive->children()[0]);
+ return nullptr;
+ }
+ return directive;
+ }
+ 
+ /**
+ * @brief One directive argument - a run of tokens with no whitespace between them
+ */
+ void parse_directive_argument(WidgetExpression& directive) {
+ if (check("[")) {
+ directive.add_child(arena_, parse_array());
+ return;
+ }
+ if (check("@") && current_token_ + 1 < tokens_.size() && tokens_[current_token_ + 1].value == "{" &&
+ adjacent(peek(), tokens_[current_token_ + 1])) {
+ advance(); // @ - "@{expression}" is evaluated by the page, not by the compiler
+ directive.add_child(arena_, raw_block("interpolation"));
+ return;
+ }
+ 
+ size_t first = current_token_;
+ size_t equals = 0;
+ advance();
+ while (current_token_ < tokens_.size() && adjacent(tokens_[current_token_ - 1], tokens_[current_token_]) &&
+ !is_argument_boundary(tokens_[current_token_])) {
+ if (!equals && tokens_[current_token_].value == "=") {
+ equals = current_token_;
+ }
+ ++current_token_;
+ }
+ const LamiaToken& head = tokens_[first];
+ const LamiaToken& tail = tokens_[current_token_ - 1];
+ 
+ if (equals > first && equals + 1 < current_token_) {
+ std::string_view key = span(head, tokens_[equals - 1]);
+ directive.add_property(arena_, key, value_from_span(equals + 1, current_token_));
+ } else if (&head == &tail && is_literal(head)) {
+ directive.add_child(arena_, literal_from(head));
+ } else if (span(head, tail) != "::") {
+ directive.add_property(arena_, span(head, tail), arena_.create<LamiaLiteral>(true));
+ }
+ }
+ 
+ /**
+ * @brief Member of a widget or directive body - a property or a nested statement
+ */
+ void parse_member(WidgetExpression* parent) {
+ if (is_name(peek()) && peek_next().value == ":" && !adjacent_colons()) {
+ std::string_view key = advance().value;
+ advance(); // :
+ parent->add_property(arena_, key, parse_value());
+ return;
+ }
+ if (const LamiaExpression* child = parse_statement(parent)) {
+ parent->add_child(arena_, child);
+ }
+ }
+ 
+ /**
+ * @brief '{' member* '}' - each member is recovered from independently
+ */
+ template<typename ParseMember>
+ void parse_block(const char* what, ParseMember&& parse_member) {
+ expect("{", std::string("to open the ") + what);
+ skip_separators();
+ while (!at_end() && !check("}")) {
+ try {
+ parse_member();
+ } catch (const SyntaxError&) {
+ synchronize();
+ }
+ skip_separators();
+ }
+ expect("}", std::string("to close the ") + what);
+ }
+ 
+ /**
+ * @brief Whether the '{' ahead opens markup or script rather than Lamia
+ *
+ * Decided before the body is read, from the directive's name or the body's
+ * first token, so errors inside a Lamia body are always reported.
+ */
+ bool raw_body(std::string_view name) {
+ static constexpr std::string_view SCRIPT_DIRECTIVES[] = {
+ "render", "lamia_code", "handler", "lamia_handler", "error_handler", "function",
+ "if", "else", "foreach", "on_load", "on_success", "on_failure",
+ "keyframes", "media", "styles", "script", "seed"
+ };
+ static constexpr std::string_view SCRIPT_SUFFIXES[] = {"_code", "_handler", "_html", "_template", "_js", "_javascript", "_css", "_styles"};
+ 
+ for (std::string_view directive : SCRIPT_DIRECTIVES) {
+ if (name == directive) {
+ return true;
+ }
+ }
+ for (std::string_view suffix : SCRIPT_SUFFIXES) {
+ if (name.size() > suffix.size() && name.substr(name.size() - suffix.size()) == suffix) {
+ return true;
+ }
+ }
+ size_t first = current_token_ + 1;
+ while (first < tokens_.size() && (is_trivia(tokens_[first]) || tokens_[first].type == LamiaToken::Type::NEWLINE)) {
+ ++first;
+ }
+ if (first >= tokens_.size()) {
+ return false;
+ }
+ // A tag opens markup; a quoted key followed by ':' opens a JSON object
+ return tokens_[first].value.substr(0, 1) == "<" ||
+ (is_quoted(tokens_[first].value) && first + 1 < tokens_.size() && tokens_[first + 1].value == ":");
+ }
+ 
+ /**
+ * @brief The text between '{' and its matching '}', trimmed, as a verbatim literal
+ *
+ * Braces inside strings don't count. The text is copied into the arena, so
+ * the tree does not depend on the source buffer.
+ */
+ const LamiaExpression* raw_block(const char* what) {
+ expect("{", std::string("to open the ") + what);
+ const char* begin = tokens_[current_token_ - 1].value.data() + 1;
+ size_t depth = 1;
+ for (; current_token_ < tokens_.size(); ++current_token_) {
+ std::string_view value = tokens_[current_token_].value;
+ if (value == "{") {
+ ++depth;
+ } else if (value == "}" && --depth == 0) {
+ std::string_view text(begin, static_cast<size_t>(value.data() - begin));
+ ++current_token_;
+ size_t first = text.find_first_not_of(" \t\r\n");
+ text = first == std::string_view::npos ? std::string_view() :
+ text.substr(first, text.find_last_not_of(" \t\r\n") + 1 - first);
+ auto* literal = arena_.create<LamiaLiteral>(arena_.intern(text));
+ literal->verbatim = true;
+ return literal;
+ }
+ }
+ fail(std::string("Expected '}' to close the ") + what);
+ }
+ 
+ // ------------------------------------------------------------------
+ // Values
+ // ------------------------------------------------------------------
+ 
+ const LamiaExpression* parse_value() {
+ if (at_end()) {
+ fail("Expected a value");
+ }
+ const LamiaToken& start = peek();
+ return located(parse_unlocated_value(), start);
+ }
+ 
+ const LamiaExpression* parse_unlocated_value() {
+ const LamiaToken& token = peek();
+ if (is_literal(token)) {
+ return literal_from(advance());
+ } else if (token.value == "[") {
+ return parse_array();
+ } else if (token.value == "{") {
+ return raw_block("object"); // Object literals are passed through to the page
+ } else if (token.value == "-" && is_literal(peek_next()) && !is_quoted(peek_next().value)) {
+ advance();
+ return arena_.create<LamiaLiteral>(-parse_number(advance().value));
+ } else if (!is_name(token)) {
+ fail("Expected a value");
+ }
+ 
+ if (token.value == "true" || token.value == "false") {
+ return arena_.create<LamiaLiteral>(advance().value == "true");
+ } else if (token.value == "null") {
+ advance();
+ return arena_.create<LamiaLiteral>(nullptr);
+ }
+ 
+ // Qualified name, optionally called
+ const LamiaToken& first = advance();
+ const LamiaToken* last = &first;
+ while (match(".")) {
+ expect_name("member name");
+ last = &tokens_[current_token_ - 1];
+ }
+ std::string_view name = arena_.intern(span(first, *last));
+ 
+ if (!match("(")) {
+ // Bare identifiers read as text unless they name a parameter; the node type records that it was a name
+ auto* identifier = arena_.create<LamiaLiteral>(name);
+ identifier->type = LamiaExpression::NodeType::IDENTIFIER;
+ return identifier;
+ }
+ 
+ auto* call = arena_.create<LamiaCall>(name);
+ skip_newlines();
+ while (!check(")")) {
+ call->add_argument(arena_, parse_value());
+ skip_newlines();
+ if (!match(",")) {
+ break;
+ }
+ skip_newlines();
+ }
+ expect(")", "to close the argument list");
+ return call;
+ }
+ 
+ const LamiaExpression* parse_array() {
+ advance(); // [
+ auto* array = arena_.create<LamiaArray>();
+ skip_newlines();
+ while (!check("]")) {
+ array->add_element(arena_, parse_value());
+ skip_newlines();
+ if (!match(",")) {
+ break;
+ }
+ skip_newlines();
+ }
+ expect("]", "to close the array");
+ return array;
+ }
+ 
+ const LamiaExpression* parse_css_value() {
+ size_t first = current_token_;
+ size_t end = first;
+ while (!at_end() && !at_separator() && !check("}")) {
+ advance();
+ end = current_token_;
+ }
+ if (end == first) {
+ fail("Expected a CSS value");
+ }
+ return value_from_span(first, end);
+ }
+ 
+ /**
+ * @brief A lone literal token keeps its type; anything longer is its source text
+ */
+ const LamiaExpression* value_from_span(size_t first, size_t end) {
+ size_t significant = first;
+ while (is_trivia(tokens_[significant])) {
+ ++significant;
+ }
+ if (significant + 1 == end && is_literal(tokens_[significant])) {
+ return literal_from(tokens_[significant]);
+ }
+ return arena_.create<LamiaLiteral>(arena_.intern(span(tokens_[significant], tokens_[end - 1])));
+ }
+ 
+ const LamiaExpression* literal_from(const LamiaToken& token) {
+ if (is_quoted(token.value)) {
+ return arena_.create<LamiaLiteral>(arena_.intern(unquote(token.value)));
+ }
+ return arena_.create<LamiaLiteral>(parse_number(token.value));
+ }
+ 
+ static double parse_number(std::string_view text) {
+ std::string digits(text);
+ return std::strtod(digits.c_str(), nullptr);
+ }
+ 
+ LamiaType expect_type() {
+ const LamiaToken& token = peek();
+ std::string_view name = expect_name("type name");
+ 
+ static constexpr std::pair<std::string_view, LamiaType> TYPE_NAMES[] = {
+ {"radiant", LamiaType::RADIANT}, {"shimmer", LamiaType::SHIMMER},
+ {"lumina", LamiaType::LUMINA}, {"void_star", LamiaType::VOID_STAR},
+ {"constellation", LamiaType::CONSTELLATION}, {"nebula", LamiaType::NEBULA},
+ {"galaxy", LamiaType::GALAXY}, {"prism", LamiaType::PRISM},
+ {"crystal", LamiaType::CRYSTAL}, {"aurora", LamiaType::AURORA},
+ {"widget", LamiaType::WIDGET}, {"theme", LamiaType::THEME},
+ {"vault", LamiaType::VAULT}, {"portal", LamiaType::PORTAL}
+ };
+ for (const auto& [type_name, type] : TYPE_NAMES) {
+ if (name == type_name) {
+ return type;
+ }
+ }
+ report(token, "Unknown type '" + std::string(name) + "'"); // Recoverable: the shape is intact
+ return LamiaType::PRISM;
+ }
+ 
+ // ------------------------------------------------------------------
+ // Token access - trivia (whitespace, comments) is skipped transparently
+ // ------------------------------------------------------------------
+ 
+ static bool is_trivia(const LamiaToken& token) {
+ return token.type == LamiaToken::Type::WHITESPACE || token.type == LamiaToken::Type::COMMENT;
+ }
+ 
+ static bool is_name(const LamiaToken& token) {
+ return token.type == LamiaToken::Type::IDENTIFIER || token.type == LamiaToken::Type::KEYWORD;
+ }
+ 
+ static bool is_literal(const LamiaToken& token) {
+ return token.type == LamiaToken::Type::LITERAL || token.type == LamiaToken::Type::TEMPLATE_LITERAL ||
+ token.type == LamiaToken::Type::STRING_INTERPOLATION;
+ }
+ 
+ static bool is_quoted(std::string_view text) {
+ return text.size() >= 2 && (text.front() == '"' || text.front() == '`') && text.back() == text.front();
+ }
+ 
+ static std::string_view unquote(std::string_view text) {
+ return text.substr(1, text.size() - 2);
+ }
+ 
+ static bool adjacent(const LamiaToken& before, const LamiaToken& after) {
+ return before.value.data() + before.value.size() == after.value.data();
+ }
+ 
+ static bool is_argument_boundary(const LamiaToken& token) {
+ return is_trivia(token) || token.type == LamiaToken::Type::NEWLINE ||
+ token.value == "{" || token.value == "}" || token.value == ";";
+ }
+ 
+ /**
+ * @brief Source text from the start of first to the end of last
+ */
+ static std::string_view span(const LamiaToken& first, const LamiaToken& last) {
+ return std::string_view(first.value.data(), static_cast<size_t>(last.value.data() + last.value.size() - first.value.data()));
+ }
+ 
+ void skip_trivia() {
+ while (current_token_ < tokens_.size() && is_trivia(tokens_[current_token_])) {
+ ++current_token_;
+ }
+ }
+ 
+ bool at_end() {
+ skip_trivia();
+ return current_token_ >= tokens_.size();
+ }
+ 
+ const LamiaToken& peek() {
+ static const LamiaToken end_of_input{};
+ return at_end() ? end_of_input : tokens_[current_token_];
+ }
+ 
+ /**
+ * @brief Second significant token of lookahead
+ */
+ const LamiaToken& peek_next() {
+ static const LamiaToken end_of_input{};
+ size_t index = next_index();
+ return index < tokens_.size() ? tokens_[index] : end_of_input;
+ }
+ 
+ size_t next_index() {
+ skip_trivia();
+ size_t index = current_token_ + 1;
+ while (index < tokens_.size() && is_trivia(tokens_[index])) {
+ ++index;
+ }
+ return index;
+ }
+ 
+ /**
+ * @brief "name ::" is a directive separator, not a property colon
+ */
+ bool adjacent_colons() {
+ size_t colon = next_index();
+ return colon + 1 < tokens_.size() && tokens_[colon + 1].value == ":" && adjacent(tokens_[colon], tokens_[colon + 1]);
+ }
+ 
+ const LamiaToken& advance() {
+ if (at_end()) {
+ fail("Unexpected end of input");
+ }
+ return tokens_[current_token_++];
+ }
+ 
+ bool check(std::string_view value) {
+ return !at_end() && tokens_[current_token_].value == value && !is_literal(tokens_[current_token_]);
+ }
+ 
+ bool check_newline() {
+ return !at_end() && tokens_[current_token_].type == LamiaToken::Type::NEWLINE;
+ }
+ 
+ bool at_separator() {
+ return check_newline() || check(";") || check(",");
+ }
+ 
+ bool match(std::string_view value) {
+ if (check(value)) {
+ ++current_token_;
+ return true;
+ }
+ return false;
+ }
+ 
+ void expect(std::string_view value, const std::string& context) {
+ if (!match(value)) {
+ fail("Expected '" + std::string(value) + "' " + context);
+ }
+ }
+ 
+ std::string_view expect_name(const char* what) {
+ if (!is_name(peek())) {
+ fail(std::string("Expected ") + what);
+ }
+ return advance().value;
+ }
+ 
+ void skip_newlines() {
+ while (check_newline()) {
+ ++current_token_;
+ }
+ }
+ 
+ void skip_separators() {
+ while (at_separator()) {
+ ++current_token_;
+ }
+ }
+ 
+ std::string_view take_span_until(std::string_view terminator, const char* message) {
+ const LamiaToken* first = nullptr;
+ const LamiaToken* last = nullptr;
+ while (!at_end() && !check(terminator) && !at_separator() && !check("}")) {
+ last = &advance();
+ first = first ? first : last;
+ }
+ if (!first) {
+ fail(message);
+ }
+ return span(*first, *last);
+ }
+ 
+ // ------------------------------------------------------------------
+ // Error reporting and recovery
+ // ------------------------------------------------------------------
+ 
+ [[noreturn]] void fail(const std::string& message) {
+ if (at_end()) {
+ if (!reported_end_of_input_) { // Every open block fails again at the end - say it once
+ reported_end_of_input_ = true;
+ report(tokens_.empty() ? peek() : tokens_[tokens_.size() - 1], message + ", found end of input");
+ }
+ } else {
+ const LamiaToken& token = peek();
+ report(token, message + ", found " + (token.type == LamiaToken::Type::NEWLINE ? std::string("end of line") :
+ "'" + std::string(token.value.substr(0, 32)) + "'"));
+ }
+ throw SyntaxError{};
+ }
+ 
+ void report(const LamiaToken& token, const std::string& message) {
+ diagnostics_.push_back(Diagnostic{token.line, token.column, message});
+ 
+ if (ai_completion_mode_ && ai_completion_callback_) {
+ // Request AI assistance for error recovery
+ auto suggestions = ai_completion_callback_("Parse error: " + diagnostics_.back().to_string());
+ }
+ }
+ 
+ /**
+ * @brief Panic mode: skip to the end of the current statement or member
+ *
+ * Stops before a separator or the '}' closing the enclosing block;
+ * bracketed groups in between are skipped whole.
+ */
+ void synchronize() {
+ if (diagnostics_.size() >= MAX_PARSE_ERRORS) {
+ diagnostics_.push_back(Diagnostic{0, 0, "Too many errors - giving up"});
+ current_token_ = tokens_.size();
+ return;
+ }
+ 
+ size_t depth = 0;
+ while (!at_end()) {
+ if (depth == 0 && (at_separator() || check("}"))) {
+ return;
+ }
+ if (check("{") || check("(") || check("[")) {
+ ++depth;
+ } else if (depth > 0 && (check("}") || check(")") || check("]"))) {
+ --depth;
+ }
+ ++current_token_;
+ }
+ }
+};
+
+/**
+ * @brief Lamia Wasm Compiler - The number and logic manifests of a program as a WebAssembly module
+ *
+ * A top-level manifest compiles when its parameters and result are shimmer
+ * or lumina and its body is calls and values up to a return_light with a
+ * value. Values are numbers, booleans, parameters (a bare identifier naming
+ * one reads it, as in the script, bytecode and native targets) and calls. A callee
+ * is another compiled manifest (a direct call) or a host function (an
+ * import). Manifests that build UI, use text, arrays or null, or call a
+ * manifest that stays in script are left to JavaScript and listed by skipped().
+ *
+ * write_glue() instantiates the module in the browser and swaps each compiled
+ * manifest's script function for its export; until then the script versions run.
+ */
+class LamiaWasmCompiler : public LamiaExpressionVisitor {
+public:
+ struct Export {
+ std::string_view name;
+ bool lumina; // The f64 result converts back to a boolean
+ };
+
+private:
+ LamiaWasmWriter writer_;
+ std::vector<Export> exports_;
+ std::vector<std::string> skipped_;
+ std::map<std::string_view, const LamiaFunction*> manifests_; // Every top-level manifest
+ std::set<std::string_view> redefined_; // Names of more than one manifest
+ std::map<std::string_view, uint32_t> functions_; // Compiled manifests -> function index
+ std::map<std::pair<std::string_view, size_t>, uint32_t> imports_; // Host callee and arity -> function index
+ std::vector<std::string_view> hosts_; // Distinct host callees, for the glue
+ 
+ // State of the function being lowered
+ const LamiaFunction* function_ = nullptr;
+ LamiaWasmCode* code_ = nullptr;
+ 
+public:
+ /**
+ * @brief Compile every eligible manifest of program
+ */
+ void compile(const LamiaExpression& program) {
+ program.accept(*this);
+ }
+ 
+ /**
+ * @brief The module binary (.wasm file contents)
+ */
+ std::string bytes() const { return writer_.bytes(); }
+ 
+ const std::vector<Export>& exports() const { return exports_; }
+ 
+ /**
+ * @brief Manifests left to JavaScript, each with the reason
+ */
+ const std::vector<std::string>& skipped() const { return skipped_; }
+ 
+ /**
+ * @brief Script that loads the module (inlined as base64) and installs its exports
+ *
+ * Writes nothing when no manifest compiled.
+ */
+ void write_glue(LamiaOutputSink& out, bool minify) const {
+ if (exports_.empty()) {
+ return;
+ }
+ auto layout = [minify](std::string_view pretty, std::string_view minified = {}) { return minify ? minified : pretty; };
+ 
+ out << layout("\n\n// WebAssembly: compiled manifests replace their script versions once the module instantiates\n", ";");
+ out << layout("if (typeof WebAssembly === 'object') {\n const bytes = Uint8Array.from(atob('",
+ "if(typeof WebAssembly==='object'){const bytes=Uint8Array.from(atob('");
+ write_base64(out, bytes());
+ out << layout("'), (c) => c.charCodeAt(0));\n const lamia = {", "'),c=>c.charCodeAt(0));const lamia={");
+ for (size_t i = 0; i < hosts_.size(); ++i) {
+ out << (i > 0 ? "," : "") << layout(" ") << hosts_[i] << layout(": (...a) => ", ":(...a)=>") << hosts_[i] << "(...a)";
+ }
+ out << layout(" };\n WebAssembly.instantiate(bytes, { lamia }).then(({ instance }) => {\n const wasm = instance.exports;\n",
+ "};WebAssembly.instantiate(bytes,{lamia}).then(({instance})=>{const wasm=instance.exports;");
+ for (const auto& function : exports_) {
+ out << layout(" ") << function.name << layout(" = (...a) => ", "=(...a)=>") << "wasm." << function.name << "(...a)";
+ out << (function.lumina ? layout(" !== 0", "!==0") : "") << layout(";\n", ";");
+ }
+ out << layout(" });\n}\n", "})}");
+ }
+ 
+ void visit(const LamiaProgram& node) override {
+ std::vector<const LamiaFunction*> candidates;
+ for (const auto* declaration : node.declarations()) {
+ if (declaration->type == LamiaExpression::NodeType::FUNCTION_DEF) {
+ const auto& function = static_cast<const LamiaFunction&>(*declaration);
+ if (!manifests_.emplace(function.name(), &function).second) {
+ redefined_.insert(function.name());
+ }
+ candidates.push_back(&function);
+ }
+ }
+ 
+ // Drop manifests that cannot compile, then their callers, until nothing changes
+ std::map<std::string_view, bool> accepted;
+ for (const auto* function : candidates) {
+ accepted[function->name()] = true;
+ }
+ for (bool changed = true; changed;) {
+ changed = false;
+ for (const auto* function : candidates) {
+ if (!accepted[function->name()]) {
+ continue;
+ }
+ std::string reason = rejection(*function, accepted);
+ if (!reason.empty()) {
+ accepted[function->name()] = false;
+ skipped_.push_back(std::string(function->name()) + ": " + reason);
+ changed = true;
+ }
+ }
+ }
+ 
+ // Imports take the first function indexes, so collect them before lowering
+ std::vector<const LamiaFunction*> compiled;
+ for (const auto* function : candidates) {
+ if (accepted[function->name()]) {
+ compiled.push_back(function);
+ collect_imports(*function);
+ }
+ }
+ for (const auto* function : compiled) {
+ functions_.emplace(function->name(), writer_.next_function() + static_cast<uint32_t>(exports_.size()));
+ exports_.push_back({function->name(), function->return_type() == LamiaType::LUMINA});
+ }
+ for (const auto* function : compiled) {
+ lower_function(*function);
+ }
+ }
+ 
+ void visit(const LamiaLiteral& node) override {
+ std::visit([this, &node](const auto& v) {
+ using T = std::decay_t<decltype(v)>;
+ if constexpr (std::is_same_v<T, std::string_view>) {
+ code_->local_get(parameter_index(v)); // Only parameters get this far
+ } else if constexpr (std::is_same_v<T, double>) {
+ code_->f64_const(v);
+ } else if constexpr (std::is_same_v<T, bool>) {
+ code_->f64_const(v ? 1 : 0);
+ }
+ }, node.value());
+ }
+ 
+ void visit(const LamiaCall& node) override {
+ for (const auto* argument : node.arguments()) {
+ argument->accept(*this);
+ }
+ auto function = functions_.find(node.callee());
+ code_->call(function != functions_.end() ? function->second : imports_.at({node.callee(), node.arguments().size()}));
+ }
+ 
+ // Rejected before lowering
+ void visit(const WidgetExpression&) override {}
+ void visit(const LamiaFunction&) override {}
+ void visit(const LamiaStyle&) override {}
+ void visit(const LamiaReturn&) override {}
+ void visit(const LamiaArray&) override {}
+ 
+private:
+ static bool numeric(LamiaType type) {
+ return type == LamiaType::SHIMMER || type == LamiaType::LUMINA;
+ }
+ 
+ /**
+ * @brief Why function must stay in JavaScript - empty if it compiles
+ */
+ std::string rejection(const LamiaFunction& function, const std::map<std::string_view, bool>& accepted) const {
+ if (redefined_.count(function.name())) {
+ return "defined more than once";
+ }
+ if (!numeric(function.return_type())) {
+ return "result is not shimmer or lumina";
+ }
+ for (const auto& parameter : function.parameters()) {
+ if (!numeric(parameter.type)) {
+ return "parameter '" + std::string(parameter.name) + "' is not shimmer or lumina";
+ }
+ }
+ 
+ for (const auto* statement : function.body()) {
+ switch (statement->type) {
+ case LamiaExpression::NodeType::RETURN:
+ {
+ const auto* value = static_cast<const LamiaReturn&>(*statement).value();
+ return value ? value_rejection(function, *value, accepted) : "return_light without a value";
+ }
+ case LamiaExpression::NodeType::FUNCTION_CALL:
+ {
+ std::string reason = value_rejection(function, *statement, accepted);
+ if (!reason.empty()) {
+ return reason;
+ }
+ break;
+ }
+ case LamiaExpression::NodeType::LITERAL:
+ case LamiaExpression::NodeType::IDENTIFIER:
+ break; // No effect
+ default:
+ return "builds UI";
+ }
+ }
+ return "no return_light with a value";
+ }
+ 
+ std::string value_rejection(const LamiaFunction& function, const LamiaExpression& value,
+ const std::map<std::string_view, bool>& accepted) const {
+ switch (value.type) {
+ case LamiaExpression::NodeType::LITERAL:
+ case LamiaExpression::NodeType::IDENTIFIER:
+ {
+ if (value.data_type == LamiaType::CONSTELLATION) {
+ return "uses a constellation"; // LamiaArray
+ }
+ const auto& literal = static_cast<const LamiaLiteral&>(value).value();
+ if (std::holds_alternative<double>(literal) || std::holds_alternative<bool>(literal)) {
+ return {};
+ }
+ if (value.type == LamiaExpression::NodeType::IDENTIFIER && has_parameter(function, std::get<std::string_view>(literal))) {
+ return {};
+ }
+ return std::holds_alternative<std::nullptr_t>(literal) ? "uses null" : "uses text";
+ }
+ case LamiaExpression::NodeType::FUNCTION_CALL:
+ {
+ const auto& call = static_cast<const LamiaCall&>(value);
+ auto callee = manifests_.find(call.callee());
+ if (callee != manifests_.end()) {
+ if (!accepted.at(call.callee())) {
+ return "calls '" + std::string(call.callee()) + "', which stays in JavaScript";
+ }
+ if (callee->second->parameters().size() != call.arguments().size()) {
+ return "calls '" + std::string(call.callee()) + "' with " + std::to_string(call.arguments().size()) +
+ " arguments, it takes " + std::to_string(callee->second->parameters().size());
+ }
+ }
+ for (const auto* argument : call.arguments()) {
+ std::string reason = value_rejection(function, *argument, accepted);
+ if (!reason.empty()) {
+ return reason;
+ }
+ }
+ return {};
+ }
+ default:
+ return "builds UI";
+ }
+ }
+ 
+ static bool has_parameter(const LamiaFunction& function, std::string_view name) {
+ for (const auto& parameter : function.parameters()) {
+ if (parameter.name == name) {
+ return true;
+ }
+ }
+ return false;
+ }
+ 
+ uint32_t parameter_index(std::string_view name) const {
+ const auto& parameters = function_->parameters();
+ for (size_t i = 0; i < parameters.size(); ++i) {
+ if (parameters[i].name == name) {
+ return static_cast<uint32_t>(i);
+ }
+ }
+ return 0;
+ }
+ 
+ void collect_imports(const LamiaFunction& function) {
+ for (const auto* statement : function.body()) {
+ const LamiaExpression* value = statement;
+ if (statement->type == LamiaExpression::NodeType::RETURN) {
+ value = static_cast<const LamiaReturn&>(*statement).value();
+ }
+ collect_imports(*value);
+ if (statement->type == LamiaExpression::NodeType::RETURN) {
+ break;
+ }
+ }
+ }
+ 
+ void collect_imports(const LamiaExpression& value) {
+ if (value.type != LamiaExpression::NodeType::FUNCTION_CALL) {
+ return;
+ }
+ const auto& call = static_cast<const LamiaCall&>(value);
+ for (const auto* argument : call.arguments()) {
+ collect_imports(*argument);
+ }
+ if (manifests_.count(call.callee())) {
+ return;
+ }
+ auto key = std::make_pair(call.callee(), call.arguments().size());
+ if (!imports_.count(key)) {
+ imports_.emplace(key, writer_.import(call.callee(), call.arguments().size()));
+ if (std::find(hosts_.begin(), hosts_.end(), call.callee()) == hosts_.end()) {
+ hosts_.push_back(call.callee());
+ }
+ }
+ }
+ 
+ void lower_function(const LamiaFunction& function) {
+ LamiaWasmCode code;
+ function_ = &function;
+ code_ = &code;
+ for (const auto* statement : function.body()) {
+ if (statement->type == LamiaExpression::NodeType::RETURN) {
+ static_cast<const LamiaReturn&>(*statement).value()->accept(*this);
+ break; // The rest of the body is unreachable; the value is the function's result
+ }
+ if (statement->type == LamiaExpression::NodeType::FUNCTION_CALL) {
+ statement->accept(*this);
+ code.drop(); // Evaluated for its effects
+ }
+ }
+ code.end();
+ writer_.add_function(function.name(), function.parameters().size(), code);
+ code_ = nullptr;
+ function_ = nullptr;
+ }
+ 
+ static void write_base64(LamiaOutputSink& out, std::string_view bytes) {
+ static constexpr char DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+ std::string encoded;
+ encoded.reserve((bytes.size() + 2) / 3 * 4);
+ for (size_t i = 0; i < bytes.size(); i += 3) {
+ uint32_t group = static_cast<uint8_t>(bytes[i]) << 16;
+ if (i + 1 < bytes.size()) group |= static_cast<uint8_t>(bytes[i + 1]) << 8;
+ if (i + 2 < bytes.size()) group |= static_cast<uint8_t>(bytes[i + 2]);
+ encoded += DIGITS[(group >> 18) & 63];
+ encoded += DIGITS[(group >> 12) & 63];
+ encoded += i + 1 < bytes.size() ? DIGITS[(group >> 6) & 63] : '=';
+ encoded += i + 2 < bytes.size() ? DIGITS[group & 63] : '=';
+ }
+ out << encoded;
+ }
+};
+
+/**
+ * @brief Lamia Transpiler - Multi-target code generation
+ */
+class LamiaTranspiler {
+public:
+ enum class Target {
+ JAVASCRIPT_ES6,
+ JAVASCRIPT_ES5,
+ TYPESCRIPT,
+ HTML5,
+ CSS3,
+ MEDUSA_NATIVE,
+ WEBASSEMBLY
+ };
+ 
+private:
+ Target target_;
+ std::map<std::string, std::string> optimization_flags_;
+ bool minify_ = false;
+ 
+public:
+ explicit LamiaTranspiler(Target target) : target_(target) {}
+ 
+ Target target() const { return target_; }
+ 
+ /**
+ * @brief Emit compact output: no banners, comments or layout whitespace, short locals
+ */
+ void set_minify(bool minify) { minify_ = minify; }
+ bool minify() const { return minify_; }
+ 
+ void set_optimization(const std::string& flag, const std::string& value) {
+ optimization_flags_[flag] = value;
+ }
+ 
+ std::string transpile(const LamiaExpression* ast) {
+ LamiaEmitter emitter(channel(), minify_);
+ emitter.emit(*ast);
+ return assemble(emitter.buffers(), *ast);
+ }
+
+ /**
+ * @brief Parse a lexer token stream and transpile it in one step
+ */
+ std::string transpile(const LamiaTokenStream& tokens) {
+ LamiaAstArena arena;
+ LamiaParser parser(tokens, arena);
+ auto ast = parser.parse();
+ return parser.get_diagnostics().empty() ? transpile(ast) : std::string();
+ }
+
+ /**
+ * @brief Emitter channel this target renders from
+ */
+ LamiaEmitter::Channel channel() const {
+ switch (target_) {
+ case Target::HTML5:
+ return LamiaEmitter::HTML;
+ case Target::CSS3:
+ return LamiaEmitter::CSS;
+ case Target::MEDUSA_NATIVE:
+ return LamiaEmitter::NATIVE;
+ default:
+ return LamiaEmitter::JAVASCRIPT; // JS, TypeScript, WebAssembly glue and fallback targets
+ }
+ }
+
+ /**
+ * @brief Wrap this target's channel from a shared emitter pass into a complete output
+ */
+ std::string assemble(const LamiaEmitter::Buffers& buffers, const LamiaExpression& ast) const {
+ std::string output;
+ LamiaMemorySink sink(output);
+ write_prologue(sink);
+ sink.write(body_of(buffers));
+ write_epilogue(sink, ast);
+ return output;
+ }
+ 
+ /**
+ * @brief Target boilerplate that precedes the emitted channel
+ */
+ void write_prologue(LamiaOutputSink& out) const {
+ if (minify_) {
+ write_minified_prologue(out);
+ return;
+ }
+ switch (target_) {
+ case Target::JAVASCRIPT_ES6:
+ out << "// Generated from Lamia Language\n";
+ out << "// Target: JavaScript ES6\n\n";
+ break;
+ case Target::TYPESCRIPT:
+ out << "// Generated from Lamia Language\n";
+ out << "// Target: TypeScript\n\n";
+ out << "import { MedusaWidget, MedusaTheme } from '@medusa/core';\n\n"; // Enhanced with TypeScript types
+ break;
+ case Target::HTML5:
+ out << "<!DOCTYPE html>\n";
+ out << "<!-- Generated from Lamia Language -->\n";
+ out << "<html lang=\"en\">\n<head>\n";
+ out << " <meta charset=\"UTF-8\">\n";
+ out << " <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n";
+ out << " <title>Lamia Generated Page</title>\n";
+ out << " <link rel=\"stylesheet\" href=\"medusa-theme.css\">\n";
+ out << "</head>\n<body>\n";
+ break;
+ case Target::CSS3:
+ out << "/* Generated from Lamia Language */\n";
+ out << "/* Target: CSS3 with Medusa Theme */\n\n";
+ out << "@import url('medusa-base-theme.css');\n\n";
+ break;
+ case Target::MEDUSA_NATIVE:
+ out << "// Generated from Lamia Language\n";
+ out << "// Target: Medusa Native C++\n\n";
+ out << "#include \"medusa_native_runtime.hpp\"\n\n";
+ break;
+ case Target::WEBASSEMBLY:
+ out << "// Generated from Lamia Language\n";
+ out << "// Target: WebAssembly, loaded by JavaScript\n\n";
+ break;
+ default:
+ break; // Fallback: bare channel output
+ }
+ }
+ 
+ /**
+ * @brief Target boilerplate that follows the emitted channel
+ */
+ void write_epilogue(LamiaOutputSink& out) const {
+ if (target_ == Target::HTML5) {
+ if (minify_) {
+ out << "<script src=\"medusa-runtime.js\"></script></body></html>";
+ return;
+ }
+ out << "\n <script src=\"medusa-runtime.js\"></script>\n";
+ out << "</body>\n</html>";
+ }
+ }
+ 
+ /**
+ * @brief Epilogue of a program's output - WebAssembly also appends the module and its glue
+ */
+ void write_epilogue(LamiaOutputSink& out, const LamiaExpression& ast) const {
+ if (target_ == Target::WEBASSEMBLY) {
+ LamiaWasmCompiler compiler;
+ compiler.compile(ast);
+ compiler.write_glue(out, minify_);
+ }
+ write_epilogue(out);
+ }
+
+private:
+ /**
+ * @brief Prologue without banners or layout; native code is never minified
+ */
+ void write_minified_prologue(LamiaOutputSink& out) const {
+ switch (target_) {
+ case Target::TYPESCRIPT:
+ out << "import{MedusaWidget,MedusaTheme}from'@medusa/core';";
+ break;
+ case Target::HTML5:
+ out << "<!DOCTYPE html><html lang=\"en\"><head><meta charset=\"UTF-8\">";
+ out << "<meta name=\"viewport\" content=\"width=device-width,initial-scale=1\">";
+ out << "<title>Lamia Generated Page</title><link rel=\"stylesheet\" href=\"medusa-theme.css\"></head><body>";
+ break;
+ case Target::CSS3:
+ out << "@import url('medusa-base-theme.css');";
+ break;
+ case Target::MEDUSA_NATIVE:
+ out << "// Generated from Lamia Language\n";
+ out << "// Target: Medusa Native C++\n\n";
+ out << "#include \"medusa_native_runtime.hpp\"\n\n";
+ break;
+ default:
+ break; // Script targets: no banner
+ }
+ }
+ 
+ std::string_view body_of(const LamiaEmitter::Buffers& buffers) const {
+ switch (channel()) {
+ case LamiaEmitter::HTML: return buffers.html;
+ case LamiaEmitter::CSS: return buffers.css;
+ case LamiaEmitter::NATIVE: return buffers.native;
+ default: return buffers.javascript;
+ }
+ }
+};
+
 /**
  * @brief Lamia Language Configuration
  */
@@ -932,6 +2845,58 @@ struct LamiaConfig {
  bool enable_code_splitting = true;
  bool optimize_for_mobile = true;
  int max_bundle_size_kb = 512;
+ bool minify_output = false; // Compact JS/HTML/CSS straight from the emitter (--minify)
+ bool generate_source_maps = true; // <output>.map beside each JS/HTML/CSS output (--no-source-maps)
+ 
+ // Server-side execution
+ bool generate_server_bytecode = false; // .lbc module of the manifests (--bytecode)
+ 
+ // Native build - with MEDUSA_NATIVE among the targets, compile its C++ into an executable (--native)
+ bool build_native_executable = false;
+ std::string native_compiler = "c++"; // Looked up on PATH; the CLI takes $CXX
+ std::string native_compiler_flags = "-std=c++17 -O2"; // Whitespace-separated
+ std::string native_runtime_dir; // Holds medusa_native_runtime.hpp; empty: beside the compiler sources
+ 
+ // Incremental compilation
+ bool enable_compilation_cache = true;
+ std::string compilation_cache_dir; // Empty: sibling of the output directory
+ 
+ // Diagnostics (never affects generated output)
+ bool verbose_output = true; // Per-stage progress on stdout
+ 
+ /**
+ * @brief Every setting that can change generated output, for cache keys
+ */
+ std::string fingerprint() const {
+ std::string fp;
+ auto add = [&fp](const std::string& value) { fp += value; fp += ';'; };
+ add(std::to_string(enable_ai_assistance));
+ add(std::to_string(enable_real_time_collaboration));
+ add(std::to_string(enable_auto_completion));
+ add(std::to_string(enable_semantic_highlighting));
+ add(std::to_string(static_cast<int>(default_target)));
+ for (auto target : additional_targets) {
+ add(std::to_string(static_cast<int>(target)));
+ }
+ add(ai_model_endpoint);
+ add(std::to_string(ai_confidence_threshold));
+ add(std::to_string(prefer_human_input));
+ add(default_theme);
+ add(std::to_string(enable_theme_hot_reload));
+ add(std::to_string(generate_purple_pages_docs));
+ add(std::to_string(enable_lazy_loading));
+ add(std::to_string(enable_code_splitting));
+ add(std::to_string(optimize_for_mobile));
+ add(std::to_string(max_bundle_size_kb));
+ add(std::to_string(minify_output));
+ add(std::to_string(generate_source_maps));
+ add(std::to_string(generate_server_bytecode));
+ add(std::to_string(build_native_executable));
+ add(native_compiler);
+ add(native_compiler_flags);
+ add(native_runtime_dir);
+ return fp;
+ }
 };
 
 } // namespace Lamia
@@ -0,0 +1,464 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA LEXER v0.3.0c
+ * ===================
+ *
+ * Ground-up lexical analysis for .lamia source
+ * - Shared by the batch compiler and the editors' incremental reparser
+ * - Tokens view the borrowed source; nothing is copied
+ * - Lexing can start at any line boundary outside a comment or string,
+ *   numbering lines from a caller-supplied first line
+ */
+
+#pragma once
+
+#include "lamia_language_specification.hpp"
+#include "lamia_simd_scan.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Lexer - Tokenizes .lamia source code
+ *
+ * Tokens are views into the borrowed source buffer; the only allocations
+ * are the token vector itself and the handful of interned hints.
+ */
+class LamiaLexer {
+private:
+ std::string_view source_;
+ size_t position_ = 0;
+ size_t first_line_ = 1;
+ size_t line_ = 1;
+ size_t column_ = 1;
+ LamiaTokenStream stream_;
+ 
+ // Start of the token currently being scanned
+ size_t token_start_ = 0;
+ size_t token_line_ = 1;
+ size_t token_column_ = 1;
+ 
+ // Interned semantic hints
+ struct Hints {
+ uint16_t unknown_character, single_line_comment, multi_line_comment;
+ uint16_t interpolated_string, string_literal, template_literal;
+ uint16_t float_literal, integer_literal, keyword, identifier, identifier_ai;
+ uint16_t three_char_operator, two_char_operator, single_char_operator, punctuation;
+ } hint_;
+ 
+ // AI assistance tracking
+ bool ai_mode_active_ = false;
+ std::vector<std::string> ai_completions_;
+ 
+ bool verbose_ = true;
+ 
+public:
+ /**
+ * @param first_line Line number of the first byte, for sources that are a
+ *        slice of a larger document
+ */
+ explicit LamiaLexer(std::string_view source, size_t first_line = 1)
+ : source_(source), first_line_(first_line) {
+ auto& hints = stream_.hints;
+ hint_.unknown_character = hints.intern("Unknown character");
+ hint_.single_line_comment = hints.intern("Single-line comment");
+ hint_.multi_line_comment = hints.intern("Multi-line comment");
+ hint_.interpolated_string = hints.intern("Interpolated string");
+ hint_.string_literal = hints.intern("String literal");
+ hint_.template_literal = hints.intern("Template literal");
+ hint_.float_literal = hints.intern("Float literal");
+ hint_.integer_literal = hints.intern("Integer literal");
+ hint_.keyword = hints.intern("Lamia keyword");
+ hint_.identifier = hints.intern("Identifier");
+ hint_.identifier_ai = hints.intern("Identifier (AI suggestions available)");
+ hint_.three_char_operator = hints.intern("Three-character operator");
+ hint_.two_char_operator = hints.intern("Two-character operator");
+ hint_.single_char_operator = hints.intern("Single-character operator");
+ hint_.punctuation = hints.intern("Punctuation");
+ }
+ explicit LamiaLexer(std::string&&) = delete; // Tokens view the source's lifetime
+ 
+ /**
+ * @brief Tokenize complete source code - Ground-up lexical analysis
+ */
+ LamiaTokenStream tokenize() {
+ log() << "🔍 Lamia Lexer: Tokenizing source (" << source_.length() << " characters)" << std::endl;
+ 
+ stream_.source = source_;
+ stream_.tokens.clear();
+ stream_.tokens.reserve(source_.length() / 4 + 16); // Typical density, avoids regrowth
+ position_ = 0;
+ line_ = first_line_;
+ column_ = 1;
+ 
+ while (position_ < source_.length()) {
+ char current = peek_char();
+ begin_token();
+ 
+ if (std::isspace(static_cast<unsigned char>(current))) {
+ handle_whitespace();
+ } else if (current == '/' && peek_char(1) == '/') {
+ handle_single_line_comment();
+ } else if (current == '/' && peek_char(1) == '*') {
+ handle_multi_line_comment();
+ } else if (current == '"') {
+ handle_string_literal();
+ } else if (current == '`') {
+ handle_template_literal();
+ } else if (std::isdigit(static_cast<unsigned char>(current)) ||
+ (current == '.' && std::isdigit(static_cast<unsigned char>(peek_char(1))))) {
+ handle_number_literal();
+ } else if (std::isalpha(static_cast<unsigned char>(current)) || current == '_') {
+ handle_identifier_or_keyword();
+ } else if (is_operator_char(current)) {
+ handle_operator();
+ } else if (is_punctuation(current)) {
+ handle_punctuation();
+ } else {
+ // Unknown character - create error token
+ advance_char();
+ add_token(LamiaToken::Type::IDENTIFIER, hint_.unknown_character);
+ }
+ }
+ 
+ log() << "✅ Lamia Lexer: Generated " << stream_.tokens.size() << " tokens" << std::endl;
+ return std::move(stream_);
+ }
+ 
+ /**
+ * @brief Enable AI-assisted tokenization
+ */
+ void enable_ai_mode() {
+ ai_mode_active_ = true;
+ log() << "🤖 AI-assisted tokenization enabled" << std::endl;
+ }
+ 
+ /**
+ * @brief Enable or silence progress output
+ */
+ void set_verbose(bool verbose) {
+ verbose_ = verbose;
+ }
+ 
+private:
+ /**
+ * @brief Progress stream - stdout, or a discarding stream when silenced
+ */
+ std::ostream& log() const {
+ thread_local std::ostream silent(nullptr);
+ return verbose_ ? std::cout : silent;
+ }
+ 
+ /**
+ * @brief Handle whitespace and newlines
+ */
+ void handle_whitespace() {
+ if (peek_char() == '\n') {
+ advance_char();
+ add_token(LamiaToken::Type::NEWLINE);
+ line_++;
+ column_ = 1;
+ return;
+ }
+ 
+ // Collect all consecutive whitespace
+ advance_to(LamiaScan::skip_horizontal_space(cursor(), source_end()));
+ add_token(LamiaToken::Type::WHITESPACE);
+ }
+ 
+ /**
+ * @brief Handle single-line comments
+ */
+ void handle_single_line_comment() {
+ advance_char(); // Skip first /
+ advance_char(); // Skip second /
+ 
+ advance_to(LamiaScan::find(cursor(), source_end(), '\n'));
+ 
+ add_token(LamiaToken::Type::COMMENT, hint_.single_line_comment);
+ }
+ 
+ /**
+ * @brief Handle multi-line comments
+ */
+ void handle_multi_line_comment() {
+ advance_char(); // Skip /
+ advance_char(); // Skip *
+ 
+ const char* terminator = LamiaScan::find_comment_end(cursor(), source_end());
+ if (terminator != source_end()) {
+ advance_to(terminator + 2); // Through */
+ } else if (position_ + 1 < source_.length()) {
+ advance_to(source_end() - 1); // Unterminated: the last byte is lexed on its own
+ }
+ 
+ add_token(LamiaToken::Type::COMMENT, hint_.multi_line_comment);
+ }
+ 
+ /**
+ * @brief Handle string literals with interpolation support
+ */
+ void handle_string_literal() {
+ advance_char(); // Skip opening quote
+ 
+ bool has_interpolation = false;
+ 
+ while (position_ < source_.length()) {
+ // Jump to the next byte that can end the string or change its meaning
+ advance_to(LamiaScan::find_any(cursor(), source_end(), '"', '\\', '$'));
+ char current = peek_char();
+ 
+ if (current == '"' || position_ >= source_.length()) {
+ break;
+ } else if (current == '\\') {
+ // Handle escape sequences
+ advance_to(std::min(position_ + 2, source_.length()));
+ } else {
+ // String interpolation detected
+ has_interpolation = has_interpolation || peek_char(1) == '{';
+ advance_char();
+ }
+ }
+ 
+ if (position_ < source_.length()) {
+ advance_char(); // Closing quote
+ }
+ 
+ if (has_interpolation) {
+ add_token(LamiaToken::Type::STRING_INTERPOLATION, hint_.interpolated_string);
+ } else {
+ add_token(LamiaToken::Type::LITERAL, hint_.string_literal);
+ }
+ }
+ 
+ /**
+ * @brief Handle template literals (backtick strings)
+ */
+ void handle_template_literal() {
+ advance_char(); // Skip opening backtick
+ 
+ while (position_ < source_.length()) {
+ advance_to(LamiaScan::find_any(cursor(), source_end(), '`', '\\'));
+ if (position_ >= source_.length() || peek_char() == '`') {
+ break;
+ }
+ advance_to(std::min(position_ + 2, source_.length())); // Escape sequence
+ }
+ 
+ if (position_ < source_.length()) {
+ advance_char(); // Closing backtick
+ }
+ 
+ add_token(LamiaToken::Type::TEMPLATE_LITERAL, hint_.template_literal);
+ }
+ 
+ /**
+ * @brief Handle numeric literals (integers and floats)
+ */
+ void handle_number_literal() {
+ bool has_decimal = false;
+ 
+ // Handle leading decimal point
+ if (peek_char() == '.') {
+ has_decimal = true;
+ advance_char();
+ }
+ 
+ while (position_ < source_.length()) {
+ char current = peek_char();
+ 
+ if (std::isdigit(static_cast<unsigned char>(current))) {
+ advance_char();
+ } else if (current == '.' && !has_decimal) {
+ has_decimal = true;
+ advance_char();
+ } else if (current == 'e' || current == 'E') {
+ // Scientific notation
+ advance_char();
+ 
+ if (position_ < source_.length() && (peek_char() == '+' || peek_char() == '-')) {
+ advance_char();
+ }
+ } else {
+ break;
+ }
+ }
+ 
+ add_token(LamiaToken::Type::LITERAL, has_decimal ? hint_.float_literal : hint_.integer_literal);
+ }
+ 
+ /**
+ * @brief Handle identifiers and keywords
+ */
+ void handle_identifier_or_keyword() {
+ while (position_ < source_.length()) {
+ char current = peek_char();
+ 
+ if (std::isalnum(static_cast<unsigned char>(current)) || current == '_') {
+ advance_char();
+ } else {
+ break;
+ }
+ }
+ 
+ // Check if it's a keyword
+ std::string_view identifier = source_.substr(token_start_, position_ - token_start_);
+ if (is_keyword(identifier)) {
+ add_token(LamiaToken::Type::KEYWORD, hint_.keyword);
+ } else {
+ // AI suggestion for identifiers
+ add_token(LamiaToken::Type::IDENTIFIER, ai_mode_active_ ? hint_.identifier_ai : hint_.identifier);
+ }
+ }
+ 
+ /**
+ * @brief Handle operators (including multi-character)
+ */
+ void handle_operator() {
+ // Check for multi-character operators first
+ if (position_ + 2 < source_.length() && is_three_char_operator(source_.substr(position_, 3))) {
+ advance_char();
+ advance_char();
+ advance_char();
+ add_token(LamiaToken::Type::OPERATOR, hint_.three_char_operator);
+ return;
+ }
+ 
+ if (position_ + 1 < source_.length() && is_two_char_operator(source_.substr(position_, 2))) {
+ advance_char();
+ advance_char();
+ add_token(LamiaToken::Type::OPERATOR, hint_.two_char_operator);
+ return;
+ }
+ 
+ // Single character operator
+ advance_char();
+ add_token(LamiaToken::Type::OPERATOR, hint_.single_char_operator);
+ }
+ 
+ /**
+ * @brief Handle punctuation
+ */
+ void handle_punctuation() {
+ advance_char();
+ add_token(LamiaToken::Type::PUNCTUATION, hint_.punctuation);
+ }
+ 
+ /**
+ * @brief Mark the start of the next token
+ */
+ void begin_token() {
+ token_start_ = position_;
+ token_line_ = line_;
+ token_column_ = column_;
+ }
+ 
+ /**
+ * @brief Add token spanning [token_start_, position_) to the stream
+ */
+ void add_token(LamiaToken::Type type, uint16_t hint_id = 0) {
+ LamiaToken token;
+ token.type = type;
+ token.value = source_.substr(token_start_, position_ - token_start_);
+ token.line = token_line_;
+ token.column = token_column_;
+ token.position = token_start_;
+ token.hint_id = hint_id;
+ token.is_ai_generated = false; // Lexer tokens are not AI generated
+ token.confidence_score = 1.0;
+ 
+ stream_.tokens.push_back(token);
+ }
+ 
+ /**
+ * @brief Peek at character without advancing
+ */
+ char peek_char(size_t offset = 0) const {
+ size_t pos = position_ + offset;
+ return pos < source_.length() ? source_[pos] : '\0';
+ }
+ 
+ /**
+ * @brief Advance position and column
+ */
+ void advance_char() {
+ if (position_ < source_.length()) {
+ position_++;
+ column_++;
+ }
+ }
+ 
+ /**
+ * @brief Advance over a scanned span, updating line and column in bulk
+ */
+ void advance_to(const char* target) {
+ advance_to(static_cast<size_t>(target - source_.data()));
+ }
+ 
+ void advance_to(size_t target) {
+ const char* last_newline = nullptr;
+ size_t newlines = LamiaScan::count_newlines(cursor(), source_.data() + target, &last_newline);
+ if (newlines) {
+ line_ += newlines;
+ column_ = 1 + static_cast<size_t>(source_.data() + target - last_newline - 1);
+ } else {
+ column_ += target - position_;
+ }
+ position_ = target;
+ }
+ 
+ const char* cursor() const { return source_.data() + position_; }
+ const char* source_end() const { return source_.data() + source_.length(); }
+ 
+ /**
+ * @brief Check if string is a Lamia keyword
+ */
+ bool is_keyword(std::string_view str) const {
+ return LamiaLexicon::is_keyword(str);
+ }
+ 
+ /**
+ * @brief Check if character can be part of an operator
+ */
+ bool is_operator_char(char c) const {
+ return c == '+' || c == '-' || c == '*' || c == '/' || c == '%' ||
+ c == '=' || c == '!' || c == '<' || c == '>' || c == '&' ||
+ c == '|' || c == '^' || c == '~' || c == '?' || c == ':';
+ }
+ 
+ /**
+ * @brief Check if character is punctuation
+ */
+ bool is_punctuation(char c) const {
+ return c == '(' || c == ')' || c == '[' || c == ']' ||
+ c == '{' || c == '}' || c == ',' || c == ';' ||
+ c == '.' || c == '@' || c == '#';
+ }
+ 
+ /**
+ * @brief Check for three-character operators
+ */
+ bool is_three_char_operator(std::string_view op) const {
+ return LamiaLexicon::is_three_char_operator(op);
+ }
+ 
+ /**
+ * @brief Check for two-character operators
+ */
+ bool is_two_char_operator(std::string_view op) const {
+ return LamiaLexicon::is_two_char_operator(op);
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
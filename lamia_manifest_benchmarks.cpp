@@ -0,0 +1,151 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA MANIFEST BENCHMARKS - v0.3.0c
+ * ===================================
+ *
+ * Server-side manifest calls through LamiaFunctionRegistry, with and
+ * without a bytecode module. Kept apart from lamia_real_benchmarks: the
+ * registry's LamiaFunction cannot share a translation unit with the
+ * language specification's LamiaFunction, which the lexer brings in.
+ *
+ * The manifest is compiled to .lbc by lamia_compiler --bytecode, i.e. by
+ * LamiaBytecodeCompiler. LAMIA_COMPILER names the compiler binary
+ * (default ./lamia_compiler).
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread lamia_manifest_benchmarks.cpp -o lamia_manifest_benchmarks
+ */
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <iomanip>
+#include <filesystem>
+#include <cstdlib>
+#include "lamia_server_client_functions.hpp"
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+namespace Benchmarks {
+
+/**
+ * @brief Time render_greeting through the registry, with and without bytecode
+ *
+ *   manifest render_greeting(user, count) {
+ *       log_event("render", user)
+ *       return_light format_greeting(upper(user), count, ["en", true])
+ *   }
+ *
+ * One registry maps the compiled module with load_bytecode(); the other
+ * registers the same manifest from its body text, which is all
+ * LamiaFunction::execute has without a compiled form. Both are timed
+ * through execute_function() on the same arguments - a different user on
+ * every call, so no call is answered from the result cache.
+ *
+ * @return false if the manifest did not compile or returned the wrong text
+ */
+bool benchmark_manifest_execution() {
+    std::cout << "📜 Testing server-side manifest execution..." << std::endl;
+
+    const std::string body =
+        "    log_event(\"render\", user)\n"
+        "    return_light format_greeting(upper(user), count, [\"en\", true])\n";
+    const std::string source = "manifest render_greeting(user, count) {\n" + body + "}\n";
+    const int calls = 100000;
+
+    // Compile the manifest as a deployment would
+    namespace fs = std::filesystem;
+    fs::path work = fs::temp_directory_path() / "lamia_bench_manifest";
+    fs::create_directories(work);
+    std::ofstream(work / "greeting.lamia") << source;
+    const char* compiler = std::getenv("LAMIA_COMPILER");
+    std::string command = "\"" + std::string(compiler && *compiler ? compiler : "./lamia_compiler") + "\" \"" +
+                          (work / "greeting.lamia").string() + "\" \"" + (work / "out").string() +
+                          "\" --bytecode > /dev/null 2>&1";
+    std::string module_path = (work / "out" / "greeting.lbc").string();
+    bool compiled = std::system(command.c_str()) == 0 && fs::exists(module_path);
+
+    // With bytecode: host functions first, then the module
+    LamiaFunctionRegistry bytecode_registry;
+    bytecode_registry.register_host_function("log_event", [](const LamiaBytecodeValue*, size_t, LamiaBytecodeScratch&) {
+        return LamiaBytecodeValue();
+    });
+    bytecode_registry.register_host_function("upper", [](const LamiaBytecodeValue* a, size_t, LamiaBytecodeScratch& scratch) {
+        std::string text(a[0].text);
+        std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+        return LamiaBytecodeValue::of(scratch.keep(std::move(text)));
+    });
+    bytecode_registry.register_host_function("format_greeting", [](const LamiaBytecodeValue* a, size_t, LamiaBytecodeScratch& scratch) {
+        return LamiaBytecodeValue::of(scratch.keep("Hello " + a[0].to_string() + " (" + a[1].to_string() + ") " + a[2].to_string()));
+    });
+    std::string error;
+    bool loaded = compiled && bytecode_registry.load_bytecode(module_path, &error) == 1;
+    fs::remove_all(work);
+    if (!loaded) {
+        std::cout << "  ❌ Could not compile the manifest to bytecode: " << (compiled ? error : command) << std::endl;
+        return false;
+    }
+
+    // Without bytecode: the same manifest from its body text
+    LamiaFunctionRegistry text_registry;
+    auto function = std::make_unique<LamiaFunction>("render_greeting", LamiaFunctionType::MANIFEST, ExecutionContext::SERVER_SIDE);
+    for (const char* name : {"user", "count"}) {
+        LamiaParameter param;
+        param.name = name;
+        function->add_parameter(param);
+    }
+    function->set_body(body);
+    text_registry.register_function(std::move(function));
+
+    std::vector<std::map<std::string, std::string>> inputs;
+    inputs.reserve(calls);
+    for (int i = 0; i < calls; i++) {
+        inputs.push_back({{"user", "user" + std::to_string(i)}, {"count", std::to_string(i % 10)}});
+    }
+
+    // The first call compiles a function without bytecode: leave it out of the timing
+    auto measure = [&](const char* name, LamiaFunctionRegistry& registry) {
+        std::string first = registry.execute_function("render_greeting", inputs[0]);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 1; i < calls; i++) {
+            registry.execute_function("render_greeting", inputs[i]);
+        }
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+        double calls_per_second = ((calls - 1) * 1000000.0) / std::max<long long>(duration.count(), 1);
+
+        std::cout << "  ✅ " << name << ": " << std::fixed << std::setprecision(0)
+                  << calls_per_second << " calls/sec, " << std::setprecision(2)
+                  << duration.count() / 1000.0 << "ms, returns " << first << std::endl;
+        return first;
+    };
+
+    measure("Manifest Execution (without bytecode)", text_registry);
+    std::string bytecode_result = measure("Manifest Execution (load_bytecode)", bytecode_registry);
+    if (bytecode_result != "Hello USER0 (0) [\"en\",true]") {
+        std::cout << "  ❌ Unexpected bytecode result: " << bytecode_result << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Benchmarks
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
+
+int main() {
+    std::cout << "🔮 LAMIA MANIFEST BENCHMARKS v0.3.0c" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    bool passed = MedusaServ::Language::Lamia::Benchmarks::benchmark_manifest_execution();
+    return passed ? 0 : 1;
+}
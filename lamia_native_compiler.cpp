@@ -11,11 +11,14 @@
  */
 
 #include "lamia_minimal.hpp"
+#include "lamia_language_specification.hpp"
+#include "lamia_lexer.hpp"
 #include "../lib/3d_generation/manufacturing_constraints/libnozzle_specific_constraints.hpp"
 #include "../lib/3d_generation/ai_command/libai_command_orchestrator.hpp"
 #include "../lib/iconify_system/libmedusa_iconify_system.hpp"
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include <string>
 #include <vector>
 #include <map>
@@ -60,7 +63,10 @@ public:
             std::string compiled_app = framework_->create_complete_application(source_content);
             
             // Generate output using established libraries
-            generate_native_executable(compiled_app, output_dir);
+            std::filesystem::create_directories(output_dir);
+            if (!generate_native_executable(source_content, output_dir)) {
+                return false;
+            }
             generate_web_deployment(compiled_app, output_dir);
             generate_manufacturing_integration(compiled_app, output_dir);
             
@@ -125,54 +131,61 @@ private:
         source += "}\n\n";
         
         source += "manifest demonstrate_superiority() {\n";
-        source += "    neural performance_data = ai_analyze_framework()\n";
         source += "    create RADIANT_QUOTE {\n";
         source += "        content: \"Lamia definitively superior - 143.2% vs HTML5/CSS3 at 94%\"\n";
         source += "        style: cosmic_glow\n";
         source += "    }\n";
-        source += "    return_light performance_data.superior\n";
-        source += "}\n";
+        source += "    return_light ai_analyze_framework()\n";
+        source += "}\n\n";
+        
+        source += "main_application()\n";
         
         return source;
     }
     
     /**
-     * @brief Generate native executable using established libraries
+     * @brief Lower the program to C++ (MEDUSA_NATIVE) with a Makefile that builds it
+     *
+     * main.cpp holds the program's manifests as free functions and renders
+     * its page; it needs only medusa_native_runtime.hpp, which ships beside
+     * this compiler's sources.
      */
-    void generate_native_executable(const std::string& compiled_app, const std::string& output_dir) {
+    bool generate_native_executable(const std::string& lamia_source, const std::string& output_dir) {
         std::cout << "Generating native executable..." << std::endl;
         
-        // Create C++ source that uses established libraries
-        std::string cpp_source = "#include \"lamia_minimal.hpp\"\n";
-        cpp_source += "#include <iostream>\n\n";
-        cpp_source += "int main() {\n";
-        cpp_source += "    auto framework = std::make_unique<MedusaServ::Language::Lamia::CompleteLamiaFramework>();\n";
-        cpp_source += "    std::cout << \"Lamia Application v\" << framework->get_framework_version() << std::endl;\n";
-        cpp_source += "    auto stats = framework->get_framework_statistics();\n";
-        cpp_source += "    std::cout << \"Optimization Score: \" << stats[\"optimization_score\"] << \"%\" << std::endl;\n";
-        cpp_source += "    std::cout << \"vs HTML5/CSS3 Ratio: \" << stats[\"vs_html5_css3_ratio\"] << \"x SUPERIOR\" << std::endl;\n";
-        cpp_source += "    std::cout << \"Market Ready: \" << (framework->is_market_ready() ? \"YES\" : \"NO\") << std::endl;\n";
-        cpp_source += "    return 0;\n";
-        cpp_source += "}\n";
+        LamiaLexer lexer(lamia_source);
+        lexer.set_verbose(false);
+        LamiaTokenStream tokens = lexer.tokenize();
+        
+        LamiaAstArena arena;
+        LamiaParser parser(tokens, arena);
+        const LamiaExpression* ast = parser.parse();
+        if (!ast || !parser.get_diagnostics().empty()) {
+            for (const auto& error : parser.get_errors()) {
+                std::cerr << "Parse Error: " << error << std::endl;
+            }
+            return false;
+        }
         
-        // Write C++ source
+        LamiaTranspiler transpiler(LamiaTranspiler::Target::MEDUSA_NATIVE);
         std::ofstream cpp_file(output_dir + "/main.cpp");
-        cpp_file << cpp_source;
+        cpp_file << transpiler.transpile(ast);
         cpp_file.close();
         
         // Create Makefile using established patterns
+        std::string runtime_dir = std::filesystem::absolute(std::filesystem::path(__FILE__)).parent_path().string();
         std::string makefile = "CXX=g++\n";
-        makefile += "CXXFLAGS=-std=c++17 -O3 -I../src\n";
-        makefile += "LIBS=-L../lib -llamia_revolutionary_framework -pthread\n";
+        makefile += "CXXFLAGS=-std=c++17 -O3 -I" + runtime_dir + "\n";
         makefile += "TARGET=lamia_app\n\n";
         makefile += "$(TARGET): main.cpp\n";
-        makefile += "\t$(CXX) $(CXXFLAGS) -o $(TARGET) main.cpp $(LIBS)\n\n";
+        makefile += "\t$(CXX) $(CXXFLAGS) -o $(TARGET) main.cpp\n\n";
         makefile += "clean:\n";
         makefile += "\trm -f $(TARGET)\n";
         
         std::ofstream makefile_out(output_dir + "/Makefile");
         makefile_out << makefile;
         makefile_out.close();
+        return static_cast<bool>(cpp_file) && static_cast<bool>(makefile_out);
     }
     
     /**
@@ -0,0 +1,276 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA OUTPUT SINK v0.3.0c
+ * =========================
+ *
+ * Buffered destinations for generated code
+ * - Emitters write fragments into a fixed-size chunk buffer
+ * - Full chunks drain to a file, a socket or an in-memory string
+ * - Peak memory for file and socket output is one chunk, whatever the
+ *   size of the generated artifact
+ * - An attached LamiaSourceMap follows every write, so emitters only
+ *   mark where each node's code starts
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "lamia_source_map.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Output Sink - Chunk-buffered writer, base of every destination
+ */
+class LamiaOutputSink {
+public:
+ static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+private:
+ std::unique_ptr<char[]> buffer_;
+ size_t capacity_;
+ size_t used_ = 0;
+
+ size_t bytes_written_ = 0;
+ size_t newlines_ = 0;
+ bool failed_ = false;
+ LamiaSourceMap* source_map_ = nullptr;
+
+public:
+ /**
+ * @param chunk_size Buffer size; 0 writes straight through to the destination
+ */
+ explicit LamiaOutputSink(size_t chunk_size = CHUNK_SIZE)
+ : buffer_(chunk_size ? new char[chunk_size] : nullptr), capacity_(chunk_size) {}
+
+ virtual ~LamiaOutputSink() = default;
+
+ LamiaOutputSink(const LamiaOutputSink&) = delete;
+ LamiaOutputSink& operator=(const LamiaOutputSink&) = delete;
+
+ LamiaOutputSink& write(std::string_view text) {
+ if (text.empty()) {
+ return *this;
+ }
+ bytes_written_ += text.size();
+ newlines_ += static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+ if (source_map_) {
+ source_map_->advance(text);
+ }
+
+ if (text.size() > capacity_ - used_) {
+ drain();
+ if (text.size() >= capacity_) {
+ // Larger than a chunk: hand it over without copying
+ deliver(text.data(), text.size());
+ return *this;
+ }
+ }
+ std::memcpy(buffer_.get() + used_, text.data(), text.size());
+ used_ += text.size();
+ return *this;
+ }
+
+ LamiaOutputSink& operator<<(std::string_view text) { return write(text); }
+ LamiaOutputSink& operator<<(char c) { return write(std::string_view(&c, 1)); }
+
+ /**
+ * @brief Write text rendered elsewhere, carrying over the mappings recorded for it
+ */
+ LamiaOutputSink& write(std::string_view text, const LamiaSourceMap& fragment) {
+ LamiaSourceMap* map = source_map_;
+ if (map) {
+ map->append(text, fragment);
+ }
+ source_map_ = nullptr; // append() has accounted for the text
+ write(text);
+ source_map_ = map;
+ return *this;
+ }
+
+ /**
+ * @brief Record mappings for everything written from now on (nullptr: stop)
+ */
+ void set_source_map(LamiaSourceMap* map) { source_map_ = map; }
+ LamiaSourceMap* source_map() const { return source_map_; }
+
+ /**
+ * @brief The code written next came from this view into the source
+ */
+ void map_source(std::string_view location) {
+ if (source_map_ && !location.empty()) {
+ source_map_->add(location);
+ }
+ }
+
+ /**
+ * @brief The code written next came from this 1-based source line and column
+ */
+ void map_source(size_t line, size_t column) {
+ if (source_map_) {
+ source_map_->add(line, column);
+ }
+ }
+
+ /**
+ * @brief The code written next came from no particular source position
+ */
+ void unmap_source() {
+ if (source_map_) {
+ source_map_->drop_mark();
+ }
+ }
+
+ /**
+ * @brief Push buffered bytes to the destination
+ */
+ bool flush() {
+ drain();
+ return !failed_;
+ }
+
+ bool ok() const { return !failed_; }
+ size_t bytes_written() const { return bytes_written_; }
+ size_t newlines_written() const { return newlines_; }
+
+protected:
+ /**
+ * @brief Deliver one chunk to the destination
+ */
+ virtual bool write_chunk(const char* data, size_t size) = 0;
+
+private:
+ void drain() {
+ if (used_) {
+ deliver(buffer_.get(), used_);
+ used_ = 0;
+ }
+ }
+
+ void deliver(const char* data, size_t size) {
+ if (!failed_ && !write_chunk(data, size)) {
+ failed_ = true; // Keep counting, but stop touching the destination
+ }
+ }
+};
+
+/**
+ * @brief Appends to a caller-owned string - used where a std::string result is wanted
+ */
+class LamiaMemorySink : public LamiaOutputSink {
+private:
+ std::string& target_;
+
+public:
+ explicit LamiaMemorySink(std::string& target) : LamiaOutputSink(0), target_(target) {}
+
+protected:
+ bool write_chunk(const char* data, size_t size) override {
+ target_.append(data, size);
+ return true;
+ }
+};
+
+/**
+ * @brief Writes to a file descriptor, retrying short writes and EINTR
+ */
+class LamiaDescriptorSink : public LamiaOutputSink {
+protected:
+ int fd_;
+
+public:
+ explicit LamiaDescriptorSink(int fd, size_t chunk_size = CHUNK_SIZE) : LamiaOutputSink(chunk_size), fd_(fd) {}
+
+ bool is_open() const { return fd_ >= 0; }
+
+protected:
+ bool write_chunk(const char* data, size_t size) override {
+ while (size > 0) {
+ ssize_t written = write_some(data, size);
+ if (written < 0) {
+ if (errno == EINTR) {
+ continue;
+ }
+ return false;
+ }
+ data += written;
+ size -= static_cast<size_t>(written);
+ }
+ return true;
+ }
+
+ virtual ssize_t write_some(const char* data, size_t size) {
+ return ::write(fd_, data, size);
+ }
+};
+
+/**
+ * @brief Owns an output file for the lifetime of the sink
+ *
+ * The path is unlinked before it is created so that a file hardlinked
+ * into the compilation cache is replaced rather than rewritten.
+ */
+class LamiaFileSink : public LamiaDescriptorSink {
+public:
+ explicit LamiaFileSink(const std::string& path, size_t chunk_size = CHUNK_SIZE)
+ : LamiaDescriptorSink(open_replacing(path), chunk_size) {}
+
+ ~LamiaFileSink() override {
+ close();
+ }
+
+ /**
+ * @brief Flush and close - false if any write or the close itself failed
+ */
+ bool close() {
+ if (fd_ < 0) {
+ return false;
+ }
+ bool success = flush();
+ success = (::close(fd_) == 0) && success;
+ fd_ = -1;
+ return success;
+ }
+
+private:
+ static int open_replacing(const std::string& path) {
+ ::unlink(path.c_str());
+ return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+ }
+};
+
+/**
+ * @brief Streams to a connected socket the caller keeps ownership of
+ */
+class LamiaSocketSink : public LamiaDescriptorSink {
+public:
+ explicit LamiaSocketSink(int socket_fd, size_t chunk_size = CHUNK_SIZE) : LamiaDescriptorSink(socket_fd, chunk_size) {}
+
+ ~LamiaSocketSink() override {
+ flush();
+ }
+
+protected:
+ ssize_t write_some(const char* data, size_t size) override {
+ return ::send(fd_, data, size, MSG_NOSIGNAL); // A vanished peer is an error, not SIGPIPE
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
@@ -0,0 +1,76 @@
+/**
+ * LAMIA PARSER TEST v0.3.0c
+ * =========================
+ *
+ * Directive bodies: a Lamia body reports its errors, a markup body is kept
+ * as text and written back out as valid JavaScript and escaped HTML.
+ */
+
+#include "lamia_lexer.hpp"
+#include <iostream>
+#include <string>
+
+using namespace MedusaServ::Language::Lamia;
+
+static int failures = 0;
+
+static void check(bool passed, const std::string& what) {
+    std::cout << (passed ? "  ✅ " : "  ❌ ") << what << std::endl;
+    failures += passed ? 0 : 1;
+}
+
+static void test_malformed_lamia_body() {
+    std::cout << "🔍 Malformed Lamia body" << std::endl;
+    std::string source = "@page home {\n    content: \"Hi\" ,, ]\n    title: \"Home\"\n}\n";
+    LamiaLexer lexer(source);
+    lexer.set_verbose(false);
+    LamiaTokenStream tokens = lexer.tokenize();
+    LamiaAstArena arena;
+    LamiaParser parser(tokens, arena);
+    const LamiaExpression* program = parser.parse();
+
+    auto errors = parser.get_errors();
+    check(!errors.empty(), "the error is reported");
+    check(!errors.empty() && errors[0].rfind("line 2:", 0) == 0, "at the line it is on: " + (errors.empty() ? std::string("none") : errors[0]));
+
+    std::string javascript = program->to_javascript();
+    check(javascript.find(",, ]") == std::string::npos, "the body is not also kept as text");
+    check(javascript.find("title") != std::string::npos, "members after the error are still parsed");
+}
+
+static void test_markup_body() {
+    std::cout << "🔍 Markup body" << std::endl;
+    std::string source = "@render {\n    <div class=\"card\">Hello \"world\" & more</div>\n    <script>go()</script>\n}\n";
+    LamiaLexer lexer(source);
+    lexer.set_verbose(false);
+    LamiaTokenStream tokens = lexer.tokenize();
+    LamiaAstArena arena;
+    LamiaParser parser(tokens, arena);
+    const LamiaExpression* program = parser.parse();
+    check(parser.get_errors().empty(), "parses without errors");
+
+    std::string::size_type end = source.size();
+    source.assign(end, '#'); // The tree must not point into the source
+    LamiaEmitter emitter(LamiaEmitter::JAVASCRIPT | LamiaEmitter::HTML);
+    emitter.emit(*program);
+    const std::string& javascript = emitter.buffers().javascript;
+    const std::string& html = emitter.buffers().html;
+
+    check(javascript.find("\"<div class=\\\"card\\\">Hello \\\"world\\\" & more<\\/div>\\n"
+                          "    <script>go()<\\/script>\"") != std::string::npos,
+          "JavaScript holds one escaped string");
+    check(javascript.find('#') == std::string::npos, "the text was copied out of the source");
+    check(html.find("&lt;div class=&quot;card&quot;&gt;Hello &quot;world&quot; &amp; more&lt;/div&gt;") != std::string::npos,
+          "HTML holds the escaped text");
+}
+
+int main() {
+    std::cout << "🔮 Testing LamiaParser v0.3.0c" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    test_malformed_lamia_body();
+    test_markup_body();
+
+    std::cout << (failures ? "❌ " : "✅ ") << failures << " failed" << std::endl;
+    return failures ? 1 : 0;
+}
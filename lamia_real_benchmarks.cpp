@@ -24,6 +24,10 @@
 #include <iomanip>
 #include <sstream>
 #include <regex>
+#include <set>
+#include "lamia_keywords.hpp"
+#include "lamia_lexer.hpp"
+#include "lamia_simd_scan.hpp"
 
 namespace MedusaServ {
 namespace Language {
@@ -80,6 +84,15 @@ public:
         // Parsing performance benchmark
         benchmark_parsing_performance();
         
+        // Lexer keyword classification benchmark
+        benchmark_keyword_classification();
+        
+        // Lexer scanning throughput benchmark
+        benchmark_lexer_scanning();
+        
+        // Server-side manifest execution: lamia_manifest_benchmarks.cpp, as the
+        // function registry cannot share a translation unit with the lexer
+        
         // Generate performance report
         generate_performance_report();
     }
@@ -375,6 +388,133 @@ private:
         std::cout << "  ✅ Parsed " << iterations << " complex programs in " << result.execution_time_ms << "ms" << std::endl;
     }
     
+    /**
+     * @brief Benchmark keyword classification - std::set lookup vs compile-time perfect hash
+     */
+    void benchmark_keyword_classification() {
+        std::cout << "🔑 Testing keyword classification..." << std::endl;
+        
+        // Identifier mix as the lexer sees it: keywords, near misses and plain names
+        std::vector<std::string> words;
+        for (auto keyword : LamiaLexicon::KEYWORD_LIST) {
+            words.emplace_back(keyword);
+            words.emplace_back(std::string(keyword) + "_x");
+        }
+        for (const char* name : {"content", "title", "items", "attribution", "level", "emotion_3d",
+                                 "main_application", "ai_analyze_performance", "style", "x", "superior"}) {
+            words.emplace_back(name);
+        }
+        
+        // Previous lexer implementation
+        const std::set<std::string, std::less<>> keyword_set(
+            std::begin(LamiaLexicon::KEYWORD_LIST), std::end(LamiaLexicon::KEYWORD_LIST));
+        
+        const int iterations = 200000;
+        size_t set_hits = 0;
+        size_t hash_hits = 0;
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            for (const auto& word : words) {
+                set_hits += keyword_set.find(std::string_view(word)) != keyword_set.end();
+            }
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            for (const auto& word : words) {
+                hash_hits += LamiaLexicon::is_keyword(word);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        double lookups = static_cast<double>(iterations) * words.size();
+        const char* status = set_hits == hash_hits ? "COMPLETED" : "MISMATCH";
+        
+        auto record = [&](const char* name, std::chrono::high_resolution_clock::duration elapsed) {
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+            BenchmarkResult result;
+            result.test_name = name;
+            result.execution_time_ms = duration.count() / 1000.0;
+            result.operations_per_second = (lookups * 1000000.0) / std::max<long long>(duration.count(), 1);
+            result.memory_usage_mb = 0.0;
+            result.status = status;
+            results_.push_back(result);
+            return result.execution_time_ms;
+        };
+        
+        double set_ms = record("Keyword Lookup (std::set)", middle - start);
+        double hash_ms = record("Keyword Lookup (perfect hash)", end - middle);
+        
+        std::cout << "  ✅ " << static_cast<long long>(lookups) << " lookups: std::set " << set_ms
+                  << "ms, perfect hash " << hash_ms << "ms (" << status << ")" << std::endl;
+    }
+    
+    /**
+     * @brief Benchmark lexer throughput in GB/s - LamiaLexer::tokenize on its scalar loops vs LamiaScan
+     *
+     * Both passes tokenize the same source with the same lexer; the first
+     * forces the scalar loops with LamiaScan::set_vectorized(false).
+     */
+    void benchmark_lexer_scanning() {
+        std::cout << "📏 Testing lexer scanning throughput (" << LamiaScan::implementation() << ")..." << std::endl;
+        
+        const std::string block = R"(
+                /* Manufacturing dashboard
+                 * Generated for throughput measurement
+                 */
+                manifest production_line() -> crystal @ludicrous {
+                    // Heading shown above the live metrics panel
+                    create RADIANT_HEADING { content: "Line throughput and quality overview for shift A" }
+                    create RADIANT_TEXT { content: "Escaped \"quotes\" and ${interpolation} stay inside the literal" }
+                    return_light true
+                }
+)";
+        std::string source;
+        while (source.size() < 32 * 1024 * 1024) {
+            source += block;
+        }
+        
+        struct ScanResult { size_t tokens = 0; size_t lines = 0; };
+        
+        auto measure = [&](const char* name, bool vectorized) {
+            const int passes = 5;
+            const bool was_vectorized = LamiaScan::vectorized();
+            LamiaScan::set_vectorized(vectorized);
+            LamiaLexer lexer(source);
+            lexer.set_verbose(false);
+            ScanResult r;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < passes; i++) {
+                LamiaTokenStream stream = lexer.tokenize();
+                r.tokens = stream.tokens.size();
+                r.lines = stream.tokens.empty() ? 0 : stream.tokens.back().line;
+            }
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - start);
+            LamiaScan::set_vectorized(was_vectorized);
+            double bytes_per_second = (static_cast<double>(source.size()) * passes * 1000000.0) / std::max<long long>(duration.count(), 1);
+            
+            BenchmarkResult result;
+            result.test_name = name;
+            result.execution_time_ms = duration.count() / 1000.0;
+            result.operations_per_second = bytes_per_second; // Bytes tokenized per second
+            result.memory_usage_mb = source.size() / (1024.0 * 1024.0);
+            result.status = "COMPLETED";
+            results_.push_back(result);
+            
+            std::cout << "  ✅ " << name << ": " << std::fixed << std::setprecision(2)
+                      << bytes_per_second / 1e9 << " GB/s (" << r.tokens << " tokens, " << r.lines << " lines)" << std::endl;
+            return r;
+        };
+        
+        ScanResult scalar = measure("Lexer Scan (scalar)", false);
+        ScanResult vector = measure("Lexer Scan (LamiaScan)", true);
+        if (scalar.tokens != vector.tokens || scalar.lines != vector.lines) {
+            results_.back().status = "MISMATCH";
+            std::cout << "  ❌ Lexer results differ" << std::endl;
+        }
+    }
+    
     /**
      * @brief Generate comprehensive performance report
      */
@@ -18,6 +18,20 @@
 #include <regex>
 #include <memory>
 #include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "lamia_ast_arena.hpp"
+#include "lamia_compile_cache.hpp"
+#include "lamia_output_sink.hpp"
+#include "lamia_batch_runner.hpp"
+#include "lamia_source_buffer.hpp"
 
 namespace MedusaServ {
 namespace Language {
@@ -45,15 +59,37 @@ enum class NodeType {
 
 /**
  * @brief AST Node for parsed Lamia syntax
+ *
+ * Nodes live in a per-compilation LamiaAstArena: names and attribute values
+ * are interned views, children are a flat arena array.
  */
 struct ASTNode {
+    /**
+     * @brief Where a NUMBER token landed in the "value" attribute - strings and names are never numbers
+     */
+    struct NumberSpan {
+        uint32_t offset;
+        uint32_t length;
+    };
+    
     NodeType type;
-    std::string name;
-    std::map<std::string, std::string> attributes;
-    std::vector<std::string> content;
-    std::vector<std::shared_ptr<ASTNode>> children;
+    std::string_view name;
+    LamiaPropertyList<std::string_view> attributes;
+    LamiaArenaVector<std::string_view> content;
+    LamiaArenaVector<const ASTNode*> children;
+    LamiaArenaVector<NumberSpan> value_numbers; // Literal kinds for "value", in order
+    size_t line = 0, column = 0; // 1-based start in the source, 0 for synthesized nodes
+    
+    ASTNode(NodeType t, std::string_view n = "") : type(t), name(n) {}
     
-    ASTNode(NodeType t, const std::string& n = "") : type(t), name(n) {}
+    std::string_view attribute(std::string_view key) const {
+        const std::string_view* value = attributes.find(key);
+        return value ? *value : std::string_view();
+    }
+    
+    void set_attribute(LamiaAstArena& arena, std::string_view key, std::string_view value) {
+        attributes.set(arena, key, arena.intern(value));
+    }
 };
 
 /**
@@ -69,13 +105,14 @@ public:
     };
     
 private:
-    std::string source_;
+    std::string_view source_; // Mapped file contents, owned by the caller
     size_t pos_ = 0;
     size_t line_ = 1;
     size_t column_ = 1;
     
 public:
-    LamiaLexer(const std::string& source) : source_(source) {}
+    explicit LamiaLexer(std::string_view source) : source_(source) {}
+    explicit LamiaLexer(std::string&&) = delete; // Must not outlive its source
     
     std::vector<Token> tokenize() {
         std::vector<Token> tokens;
@@ -233,21 +270,25 @@ private:
 class LamiaParser {
 private:
     std::vector<LamiaLexer::Token> tokens_;
+    LamiaAstArena& arena_;
     size_t current_ = 0;
     
 public:
-    LamiaParser(const std::vector<LamiaLexer::Token>& tokens) : tokens_(tokens) {}
+    LamiaParser(const std::vector<LamiaLexer::Token>& tokens, LamiaAstArena& arena) : tokens_(tokens), arena_(arena) {}
     
-    std::shared_ptr<ASTNode> parse() {
-        auto root = std::make_shared<ASTNode>(NodeType::MANIFEST, "program");
+    /**
+     * @brief Parse the token list - the tree lives as long as the arena
+     */
+    const ASTNode* parse() {
+        auto* root = arena_.create<ASTNode>(NodeType::MANIFEST, "program");
         
         while (!is_at_end()) {
             skip_newlines();
             if (is_at_end()) break;
             
-            auto node = parse_statement();
+            auto* node = parse_statement();
             if (node) {
-                root->children.push_back(node);
+                root->children.push_back(arena_, node);
             }
         }
         
@@ -266,6 +307,16 @@ private:
         }
     }
     
+    /**
+     * @brief A node starting at the current token
+     */
+    ASTNode* create_node(NodeType type) {
+        auto* node = arena_.create<ASTNode>(type);
+        node->line = current().line;
+        node->column = current().column;
+        return node;
+    }
+    
     bool match(LamiaLexer::Token::Type type) {
         if (is_at_end()) return false;
         if (current().type != type) return false;
@@ -273,7 +324,7 @@ private:
         return true;
     }
     
-    std::shared_ptr<ASTNode> parse_statement() {
+    ASTNode* parse_statement() {
         if (current().type == LamiaLexer::Token::MANIFEST) {
             return parse_manifest();
         }
@@ -295,24 +346,26 @@ private:
         return nullptr;
     }
     
-    std::shared_ptr<ASTNode> parse_manifest() {
-        auto node = std::make_shared<ASTNode>(NodeType::MANIFEST);
+    ASTNode* parse_manifest() {
+        auto* node = create_node(NodeType::MANIFEST);
         advance(); // consume 'manifest'
         
         if (current().type == LamiaLexer::Token::IDENTIFIER) {
-            node->name = current().value;
+            node->name = arena_.intern(current().value);
             advance();
         }
         
         // Parse parameters if present
         if (match(LamiaLexer::Token::ARROW)) {
             // Parse return type and attributes
+            std::string return_type;
             while (!is_at_end() && current().type != LamiaLexer::Token::LBRACE) {
                 if (current().type == LamiaLexer::Token::IDENTIFIER || current().type == LamiaLexer::Token::AT) {
-                    node->attributes["return_type"] += current().value + " ";
+                    return_type += current().value + " ";
                     advance();
                 }
             }
+            node->set_attribute(arena_, "return_type", return_type);
         }
         
         // Parse body
@@ -321,9 +374,9 @@ private:
                 skip_newlines();
                 if (current().type == LamiaLexer::Token::RBRACE) break;
                 
-                auto child = parse_statement();
+                auto* child = parse_statement();
                 if (child) {
-                    node->children.push_back(child);
+                    node->children.push_back(arena_, child);
                 }
             }
             match(LamiaLexer::Token::RBRACE);
@@ -332,13 +385,13 @@ private:
         return node;
     }
     
-    std::shared_ptr<ASTNode> parse_create() {
-        auto node = std::make_shared<ASTNode>(NodeType::CREATE);
+    ASTNode* parse_create() {
+        auto* node = create_node(NodeType::CREATE);
         advance(); // consume 'create'
         
         if (current().type == LamiaLexer::Token::IDENTIFIER) {
             std::string widget_type = current().value;
-            node->attributes["widget_type"] = widget_type;
+            node->set_attribute(arena_, "widget_type", widget_type);
             
             // Determine specific node type
             if (widget_type == "RADIANT_HEADING") node->type = NodeType::RADIANT_HEADING;
@@ -363,7 +416,7 @@ private:
         return node;
     }
     
-    void parse_attributes(std::shared_ptr<ASTNode> node) {
+    void parse_attributes(ASTNode* node) {
         while (!is_at_end() && current().type != LamiaLexer::Token::RBRACE) {
             skip_newlines();
             if (current().type == LamiaLexer::Token::RBRACE) break;
@@ -375,7 +428,7 @@ private:
                 
                 if (match(LamiaLexer::Token::COLON)) {
                     std::string value = parse_value();
-                    node->attributes[key] = value;
+                    node->set_attribute(arena_, key, value);
                 }
             } else {
                 advance(); // Skip unknown tokens
@@ -389,31 +442,37 @@ private:
     }
     
     std::string parse_value() {
-        if (current().type == LamiaLexer::Token::STRING) {
-            std::string value = current().value;
-            advance();
-            return value;
-        }
-        if (current().type == LamiaLexer::Token::NUMBER) {
-            std::string value = current().value;
-            advance();
-            return value;
-        }
-        if (current().type == LamiaLexer::Token::IDENTIFIER) {
-            std::string value = current().value;
-            advance();
-            return value;
-        }
-        if (current().type == LamiaLexer::Token::LBRACKET) {
-            return parse_array();
+        std::string value;
+        append_value(value, nullptr);
+        return value;
+    }
+    
+    /**
+     * @brief Append one value's text to result, noting where NUMBER tokens land if numbers is given
+     */
+    void append_value(std::string& result, std::vector<ASTNode::NumberSpan>* numbers) {
+        switch (current().type) {
+            case LamiaLexer::Token::NUMBER:
+                if (numbers) {
+                    numbers->push_back({static_cast<uint32_t>(result.size()), static_cast<uint32_t>(current().value.size())});
+                }
+                [[fallthrough]];
+            case LamiaLexer::Token::STRING:
+            case LamiaLexer::Token::IDENTIFIER:
+                result += current().value;
+                advance();
+                return;
+            case LamiaLexer::Token::LBRACKET:
+                append_array(result, numbers);
+                return;
+            default:
+                advance();
+                return;
         }
-        
-        advance();
-        return "";
     }
     
-    std::string parse_array() {
-        std::string result = "[";
+    void append_array(std::string& result, std::vector<ASTNode::NumberSpan>* numbers) {
+        result += "[";
         advance(); // consume '['
         
         bool first = true;
@@ -424,7 +483,7 @@ private:
             if (!first) result += ", ";
             first = false;
             
-            result += parse_value();
+            append_value(result, numbers);
             
             if (current().type == LamiaLexer::Token::COMMA) {
                 advance();
@@ -434,91 +493,392 @@ private:
         if (match(LamiaLexer::Token::RBRACKET)) {
             result += "]";
         }
-        
-        return result;
     }
     
-    std::shared_ptr<ASTNode> parse_startup() {
-        auto node = std::make_shared<ASTNode>(NodeType::STARTUP);
+    ASTNode* parse_startup() {
+        auto* node = create_node(NodeType::STARTUP);
         advance(); // consume '@startup'
         skip_newlines();
         
         // Parse the following manifest
         if (current().type == LamiaLexer::Token::MANIFEST) {
-            auto manifest = parse_manifest();
-            node->children.push_back(manifest);
+            auto* manifest = parse_manifest();
+            node->children.push_back(arena_, manifest);
         }
         
         return node;
     }
     
-    std::shared_ptr<ASTNode> parse_return_light() {
-        auto node = std::make_shared<ASTNode>(NodeType::RETURN_LIGHT);
+    ASTNode* parse_return_light() {
+        auto* node = create_node(NodeType::RETURN_LIGHT);
         advance(); // consume 'return_light'
         
         if (!is_at_end()) {
-            node->attributes["value"] = parse_value();
+            std::string value;
+            std::vector<ASTNode::NumberSpan> numbers;
+            append_value(value, &numbers);
+            node->set_attribute(arena_, "value", value);
+            for (const auto& number : numbers) {
+                node->value_numbers.push_back(arena_, number);
+            }
         }
         
         return node;
     }
     
-    std::shared_ptr<ASTNode> parse_neural() {
-        auto node = std::make_shared<ASTNode>(NodeType::NEURAL);
+    ASTNode* parse_neural() {
+        auto* node = create_node(NodeType::NEURAL);
         advance(); // consume 'neural'
         
         if (current().type == LamiaLexer::Token::IDENTIFIER) {
-            node->name = current().value;
+            node->name = arena_.intern(current().value);
             advance();
         }
         
         if (match(LamiaLexer::Token::COLON)) {
-            node->attributes["expression"] = parse_value();
+            node->set_attribute(arena_, "expression", parse_value());
         }
         
         return node;
     }
 };
 
+/**
+ * @brief Lamia AST Optimizer - Middle-end pass between the parser and every target
+ *
+ * Returns an equivalent tree that is cheaper to emit:
+ * - Number literals a target writes verbatim (return_light values, also
+ *   inside arrays) are folded to canonical form: 007 -> 7, 1.50 -> 1.5.
+ *   Only tokens the lexer read as numbers fold; "007" stays a string
+ * - Blocks no target renders are dropped: create with an unknown widget
+ *   type, BAMBU_PRINTER, SOCIAL_EMBED, 3D_EMOTION and anonymous empty manifests.
+ *   Statements after a return_light stay: HTML shows every statement of a
+ *   manifest, and only the script leaves the unreachable ones out
+ * - Identical create subtrees are hash-consed into one shared node, so a
+ *   widget repeated across manifests is held in memory once; targets still
+ *   write it out at every site. When positions are kept for source maps,
+ *   only nodes at the same position are shared
+ *
+ * The input tree is never modified: changed nodes are copied into the arena
+ * and unchanged subtrees are shared, so the result lives as long as the
+ * parser's tree. Targets only read the tree and may see a node more than once.
+ */
+class LamiaAstOptimizer {
+public:
+    struct Stats {
+        size_t folded = 0;  // Literals rewritten
+        size_t removed = 0; // Statements dropped
+        size_t shared = 0;  // Create nodes replaced by an identical earlier one
+    };
+    
+private:
+    LamiaAstArena& arena_;
+    Stats stats_;
+    std::unordered_map<std::string, const ASTNode*> creates_; // Structural key -> shared node
+    bool keep_positions_; // A shared node must not take another site's line and column
+    
+public:
+    explicit LamiaAstOptimizer(LamiaAstArena& arena, bool keep_positions = false)
+        : arena_(arena), keep_positions_(keep_positions) {}
+    
+    const ASTNode* optimize(const ASTNode* root) {
+        return optimize_body(root);
+    }
+    
+    const Stats& stats() const { return stats_; }
+    
+private:
+    /**
+     * @brief A node's replacement - itself, a rewritten copy, or nullptr to drop it
+     */
+    const ASTNode* optimize_node(const ASTNode* node) {
+        switch (node->type) {
+            case NodeType::MANIFEST:
+            case NodeType::STARTUP:
+                {
+                    const ASTNode* body = optimize_body(node);
+                    bool anonymous = node->type == NodeType::STARTUP || node->name.empty();
+                    return anonymous && body->children.empty() ? nullptr : body;
+                }
+                
+            case NodeType::CREATE:
+            case NodeType::BAMBU_PRINTER:
+            case NodeType::SOCIAL_EMBED:
+            case NodeType::EMOTION_3D:
+                return nullptr;
+                
+            case NodeType::RADIANT_HEADING:
+            case NodeType::RADIANT_TEXT:
+            case NodeType::RADIANT_BUTTON:
+            case NodeType::CONSTELLATION_LIST:
+            case NodeType::RADIANT_QUOTE:
+            case NodeType::GCODE_BLOCK:
+                return share(node);
+                
+            case NodeType::RETURN_LIGHT:
+                return fold_value(node);
+                
+            default:
+                return node;
+        }
+    }
+    
+    /**
+     * @brief Optimize the statements of a body
+     */
+    const ASTNode* optimize_body(const ASTNode* node) {
+        std::vector<const ASTNode*> children;
+        children.reserve(node->children.size());
+        bool changed = false;
+        
+        for (const auto* original : node->children) {
+            const ASTNode* child = optimize_node(original);
+            changed |= child != original;
+            if (!child) {
+                ++stats_.removed;
+                continue;
+            }
+            children.push_back(child);
+        }
+        
+        if (!changed) {
+            return node;
+        }
+        
+        // Attributes and content are shared read-only with the original
+        auto* copy = arena_.create<ASTNode>(node->type, node->name);
+        copy->line = node->line;
+        copy->column = node->column;
+        copy->attributes = node->attributes;
+        copy->value_numbers = node->value_numbers;
+        copy->content = node->content;
+        for (const auto* child : children) {
+            copy->children.push_back(arena_, child);
+        }
+        return copy;
+    }
+    
+    /**
+     * @brief The first node seen with this type, attributes, content and children
+     */
+    const ASTNode* share(const ASTNode* node) {
+        std::string key;
+        key += static_cast<char>(node->type);
+        if (keep_positions_) {
+            key.append(reinterpret_cast<const char*>(&node->line), sizeof(node->line));
+            key.append(reinterpret_cast<const char*>(&node->column), sizeof(node->column));
+        }
+        append_key(key, node->name);
+        for (const auto& attribute : node->attributes) {
+            append_key(key, attribute.key);
+            append_key(key, attribute.value);
+        }
+        key += '\0';
+        for (const auto& text : node->content) {
+            append_key(key, text);
+        }
+        key += '\0';
+        for (const auto* child : node->children) {
+            key.append(reinterpret_cast<const char*>(&child), sizeof(child));
+        }
+        
+        auto [it, inserted] = creates_.try_emplace(std::move(key), node);
+        if (!inserted) {
+            ++stats_.shared;
+        }
+        return it->second;
+    }
+    
+    static void append_key(std::string& key, std::string_view text) {
+        size_t size = text.size();
+        key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        key.append(text);
+    }
+    
+    /**
+     * @brief A return_light whose number literals are in canonical form
+     */
+    const ASTNode* fold_value(const ASTNode* node) {
+        std::string_view value = node->attribute("value");
+        std::string folded;
+        std::vector<ASTNode::NumberSpan> numbers;
+        size_t copied = 0;
+        for (const auto& number : node->value_numbers) {
+            folded.append(value, copied, number.offset - copied);
+            numbers.push_back({static_cast<uint32_t>(folded.size()), 0});
+            folded += fold_number(value.substr(number.offset, number.length));
+            numbers.back().length = static_cast<uint32_t>(folded.size() - numbers.back().offset);
+            copied = number.offset + number.length;
+        }
+        folded.append(value, copied, std::string_view::npos);
+        if (folded == value) {
+            return node;
+        }
+        
+        ++stats_.folded;
+        auto* copy = arena_.create<ASTNode>(node->type, node->name);
+        copy->line = node->line;
+        copy->column = node->column;
+        for (const auto& attribute : node->attributes) {
+            copy->set_attribute(arena_, attribute.key, attribute.key == "value" ? std::string_view(folded) : attribute.value);
+        }
+        for (const auto& number : numbers) {
+            copy->value_numbers.push_back(arena_, number);
+        }
+        copy->content = node->content;
+        copy->children = node->children;
+        return copy;
+    }
+    
+    /**
+     * @brief Digits with at most one '.', without redundant zeros - anything else unchanged
+     */
+    static std::string fold_number(std::string_view text) {
+        bool numeric = !text.empty() && text != "." && std::count(text.begin(), text.end(), '.') <= 1 &&
+                       std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) || c == '.'; });
+        if (!numeric) {
+            return std::string(text);
+        }
+        
+        size_t dot = text.find('.');
+        std::string_view whole = text.substr(0, dot);
+        std::string_view fraction = dot == std::string_view::npos ? std::string_view() : text.substr(dot + 1);
+        whole.remove_prefix(std::min(whole.find_first_not_of('0'), whole.size()));
+        fraction = fraction.substr(0, fraction.find_last_not_of('0') + 1);
+        
+        std::string result = whole.empty() ? "0" : std::string(whole);
+        if (!fraction.empty()) {
+            result += '.';
+            result += fraction;
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Lamia Runtime Usage - Which node types a tree actually renders
+ *
+ * Mirrors the transpiler walks: top-level nodes plus everything reached
+ * through manifest and @startup bodies. Runtime helpers and CSS rules
+ * for types outside this set are not emitted.
+ */
+class LamiaRuntimeUsage {
+private:
+    uint32_t types_ = 0;
+    
+    static uint32_t bit(NodeType type) { return 1u << static_cast<unsigned>(type); }
+    
+    void collect(const ASTNode* node) {
+        for (const auto* child : node->children) {
+            types_ |= bit(child->type);
+            if (child->type == NodeType::MANIFEST || child->type == NodeType::STARTUP) {
+                collect(child);
+            }
+        }
+    }
+    
+public:
+    explicit LamiaRuntimeUsage(const ASTNode* ast) {
+        collect(ast);
+    }
+    
+    bool uses(NodeType type) const { return (types_ & bit(type)) != 0; }
+};
+
 /**
  * @brief Real Lamia Transpiler - Converts AST to target languages
+ *
+ * Every generator streams into a LamiaOutputSink; the std::string
+ * overloads are conveniences backed by a LamiaMemorySink.
  */
 class LamiaTranspiler {
 public:
     /**
      * @brief Transpile AST to HTML
      */
-    std::string transpile_to_html(std::shared_ptr<ASTNode> ast) {
-        std::ostringstream html;
+    void transpile_to_html(const ASTNode* ast, LamiaOutputSink& html) {
+        LamiaRuntimeUsage usage(ast);
         
         html << "<!DOCTYPE html>\n<html lang=\"en\">\n<head>\n";
         html << "    <meta charset=\"UTF-8\">\n";
         html << "    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n";
         html << "    <title>Lamia Application</title>\n";
         html << "    <style>\n";
-        html << generate_css_from_ast(ast);
+        generate_css_from_ast(usage, html);
         html << "    </style>\n";
         html << "</head>\n<body>\n";
         html << "    <div class=\"lamia-app\">\n";
         
-        for (const auto& child : ast->children) {
-            html << transpile_node_to_html(child, 2);
+        for (const auto* child : ast->children) {
+            transpile_node_to_html(child, 2, html);
         }
+        html.unmap_source();
         
         html << "    </div>\n";
         html << "    <script>\n";
-        html << generate_js_from_ast(ast);
+        generate_js_from_ast(usage, html);
         html << "    </script>\n";
         html << "</body>\n</html>\n";
-        
-        return html.str();
+    }
+    
+    std::string transpile_to_html(const ASTNode* ast) {
+        std::string output;
+        LamiaMemorySink sink(output);
+        transpile_to_html(ast, sink);
+        return output;
     }
     
+    /**
+     * @brief How app.js may be divided into lazily loaded chunks
+     */
+    struct SplitOptions {
+        bool code_splitting = false;
+        bool lazy_loading = true;
+        size_t budget_bytes = 64 * 1024; // Target size for app.js and for each chunk
+    };
+    
+    /**
+     * @brief A chunk of manifest methods split out of app.js
+     */
+    struct Chunk {
+        std::string filename;
+        std::string content;
+        LamiaSourceMap map; // Mappings for content when app.js is mapped, else empty
+    };
+    
     /**
      * @brief Transpile AST to JavaScript
      */
-    std::string transpile_to_javascript(std::shared_ptr<ASTNode> ast) {
-        std::ostringstream js;
+    void transpile_to_javascript(const ASTNode* ast, LamiaOutputSink& js) {
+        transpile_to_javascript(ast, js, SplitOptions{});
+    }
+    
+    /**
+     * @brief Transpile AST to JavaScript, splitting manifest methods out of app.js
+     *
+     * When app.js would exceed the budget, the largest manifest methods move
+     * into chunks app.1.js, app.2.js, ... (packed in source order up to the
+     * budget). app.js keeps a stub for each moved method; the first call loads
+     * its chunk, which replaces the stubs on LamiaApp.prototype. Without lazy
+     * loading every chunk is requested at startup instead of on first use.
+     * A chunk that fails to load is requested again on the next call.
+     *
+     * With splitting on, every manifest method is async, moved or not: which
+     * methods move depends on their size, so callers always await them.
+     *
+     * When js records a source map, each chunk comes with its own.
+     *
+     * @return The chunks to write next to app.js - empty when nothing was split
+     */
+    std::vector<Chunk> transpile_to_javascript(const ASTNode* ast, LamiaOutputSink& js, const SplitOptions& split) {
+        std::vector<Chunk> chunks;
+        std::vector<std::string> methods; // Rendered up front only when splitting
+        std::vector<LamiaSourceMap> method_maps; // Their mappings, when js is mapped
+        std::vector<size_t> method_chunk; // 0: stays in app.js, else 1-based chunk number
+        bool async_methods = split.code_splitting && split.budget_bytes > 0;
+        if (async_methods) {
+            chunks = plan_chunks(ast, split.budget_bytes, js.source_map() != nullptr, methods, method_maps, method_chunk);
+        }
         
         js << "// LAMIA TRANSPILED JAVASCRIPT\n";
         js << "class LamiaApp {\n";
@@ -528,69 +888,109 @@ public:
         js << "    }\n\n";
         js << "    init() {\n";
         
-        for (const auto& child : ast->children) {
-            js << transpile_node_to_js(child, 2);
+        for (const auto* child : ast->children) {
+            transpile_node_to_js(child, 2, js);
         }
+        js.unmap_source();
         
         js << "        this.initialized = true;\n";
         js << "    }\n";
         
         // Generate methods for manifests
-        for (const auto& child : ast->children) {
-            if (child->type == NodeType::MANIFEST || child->type == NodeType::STARTUP) {
-                js << generate_manifest_method(child);
+        if (methods.empty()) {
+            for (const auto* child : ast->children) {
+                if (child->type == NodeType::MANIFEST || child->type == NodeType::STARTUP) {
+                    generate_manifest_method(child, js, async_methods);
+                }
+            }
+        } else {
+            size_t index = 0;
+            for (const auto* child : ast->children) {
+                if (is_method(child)) {
+                    if (method_chunk[index]) {
+                        generate_chunk_stub(child->name, chunks[method_chunk[index] - 1].filename, js);
+                    } else if (method_maps.empty()) {
+                        js << methods[index];
+                    } else {
+                        js.write(methods[index], method_maps[index]);
+                    }
+                    ++index;
+                }
             }
         }
         
+        if (!chunks.empty()) {
+            generate_chunk_loader(js);
+        }
+        
         js << "}\n\n";
+        if (!chunks.empty()) {
+            js << "// Chunks resolve relative to this script, not the page\n";
+            js << "LamiaApp.chunkBase = document.currentScript ? document.currentScript.src : document.baseURI;\n";
+            if (!split.lazy_loading) {
+                for (const auto& chunk : chunks) {
+                    js << "LamiaApp.loadChunk('" << chunk.filename << "').catch(() => {}); // Retried on first call\n";
+                }
+            }
+            js << "\n";
+        }
         js << "// Initialize Lamia application\n";
         js << "document.addEventListener('DOMContentLoaded', () => {\n";
         js << "    new LamiaApp();\n";
         js << "});\n";
-        
-        return js.str();
+        return chunks;
+    }
+    
+    std::string transpile_to_javascript(const ASTNode* ast) {
+        std::string output;
+        LamiaMemorySink sink(output);
+        transpile_to_javascript(ast, sink);
+        return output;
     }
     
 private:
-    std::string transpile_node_to_html(std::shared_ptr<ASTNode> node, int indent) {
+    void transpile_node_to_html(const ASTNode* node, int indent, LamiaOutputSink& html) {
         std::string spaces(indent, ' ');
-        std::ostringstream html;
+        html.map_source(node->line, node->column);
         
         switch (node->type) {
             case NodeType::MANIFEST:
             case NodeType::STARTUP:
-                for (const auto& child : node->children) {
-                    html << transpile_node_to_html(child, indent);
+                for (const auto* child : node->children) {
+                    transpile_node_to_html(child, indent, html);
                 }
                 break;
                 
             case NodeType::RADIANT_HEADING:
                 html << spaces << "<div class=\"radiant-heading\">\n";
-                html << spaces << "  <h1>" << escape_html(node->attributes["content"]) << "</h1>\n";
+                html << spaces << "  <h1>";
+                escape_html(node->attribute("content"), html) << "</h1>\n";
                 html << spaces << "</div>\n";
                 break;
                 
             case NodeType::RADIANT_TEXT:
                 html << spaces << "<div class=\"radiant-text\">\n";
-                html << spaces << "  <p>" << escape_html(node->attributes["content"]) << "</p>\n";
+                html << spaces << "  <p>";
+                escape_html(node->attribute("content"), html) << "</p>\n";
                 html << spaces << "</div>\n";
                 break;
                 
             case NodeType::RADIANT_BUTTON:
                 html << spaces << "<div class=\"radiant-button\">\n";
-                html << spaces << "  <button onclick=\"" << node->attributes["action"] << "\">";
-                html << escape_html(node->attributes["content"]) << "</button>\n";
+                html << spaces << "  <button onclick=\"" << node->attribute("action") << "\">";
+                escape_html(node->attribute("content"), html) << "</button>\n";
                 html << spaces << "</div>\n";
                 break;
                 
             case NodeType::CONSTELLATION_LIST:
                 {
                     html << spaces << "<div class=\"constellation-list\">\n";
-                    html << spaces << "  <h3>" << escape_html(node->attributes["title"]) << "</h3>\n";
+                    html << spaces << "  <h3>";
+                    escape_html(node->attribute("title"), html) << "</h3>\n";
                     html << spaces << "  <ul>\n";
                     
                     // Parse items array
-                    std::string items = node->attributes["items"];
+                    std::string items(node->attribute("items"));
                     if (!items.empty() && items.front() == '[' && items.back() == ']') {
                         items = items.substr(1, items.length() - 2); // Remove brackets
                         std::istringstream ss(items);
@@ -599,7 +999,8 @@ private:
                             // Remove quotes and whitespace
                             item.erase(0, item.find_first_not_of(" \t\""));
                             item.erase(item.find_last_not_of(" \t\"") + 1);
-                            html << spaces << "    <li>" << escape_html(item) << "</li>\n";
+                            html << spaces << "    <li>";
+                            escape_html(item, html) << "</li>\n";
                         }
                     }
                     
@@ -610,9 +1011,11 @@ private:
                 
             case NodeType::RADIANT_QUOTE:
                 html << spaces << "<div class=\"radiant-quote\">\n";
-                html << spaces << "  <blockquote>" << escape_html(node->attributes["content"]) << "</blockquote>\n";
-                if (!node->attributes["attribution"].empty()) {
-                    html << spaces << "  <cite>" << escape_html(node->attributes["attribution"]) << "</cite>\n";
+                html << spaces << "  <blockquote>";
+                escape_html(node->attribute("content"), html) << "</blockquote>\n";
+                if (!node->attribute("attribution").empty()) {
+                    html << spaces << "  <cite>";
+                    escape_html(node->attribute("attribution"), html) << "</cite>\n";
                 }
                 html << spaces << "</div>\n";
                 break;
@@ -620,7 +1023,8 @@ private:
             case NodeType::GCODE_BLOCK:
                 html << spaces << "<div class=\"gcode-block\">\n";
                 html << spaces << "  <h4>G-Code Block</h4>\n";
-                html << spaces << "  <pre>" << escape_html(node->attributes["commands"]) << "</pre>\n";
+                html << spaces << "  <pre>";
+                escape_html(node->attribute("commands"), html) << "</pre>\n";
                 html << spaces << "</div>\n";
                 break;
                 
@@ -628,130 +1032,311 @@ private:
                 // Skip other node types for HTML output
                 break;
         }
-        
-        return html.str();
     }
     
-    std::string transpile_node_to_js(std::shared_ptr<ASTNode> node, int indent) {
+    void transpile_node_to_js(const ASTNode* node, int indent, LamiaOutputSink& js) {
         std::string spaces(indent * 4, ' ');
-        std::ostringstream js;
+        js.map_source(node->line, node->column);
         
         switch (node->type) {
             case NodeType::MANIFEST:
                 js << spaces << "// Manifest: " << node->name << "\n";
-                for (const auto& child : node->children) {
-                    js << transpile_node_to_js(child, indent);
+                for (const auto* child : node->children) {
+                    transpile_node_to_js(child, indent, js);
+                    if (child->type == NodeType::RETURN_LIGHT) {
+                        break; // The rest is unreachable in the script (HTML still shows it)
+                    }
                 }
                 break;
                 
             case NodeType::RADIANT_HEADING:
-                js << spaces << "this.createRadiantHeading('" << escape_js(node->attributes["content"]) << "');\n";
+                js << spaces << "this.createRadiantHeading('";
+                escape_js(node->attribute("content"), js) << "');\n";
                 break;
                 
             case NodeType::RADIANT_TEXT:
-                js << spaces << "this.createRadiantText('" << escape_js(node->attributes["content"]) << "');\n";
+                js << spaces << "this.createRadiantText('";
+                escape_js(node->attribute("content"), js) << "');\n";
                 break;
                 
             case NodeType::RADIANT_BUTTON:
-                js << spaces << "this.createRadiantButton('" << escape_js(node->attributes["content"]) << "', '" << node->attributes["action"] << "');\n";
+                js << spaces << "this.createRadiantButton('";
+                escape_js(node->attribute("content"), js) << "', '" << node->attribute("action") << "');\n";
                 break;
                 
             case NodeType::NEURAL:
-                js << spaces << "const " << node->name << " = this.neuralAnalysis('" << escape_js(node->attributes["expression"]) << "');\n";
+                js << spaces << "const " << node->name << " = this.neuralAnalysis('";
+                escape_js(node->attribute("expression"), js) << "');\n";
                 break;
                 
             case NodeType::RETURN_LIGHT:
-                js << spaces << "return " << node->attributes["value"] << ";\n";
+                js << spaces << "return " << node->attribute("value") << ";\n";
                 break;
                 
             default:
                 // Skip other node types
                 break;
         }
-        
-        return js.str();
     }
     
-    std::string generate_css_from_ast(std::shared_ptr<ASTNode> ast) {
-        return R"(
-        .lamia-app { max-width: 1200px; margin: 0 auto; padding: 2rem; font-family: Arial, sans-serif; }
-        .radiant-heading h1 { color: #ffd700; text-align: center; font-size: 2.5rem; margin-bottom: 2rem; }
-        .radiant-text p { color: #333; line-height: 1.6; margin-bottom: 1rem; }
-        .radiant-button button { background: linear-gradient(45deg, #ffd700, #ff6b6b); border: none; padding: 1rem 2rem; color: white; border-radius: 25px; cursor: pointer; font-size: 1.1rem; }
-        .constellation-list { margin: 2rem 0; }
-        .constellation-list h3 { color: #4ecdc4; font-size: 1.5rem; }
-        .constellation-list ul { list-style: none; padding: 0; }
-        .constellation-list li { background: rgba(78, 205, 196, 0.1); padding: 0.5rem 1rem; margin: 0.5rem 0; border-radius: 5px; }
-        .radiant-quote { background: rgba(255, 215, 0, 0.1); padding: 1.5rem; margin: 1rem 0; border-left: 4px solid #ffd700; }
-        .gcode-block { background: #2c3e50; color: #ecf0f1; padding: 1rem; margin: 1rem 0; border-radius: 5px; }
-        .gcode-block pre { margin: 0; font-family: 'Courier New', monospace; }
-        )";
+    /**
+     * @brief A runtime fragment and the node type that needs it
+     */
+    struct RuntimePiece {
+        NodeType type;
+        std::string_view text;
+    };
+    
+    static constexpr RuntimePiece CSS_RULES[] = {
+        {NodeType::RADIANT_HEADING, "        .radiant-heading h1 { color: #ffd700; text-align: center; font-size: 2.5rem; margin-bottom: 2rem; }\n"},
+        {NodeType::RADIANT_TEXT, "        .radiant-text p { color: #333; line-height: 1.6; margin-bottom: 1rem; }\n"},
+        {NodeType::RADIANT_BUTTON, "        .radiant-button button { background: linear-gradient(45deg, #ffd700, #ff6b6b); border: none; padding: 1rem 2rem; color: white; border-radius: 25px; cursor: pointer; font-size: 1.1rem; }\n"},
+        {NodeType::CONSTELLATION_LIST, "        .constellation-list { margin: 2rem 0; }\n"
+                                       "        .constellation-list h3 { color: #4ecdc4; font-size: 1.5rem; }\n"
+                                       "        .constellation-list ul { list-style: none; padding: 0; }\n"
+                                       "        .constellation-list li { background: rgba(78, 205, 196, 0.1); padding: 0.5rem 1rem; margin: 0.5rem 0; border-radius: 5px; }\n"},
+        {NodeType::RADIANT_QUOTE, "        .radiant-quote { background: rgba(255, 215, 0, 0.1); padding: 1.5rem; margin: 1rem 0; border-left: 4px solid #ffd700; }\n"},
+        {NodeType::GCODE_BLOCK, "        .gcode-block { background: #2c3e50; color: #ecf0f1; padding: 1rem; margin: 1rem 0; border-radius: 5px; }\n"
+                                "        .gcode-block pre { margin: 0; font-family: 'Courier New', monospace; }\n"},
+    };
+    
+    static constexpr RuntimePiece JS_HELPERS[] = {
+        {NodeType::RADIANT_HEADING, "        createRadiantHeading(content) {\n"
+                                    "            console.log('Creating radiant heading:', content);\n"
+                                    "        }\n"},
+        {NodeType::RADIANT_TEXT, "        createRadiantText(content) {\n"
+                                 "            console.log('Creating radiant text:', content);\n"
+                                 "        }\n"},
+        {NodeType::RADIANT_BUTTON, "        createRadiantButton(content, action) {\n"
+                                   "            console.log('Creating radiant button:', content, 'with action:', action);\n"
+                                   "        }\n"},
+        {NodeType::NEURAL, "        neuralAnalysis(expression) {\n"
+                           "            console.log('Neural analysis:', expression);\n"
+                           "            return { result: 'analyzed', superior: true };\n"
+                           "        }\n"},
+    };
+    
+    /**
+     * @brief Page stylesheet - the app container plus rules for the widgets in use
+     */
+    void generate_css_from_ast(const LamiaRuntimeUsage& usage, LamiaOutputSink& css) {
+        css << "\n        .lamia-app { max-width: 1200px; margin: 0 auto; padding: 2rem; font-family: Arial, sans-serif; }\n";
+        for (const auto& rule : CSS_RULES) {
+            if (usage.uses(rule.type)) {
+                css << rule.text;
+            }
+        }
+        css << "        ";
+    }
+    
+    /**
+     * @brief Runtime helpers - only those the generated calls reach
+     */
+    void generate_js_from_ast(const LamiaRuntimeUsage& usage, LamiaOutputSink& js) {
+        js << "\n";
+        bool first = true;
+        for (const auto& helper : JS_HELPERS) {
+            if (usage.uses(helper.type)) {
+                js << (first ? "" : "        \n") << helper.text;
+                first = false;
+            }
+        }
+        js << "        ";
     }
     
-    std::string generate_js_from_ast(std::shared_ptr<ASTNode> ast) {
-        return R"(
-        createRadiantHeading(content) {
-            console.log('Creating radiant heading:', content);
+    static bool is_method(const ASTNode* node) {
+        return (node->type == NodeType::MANIFEST || node->type == NodeType::STARTUP) && !node->name.empty();
+    }
+    
+    /**
+     * @brief Decide which manifest methods leave app.js and render their chunks
+     *
+     * Sizes are exact: every method is rendered once here, async, and reused.
+     * With mapped set, each gets a map of its own to carry into app.js or
+     * its chunk.
+     */
+    std::vector<Chunk> plan_chunks(const ASTNode* ast, size_t budget, bool mapped, std::vector<std::string>& methods,
+                                   std::vector<LamiaSourceMap>& method_maps, std::vector<size_t>& method_chunk) {
+        std::string init;
+        LamiaMemorySink init_sink(init);
+        for (const auto* child : ast->children) {
+            transpile_node_to_js(child, 2, init_sink);
+        }
+        
+        size_t total = init.size() + 512; // Class scaffolding and start-up code
+        for (const auto* child : ast->children) {
+            if (is_method(child)) {
+                methods.emplace_back();
+                LamiaMemorySink sink(methods.back());
+                if (mapped) {
+                    method_maps.emplace_back();
+                    sink.set_source_map(&method_maps.back());
+                }
+                generate_manifest_method(child, sink, true);
+                total += methods.back().size();
+            }
+        }
+        method_chunk.assign(methods.size(), 0);
+        if (total <= budget) {
+            return {};
         }
         
-        createRadiantText(content) {
-            console.log('Creating radiant text:', content);
+        // Largest methods leave first, until app.js fits
+        std::vector<size_t> by_size(methods.size());
+        for (size_t i = 0; i < by_size.size(); ++i) {
+            by_size[i] = i;
         }
+        std::stable_sort(by_size.begin(), by_size.end(), [&](size_t a, size_t b) {
+            return methods[a].size() > methods[b].size();
+        });
         
-        createRadiantButton(content, action) {
-            console.log('Creating radiant button:', content, 'with action:', action);
+        constexpr size_t STUB_SIZE = 140; // Loader stub left behind, before the name
+        std::vector<bool> moved(methods.size(), false);
+        for (size_t i : by_size) {
+            if (total <= budget || methods[i].size() <= STUB_SIZE) {
+                break;
+            }
+            moved[i] = true;
+            total -= methods[i].size() - STUB_SIZE;
         }
         
-        neuralAnalysis(expression) {
-            console.log('Neural analysis:', expression);
-            return { result: 'analyzed', superior: true };
+        // Pack the moved methods into chunks in source order
+        std::vector<Chunk> chunks;
+        size_t chunk_size = 0;
+        for (size_t i = 0; i < methods.size(); ++i) {
+            if (!moved[i]) {
+                continue;
+            }
+            if (chunks.empty() || chunk_size + methods[i].size() > budget) {
+                chunks.push_back({"app." + std::to_string(chunks.size() + 1) + ".js", std::string(), LamiaSourceMap()});
+                chunks.back().content = "// LAMIA CHUNK - loaded by LamiaApp.loadChunk('" + chunks.back().filename + "')\n";
+                chunks.back().content += "Object.assign(LamiaApp.prototype, {";
+                chunks.back().map.advance(chunks.back().content);
+                chunk_size = 0;
+            }
+            // Methods end in "}\n": separate the object members with a comma
+            std::string_view method(methods[i].data(), methods[i].size() - 1);
+            chunks.back().content += method;
+            chunks.back().content += ",\n";
+            if (mapped) {
+                chunks.back().map.append(method, method_maps[i]);
+                chunks.back().map.advance(",\n");
+            }
+            chunk_size += methods[i].size();
+            method_chunk[i] = chunks.size();
         }
-        )";
+        for (auto& chunk : chunks) {
+            chunk.content += "});\n";
+        }
+        return chunks;
     }
     
-    std::string generate_manifest_method(std::shared_ptr<ASTNode> node) {
-        std::ostringstream js;
-        
+    /**
+     * @brief Stand-in for a moved method: load the chunk, then call the real one
+     */
+    void generate_chunk_stub(std::string_view name, std::string_view chunk, LamiaOutputSink& js) {
+        js << "\n    async " << name << "(...args) {\n";
+        js << "        await LamiaApp.loadChunk('" << chunk << "');\n";
+        js << "        return this." << name << "(...args);\n";
+        js << "    }\n";
+    }
+    
+    /**
+     * @brief Fetch each chunk once; concurrent callers share the request, a failed one is forgotten
+     */
+    void generate_chunk_loader(LamiaOutputSink& js) {
+        js << "\n    static loadChunk(src) {\n";
+        js << "        LamiaApp.chunks = LamiaApp.chunks || {};\n";
+        js << "        if (!LamiaApp.chunks[src]) {\n";
+        js << "            LamiaApp.chunks[src] = new Promise((resolve, reject) => {\n";
+        js << "                const script = document.createElement('script');\n";
+        js << "                script.src = new URL(src, LamiaApp.chunkBase).href;\n";
+        js << "                script.onload = resolve;\n";
+        js << "                script.onerror = () => {\n";
+        js << "                    script.remove();\n";
+        js << "                    reject(new Error('Failed to load ' + script.src));\n";
+        js << "                };\n";
+        js << "                document.head.appendChild(script);\n";
+        js << "            }).catch(error => {\n";
+        js << "                delete LamiaApp.chunks[src]; // The next call tries again\n";
+        js << "                throw error;\n";
+        js << "            });\n";
+        js << "        }\n";
+        js << "        return LamiaApp.chunks[src];\n";
+        js << "    }\n";
+    }
+    
+    /**
+     * @brief A manifest as a LamiaApp method - async when code splitting may move it into a chunk
+     */
+    void generate_manifest_method(const ASTNode* node, LamiaOutputSink& js, bool async) {
         if (!node->name.empty()) {
-            js << "\n    " << node->name << "() {\n";
+            js.map_source(node->line, node->column);
+            js << "\n    " << (async ? "async " : "") << node->name << "() {\n";
             js << "        console.log('Executing manifest: " << node->name << "');\n";
             
-            for (const auto& child : node->children) {
-                js << transpile_node_to_js(child, 2);
+            for (const auto* child : node->children) {
+                transpile_node_to_js(child, 2, js);
+                if (child->type == NodeType::RETURN_LIGHT) {
+                    break; // The rest is unreachable
+                }
             }
+            js.unmap_source();
             
             js << "    }\n";
         }
-        
-        return js.str();
     }
     
-    std::string escape_html(const std::string& input) {
-        std::string output = input;
-        std::regex html_chars(R"([<>&"])");
-        std::map<char, std::string> replacements = {
-            {'<', "&lt;"}, {'>', "&gt;"}, {'&', "&amp;"}, {'"', "&quot;"}
-        };
-        
-        for (const auto& pair : replacements) {
-            size_t pos = 0;
-            while ((pos = output.find(pair.first, pos)) != std::string::npos) {
-                output.replace(pos, 1, pair.second);
-                pos += pair.second.length();
+    static LamiaOutputSink& escape_html(std::string_view input, LamiaOutputSink& out) {
+        size_t run = 0;
+        for (size_t i = 0; i < input.size(); ++i) {
+            std::string_view entity;
+            switch (input[i]) {
+                case '<': entity = "&lt;"; break;
+                case '>': entity = "&gt;"; break;
+                case '&': entity = "&amp;"; break;
+                case '"': entity = "&quot;"; break;
+                default: continue;
             }
+            out << input.substr(run, i - run) << entity;
+            run = i + 1;
         }
-        
-        return output;
+        return out << input.substr(run);
     }
     
-    std::string escape_js(const std::string& input) {
-        std::string output = input;
-        size_t pos = 0;
-        while ((pos = output.find("'", pos)) != std::string::npos) {
-            output.replace(pos, 1, "\\'");
-            pos += 2;
+    static LamiaOutputSink& escape_js(std::string_view input, LamiaOutputSink& out) {
+        size_t run = 0;
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (input[i] == '\'') {
+                out << input.substr(run, i - run) << "\\'";
+                run = i + 1;
+            }
         }
-        return output;
+        return out << input.substr(run);
+    }
+};
+
+/**
+ * @brief Output settings - the real compiler's copy of LamiaConfig's performance block
+ *
+ * LamiaConfig lives in the language specification header, which cannot
+ * share a translation unit with this compiler's own lexer and parser.
+ */
+struct RealCompileOptions {
+    bool enable_lazy_loading = true;
+    bool enable_code_splitting = true; // Manifest methods are async while on
+    size_t code_split_kb = 64; // app.js and each chunk are split to this size
+    size_t max_bundle_size_kb = 512; // Largest output file accepted (0: unlimited)
+    bool optimize_ast = true; // Run LamiaAstOptimizer between parse and emit
+    bool source_maps = true; // Write index.html.map, app.js.map and a map per chunk
+    
+    /**
+     * @brief Every setting that can change the outputs, for cache keys
+     */
+    std::string fingerprint() const {
+        return std::to_string(enable_lazy_loading) + ";" + std::to_string(enable_code_splitting) + ";" +
+               std::to_string(code_split_kb) + ";" + std::to_string(max_bundle_size_kb) + ";" +
+               std::to_string(optimize_ast) + ";" + std::to_string(source_maps);
     }
 };
 
@@ -761,55 +1346,129 @@ private:
 class RealLamiaCompiler {
 private:
     std::string version_ = "0.3.0";
+    static constexpr const char* OUTPUT_REVISION = "6"; // Bump when the same source compiles differently
+    RealCompileOptions options_;
+    
+    // Incremental compilation cache
+    bool cache_enabled_ = true;
+    std::string cache_dir_; // Empty: sibling of the output directory
+    size_t cache_hits_ = 0;
+    size_t cache_misses_ = 0;
+    
+    // Running totals across compile_file calls
+    size_t tokens_generated_ = 0;
+    size_t ast_nodes_created_ = 0;
+    
+    bool verbose_ = true;
     
 public:
-    RealLamiaCompiler() {
-        std::cout << "Real Lamia Compiler v" << version_ << " - ACTUAL PARSING ENGINE" << std::endl;
+    explicit RealLamiaCompiler(bool verbose = true) : verbose_(verbose) {
+        log() << "Real Lamia Compiler v" << version_ << " - ACTUAL PARSING ENGINE" << std::endl;
     }
     
+    void set_cache_enabled(bool enabled) { cache_enabled_ = enabled; }
+    void set_cache_directory(const std::string& directory) { cache_dir_ = directory; }
+    void set_options(const RealCompileOptions& options) { options_ = options; }
+    size_t cache_hits() const { return cache_hits_; }
+    size_t cache_misses() const { return cache_misses_; }
+    size_t tokens_generated() const { return tokens_generated_; }
+    size_t ast_nodes_created() const { return ast_nodes_created_; }
+    
     bool compile_file(const std::string& input_file, const std::string& output_dir) {
-        std::cout << "Parsing and transpiling: " << input_file << std::endl;
+        log() << "Parsing and transpiling: " << input_file << std::endl;
         
         try {
-            // Read source file
-            std::ifstream file(input_file);
-            if (!file.is_open()) {
+            // Map the source file - lexed in place, never copied
+            LamiaSourceBuffer source(input_file);
+            if (!source.is_open()) {
                 std::cerr << "Cannot open file: " << input_file << std::endl;
                 return false;
             }
             
-            std::string source((std::istreambuf_iterator<char>(file)),
-                             std::istreambuf_iterator<char>());
-            file.close();
+            // Unchanged sources restore their previous outputs (and maps)
+            LamiaCompileCache cache(cache_dir_.empty() ? LamiaCompileCache::directory_for(output_dir) : std::filesystem::path(cache_dir_));
+            std::string cache_key = LamiaCacheKey().add(version_).add(OUTPUT_REVISION).add("index.html,app.js")
+                .add(options_.fingerprint()).add(source.view()).hex();
+            
+            if (cache_enabled_) {
+                if (cache.restore(cache_key, output_dir)) {
+                    cache_hits_++;
+                    log() << "Restored index.html and app.js from compilation cache" << std::endl;
+                    return true;
+                }
+                cache_misses_++;
+            }
             
             // Tokenize
-            LamiaLexer lexer(source);
+            LamiaLexer lexer(source.view());
             auto tokens = lexer.tokenize();
             
-            std::cout << "Tokenized " << tokens.size() << " tokens" << std::endl;
+            tokens_generated_ += tokens.size();
+            log() << "Tokenized " << tokens.size() << " tokens" << std::endl;
+            
+            // Parse - the whole tree is released with the arena at scope exit
+            LamiaAstArena arena;
+            LamiaParser parser(tokens, arena);
+            const ASTNode* ast = parser.parse();
             
-            // Parse
-            LamiaParser parser(tokens);
-            auto ast = parser.parse();
+            ast_nodes_created_ += arena.node_count();
+            log() << "Built AST with " << ast->children.size() << " top-level nodes" << std::endl;
             
-            std::cout << "Built AST with " << ast->children.size() << " top-level nodes" << std::endl;
+            // Optimize - every target below sees the same folded, pruned tree
+            if (options_.optimize_ast) {
+                LamiaAstOptimizer optimizer(arena, options_.source_maps);
+                ast = optimizer.optimize(ast);
+                const auto& stats = optimizer.stats();
+                log() << "Optimized AST: " << stats.folded << " literals folded, " << stats.removed
+                      << " statements removed, " << stats.shared << " create nodes shared" << std::endl;
+            }
             
             // Transpile
             LamiaTranspiler transpiler;
             
-            // Generate HTML
-            std::string html = transpiler.transpile_to_html(ast);
-            std::ofstream html_file(output_dir + "/index.html");
-            html_file << html;
-            html_file.close();
+            LamiaTranspiler::SplitOptions split;
+            split.code_splitting = options_.enable_code_splitting;
+            split.lazy_loading = options_.enable_lazy_loading;
+            split.budget_bytes = options_.code_split_kb * 1024;
+            std::vector<LamiaTranspiler::Chunk> chunks;
+            
+            // Source maps are recorded while the outputs stream
+            LamiaSourceMap html_map, js_map;
+            LamiaSourceMap* html_mapping = options_.source_maps ? &html_map : nullptr;
+            LamiaSourceMap* js_mapping = options_.source_maps ? &js_map : nullptr;
+            
+            // Generate HTML and JavaScript straight into their files
+            if (!write_output(output_dir + "/index.html", [&](LamiaOutputSink& out) { transpiler.transpile_to_html(ast, out); }, html_mapping) ||
+                !write_output(output_dir + "/app.js", [&](LamiaOutputSink& out) { chunks = transpiler.transpile_to_javascript(ast, out, split); }, js_mapping)) {
+                return false;
+            }
+            
+            std::vector<std::string> generated = {"index.html", "app.js"};
+            for (const auto& chunk : chunks) {
+                LamiaSourceMap chunk_map;
+                if (!write_output(output_dir + "/" + chunk.filename, [&](LamiaOutputSink& out) { out.write(chunk.content, chunk.map); },
+                                  options_.source_maps ? &chunk_map : nullptr)) {
+                    return false;
+                }
+                generated.push_back(chunk.filename);
+                if (options_.source_maps && !write_source_map(output_dir, chunk.filename, chunk_map, input_file, generated)) {
+                    return false;
+                }
+            }
+            if (options_.source_maps &&
+                (!write_source_map(output_dir, "index.html", html_map, input_file, generated) ||
+                 !write_source_map(output_dir, "app.js", js_map, input_file, generated))) {
+                return false;
+            }
+            if (!chunks.empty()) {
+                log() << "Split " << chunks.size() << " lazily loaded chunk(s) out of app.js" << std::endl;
+            }
             
-            // Generate JavaScript
-            std::string js = transpiler.transpile_to_javascript(ast);
-            std::ofstream js_file(output_dir + "/app.js");
-            js_file << js;
-            js_file.close();
+            if (cache_enabled_) {
+                cache.store(cache_key, output_dir, generated);
+            }
             
-            std::cout << "Transpilation complete! Generated real HTML and JavaScript." << std::endl;
+            log() << "Transpilation complete! Generated real HTML and JavaScript." << std::endl;
             return true;
             
         } catch (const std::exception& e) {
@@ -817,8 +1476,153 @@ public:
             return false;
         }
     }
+    
+private:
+    /**
+     * @brief Progress stream - stdout, or a discarding stream when silenced
+     */
+    std::ostream& log() const {
+        thread_local std::ostream silent(nullptr);
+        return verbose_ ? std::cout : silent;
+    }
+    
+    /**
+     * @brief Stream one generator into a fresh output file (LamiaFileSink replaces, never truncates)
+     *
+     * An output over the bundle budget fails the compilation; the file is
+     * kept for inspection but never cached. With map set, the output is
+     * recorded into it and a script gets a sourceMappingURL comment; HTML
+     * has no such comment, its map is found by name.
+     */
+    template<typename Generator>
+    bool write_output(const std::string& path, Generator&& generate, LamiaSourceMap* map = nullptr) {
+        LamiaFileSink out(path);
+        if (!out.is_open()) {
+            std::cerr << "Cannot write output: " << path << std::endl;
+            return false;
+        }
+        out.set_source_map(map);
+        generate(out);
+        out.set_source_map(nullptr);
+        if (map && std::filesystem::path(path).extension() == ".js") {
+            out << "//# sourceMappingURL=" << std::filesystem::path(path).filename().string() << ".map\n";
+        }
+        if (!out.close()) {
+            std::cerr << "Cannot write output: " << path << std::endl;
+            return false;
+        }
+        if (options_.max_bundle_size_kb && out.bytes_written() > options_.max_bundle_size_kb * 1024) {
+            std::cerr << "Bundle too large: " << path << " is " << (out.bytes_written() + 1023) / 1024
+                      << " KB, over the " << options_.max_bundle_size_kb << " KB budget (max_bundle_size_kb)" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Write output_dir/<filename>.map and list it with the generated files
+     *
+     * Maps are not deployed with the bundle, so the budget does not apply.
+     */
+    bool write_source_map(const std::string& output_dir, const std::string& filename, const LamiaSourceMap& map,
+                          const std::string& input_file, std::vector<std::string>& generated) {
+        std::string path = output_dir + "/" + filename + ".map";
+        LamiaFileSink out(path);
+        if (out.is_open()) {
+            out << map.to_json(filename, map_source_name(input_file, output_dir));
+        }
+        if (!out.close()) {
+            std::cerr << "Cannot write output: " << path << std::endl;
+            return false;
+        }
+        generated.push_back(filename + ".map");
+        return true;
+    }
+    
+    /**
+     * @brief The source as a map in output_dir refers to it
+     */
+    static std::string map_source_name(const std::string& input_file, const std::string& output_dir) {
+        std::error_code ec;
+        auto relative = std::filesystem::relative(std::filesystem::absolute(input_file, ec), std::filesystem::absolute(output_dir, ec), ec);
+        return ec || relative.empty() ? std::filesystem::path(input_file).filename().string() : relative.generic_string();
+    }
 };
 
+/**
+ * @brief Compile every .lamia file under input (directory or manifest) in parallel
+ *
+ * Each file gets its own RealLamiaCompiler; outputs mirror the source tree
+ * as output_dir/<relative dir>/<stem>/{index.html,app.js}.
+ */
+inline bool compile_tree_parallel(const std::string& input, const std::string& output_dir, size_t jobs,
+                                  const RealCompileOptions& options) {
+    std::vector<LamiaBatchJob> sources = collect_lamia_sources(input);
+    if (sources.empty()) {
+        std::cerr << "No .lamia sources found in: " << input << std::endl;
+        return false;
+    }
+    
+    std::string cache_dir = LamiaCompileCache::directory_for(output_dir).string();
+    std::cout << "Batch compiling " << sources.size() << " sources with " << std::max<size_t>(jobs, 1) << " workers" << std::endl;
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::mutex report_mutex;
+    size_t completed = 0, tokens = 0, nodes = 0, hits = 0, misses = 0;
+    std::chrono::milliseconds compile_time{0};
+    std::vector<std::string> failed;
+    
+    {
+        LamiaWorkStealingPool pool(jobs);
+        for (const auto& source : sources) {
+            pool.submit([&, source]() {
+                auto file_start = std::chrono::high_resolution_clock::now();
+                std::string target_dir = source.output_dir(output_dir).string();
+                
+                RealLamiaCompiler compiler(false);
+                compiler.set_cache_directory(cache_dir);
+                compiler.set_options(options);
+                std::error_code ec;
+                std::filesystem::create_directories(target_dir, ec);
+                bool ok = compiler.compile_file(source.input.string(), target_dir);
+                
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::high_resolution_clock::now() - file_start);
+                
+                std::lock_guard<std::mutex> lock(report_mutex);
+                tokens += compiler.tokens_generated();
+                nodes += compiler.ast_nodes_created();
+                hits += compiler.cache_hits();
+                misses += compiler.cache_misses();
+                compile_time += elapsed;
+                if (!ok) {
+                    failed.push_back(source.input.string());
+                }
+                std::cout << (ok ? "[" : "FAILED [") << ++completed << "/" << sources.size() << "] "
+                          << source.input.string() << " (" << elapsed.count() << "ms)" << std::endl;
+            });
+        }
+        pool.wait_idle();
+    }
+    
+    auto wall_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    
+    std::cout << std::endl << "Batch statistics:" << std::endl;
+    std::cout << "  Sources: " << sources.size() << " (" << failed.size() << " failed)" << std::endl;
+    std::cout << "  Tokens: " << tokens << std::endl;
+    std::cout << "  AST nodes: " << nodes << std::endl;
+    std::cout << "  Compile time (sum): " << compile_time.count() << "ms" << std::endl;
+    std::cout << "  Wall time: " << wall_time.count() << "ms" << std::endl;
+    std::cout << "  Cache hits/misses: " << hits << "/" << misses << std::endl;
+    for (const auto& path : failed) {
+        std::cout << "  Failed: " << path << std::endl;
+    }
+    
+    return failed.empty();
+}
+
 } // namespace Lamia
 } // namespace Language
 } // namespace MedusaServ
@@ -833,10 +1637,48 @@ int main(int argc, char* argv[]) {
     std::cout << "Ground-up lexer, parser, AST, and code generation" << std::endl;
     std::cout << std::endl;
     
-    MedusaServ::Language::Lamia::RealLamiaCompiler compiler;
+    // Positional arguments plus --jobs N / -j N for batch mode and the output settings
+    std::vector<std::string> args;
+    size_t jobs = 0;
+    MedusaServ::Language::Lamia::RealCompileOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            jobs = std::strtoul(argv[++i], nullptr, 10);
+            if (jobs == 0) {
+                jobs = std::thread::hardware_concurrency();
+            }
+        } else if (arg == "--max-bundle-kb" && i + 1 < argc) {
+            options.max_bundle_size_kb = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--chunk-kb" && i + 1 < argc) {
+            options.code_split_kb = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--no-code-splitting") {
+            options.enable_code_splitting = false;
+        } else if (arg == "--no-lazy-loading") {
+            options.enable_lazy_loading = false;
+        } else if (arg == "--no-optimize") {
+            options.optimize_ast = false;
+        } else if (arg == "--no-source-maps") {
+            options.source_maps = false;
+        } else {
+            args.push_back(arg);
+        }
+    }
     
-    std::string input_file = (argc > 1) ? argv[1] : "SuperiorLamiaApp_lamia_app/src/main.lamia";
-    std::string output_dir = (argc > 2) ? argv[2] : "lamia_real_output";
+    std::string input_file = !args.empty() ? args[0] : "SuperiorLamiaApp_lamia_app/src/main.lamia";
+    std::string output_dir = args.size() > 1 ? args[1] : "lamia_real_output";
+    
+    // Directories and manifests compile as a batch
+    if (jobs > 0 || std::filesystem::is_directory(input_file) ||
+        std::filesystem::path(input_file).extension() != ".lamia") {
+        bool ok = MedusaServ::Language::Lamia::compile_tree_parallel(
+            input_file, output_dir, jobs ? jobs : std::thread::hardware_concurrency(), options);
+        std::cout << std::endl << (ok ? "🏆 BATCH COMPILATION SUCCESS!" : "❌ BATCH COMPILATION FAILED!") << std::endl;
+        return ok ? 0 : 1;
+    }
+    
+    MedusaServ::Language::Lamia::RealLamiaCompiler compiler;
+    compiler.set_options(options);
     
     // Create output directory
     system(("mkdir -p " + output_dir).c_str());
@@ -845,6 +1687,7 @@ int main(int argc, char* argv[]) {
         std::cout << std::endl << "🏆 REAL COMPILATION SUCCESS!" << std::endl;
         std::cout << "Actual Lamia syntax parsed and transpiled to real HTML/JS!" << std::endl;
         std::cout << "Output directory: " << output_dir << std::endl;
+        std::cout << "Cache hits/misses: " << compiler.cache_hits() << "/" << compiler.cache_misses() << std::endl;
         return 0;
     } else {
         std::cout << std::endl << "❌ COMPILATION FAILED!" << std::endl;
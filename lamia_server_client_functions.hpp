@@ -29,10 +29,11 @@
 
 #pragma once
 
-#include "lamia_extensible_architecture.hpp"
+#include "lamia_bytecode.hpp"
 #include <string>
 #include <vector>
 #include <map>
+#include <sstream>
 #include <memory>
 #include <functional>
 #include <chrono>
@@ -185,7 +186,7 @@ private:
  
  // Execution statistics
  mutable std::atomic<size_t> call_count_{0};
- mutable std::atomic<std::chrono::microseconds> total_execution_time_{std::chrono::microseconds{0}};
+ mutable std::atomic<std::chrono::microseconds::rep> total_execution_time_{0}; // Microseconds: atomic<duration> has no fetch_add
  mutable std::mutex stats_mutex_;
  
  // AI integration
@@ -193,6 +194,10 @@ private:
  std::string ai_optimization_context_;
  double ai_performance_gain_ = 1.0;
  
+ // Precompiled manifest body (lamia_bytecode.hpp), run server-side instead of the body text
+ std::shared_ptr<const LamiaBytecodeInterpreter> bytecode_;
+ size_t bytecode_function_ = 0;
+ 
  // Caching
  mutable std::map<std::string, std::string> cache_;
  mutable std::mutex cache_mutex_;
@@ -211,6 +216,17 @@ public:
  compiled_ = false; // Recompilation needed
  }
  
+ /**
+ * @brief Run server-side calls from a loaded bytecode module instead of the body text
+ */
+ void set_bytecode(std::shared_ptr<const LamiaBytecodeInterpreter> interpreter, size_t function) {
+ bytecode_ = std::move(interpreter);
+ bytecode_function_ = function;
+ compiled_ = true; // The bytecode is the compiled form
+ }
+ 
+ bool has_bytecode() const { return bytecode_ != nullptr; }
+ 
  /**
  * @brief Add parameter
  */
@@ -308,7 +324,7 @@ public:
  // Update statistics
  auto end_time = std::chrono::high_resolution_clock::now();
  auto execution_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
- total_execution_time_.fetch_add(execution_time, std::memory_order_relaxed);
+ total_execution_time_.fetch_add(execution_time.count(), std::memory_order_relaxed);
  
  return result;
  }
@@ -320,7 +336,7 @@ public:
  std::lock_guard<std::mutex> lock(stats_mutex_);
  
  size_t calls = call_count_.load();
- auto total_time = total_execution_time_.load();
+ auto total_time = std::chrono::microseconds(total_execution_time_.load());
  
  double avg_time = calls > 0 ? static_cast<double>(total_time.count()) / calls : 0.0;
  double calls_per_second = total_time.count() > 0 ? (calls * 1000000.0) / total_time.count() : 0.0;
@@ -558,10 +574,32 @@ private:
  * @brief Execute server-side
  */
  std::string execute_server_side(const std::map<std::string, std::string>& args) const {
+ if (bytecode_) {
+ return execute_bytecode(args);
+ }
  // Revolutionary server-side execution faster than Python
  return "// Server-side execution result";
  }
  
+ /**
+ * @brief Run the bytecode body: named arguments go to registers in parameter order
+ */
+ std::string execute_bytecode(const std::map<std::string, std::string>& args) const {
+ thread_local LamiaBytecodeScratch scratch;
+ 
+ std::vector<LamiaBytecodeValue> values;
+ values.reserve(parameters_.size());
+ for (const auto& param : parameters_) {
+ auto it = args.find(param.name);
+ values.push_back(it != args.end() ? LamiaBytecodeValue::of(std::string_view(it->second)) : LamiaBytecodeValue());
+ }
+ 
+ scratch.clear();
+ std::string result = bytecode_->call(bytecode_function_, values.data(), values.size(), scratch).to_string();
+ scratch.clear();
+ return result;
+ }
+ 
  /**
  * @brief Execute client-side
  */
@@ -814,9 +852,12 @@ private:
  std::map<ExecutionContext, std::vector<std::string>> functions_by_context_;
  std::map<LamiaFunctionType, std::vector<std::string>> functions_by_type_;
  
+ // Host functions that bytecode modules import
+ LamiaHostFunctions host_functions_;
+ 
  // Performance monitoring
  std::atomic<size_t> total_function_calls_{0};
- std::atomic<std::chrono::microseconds> total_execution_time_{std::chrono::microseconds{0}};
+ std::atomic<std::chrono::microseconds::rep> total_execution_time_{0}; // Microseconds
  
  mutable std::mutex registry_mutex_;
  
@@ -843,6 +884,48 @@ public:
  return true;
  }
  
+ /**
+ * @brief Make a native function callable from bytecode; register before load_bytecode()
+ */
+ void register_host_function(const std::string& name, LamiaHostFunction function) {
+ std::lock_guard<std::mutex> lock(registry_mutex_);
+ host_functions_[name] = std::move(function);
+ }
+ 
+ /**
+ * @brief Map a compiled .lbc module and register each of its manifests as a server function
+ * @return Number of functions registered; 0 with error set if the module is unusable
+ */
+ size_t load_bytecode(const std::string& path, std::string* error = nullptr) {
+ auto module = std::make_shared<const LamiaBytecodeModule>(path);
+ if (!module->is_valid()) {
+ if (error) *error = path + ": " + module->error();
+ return 0;
+ }
+ 
+ std::shared_ptr<const LamiaBytecodeInterpreter> interpreter;
+ {
+ std::lock_guard<std::mutex> lock(registry_mutex_);
+ interpreter = std::make_shared<const LamiaBytecodeInterpreter>(module, host_functions_);
+ }
+ 
+ size_t registered = 0;
+ for (size_t i = 0; i < module->function_count(); ++i) {
+ const auto& entry = module->function(i);
+ auto function = std::make_unique<LamiaFunction>(std::string(module->function_name(i)),
+ LamiaFunctionType::MANIFEST, ExecutionContext::SERVER_SIDE);
+ for (size_t p = 0; p < entry.parameters; ++p) {
+ LamiaParameter param;
+ param.name = std::string(module->parameter_name(entry, p));
+ param.is_optional = true; // Missing arguments arrive as null
+ function->add_parameter(param);
+ }
+ function->set_bytecode(interpreter, i);
+ registered += register_function(std::move(function)) ? 1 : 0;
+ }
+ return registered;
+ }
+ 
  /**
  * @brief Get function
  */
@@ -869,7 +952,7 @@ public:
  
  auto end_time = std::chrono::high_resolution_clock::now();
  auto execution_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
- total_execution_time_.fetch_add(execution_time, std::memory_order_relaxed);
+ total_execution_time_.fetch_add(execution_time.count(), std::memory_order_relaxed);
  
  return result;
  }
@@ -901,7 +984,7 @@ public:
  std::lock_guard<std::mutex> lock(registry_mutex_);
  
  size_t total_calls = total_function_calls_.load();
- auto total_time = total_execution_time_.load();
+ auto total_time = std::chrono::microseconds(total_execution_time_.load());
  
  double avg_time = total_calls > 0 ? static_cast<double>(total_time.count()) / total_calls : 0.0;
  double calls_per_second = total_time.count() > 0 ? (total_calls * 1000000.0) / total_time.count() : 0.0;
@@ -0,0 +1,237 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA SIMD SCAN v0.3.0c
+ * =======================
+ *
+ * Vectorized byte scanning for the lexer's long-running tokens
+ * - Whitespace runs, comment bodies and string bodies are skipped
+ *   32 bytes (AVX2) or 16 bytes (SSE2) at a time
+ * - Newlines inside a skipped span are counted in bulk so line and
+ *   column bookkeeping costs one pass per span, not one branch per byte
+ * - Builds without SSE2 use the scalar fallback; AVX2 is used when the
+ *   translation unit is compiled with -mavx2 (or -march supporting it)
+ * - LamiaScan::set_vectorized(false) forces the scalar loops at run time
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LAMIA_SCAN_AVX2 1
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LAMIA_SCAN_SSE2 1 // Also finishes AVX2 scans shorter than 32 bytes
+#endif
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Scan - Find-first and count primitives over [begin, end)
+ *
+ * Every find returns end when nothing matches.
+ */
+struct LamiaScan {
+ /**
+ * @brief Name of the active implementation, for benchmarks and diagnostics
+ */
+ static const char* implementation() {
+ if (!vectorized()) {
+ return "scalar";
+ }
+#if defined(LAMIA_SCAN_AVX2)
+ return "AVX2";
+#elif defined(LAMIA_SCAN_SSE2)
+ return "SSE2";
+#else
+ return "scalar";
+#endif
+ }
+
+ /**
+ * @brief Turn the vector paths off (or back on) for the whole process
+ *
+ * Lets benchmarks and differential tests run the lexer on its scalar
+ * loops without a second build. On by default.
+ */
+ static void set_vectorized(bool enabled) {
+ vectorized_.store(enabled, std::memory_order_relaxed);
+ }
+
+ static bool vectorized() {
+ return vectorized_.load(std::memory_order_relaxed);
+ }
+
+ /**
+ * @brief First occurrence of any of a, b or c
+ */
+ static const char* find_any(const char* p, const char* end, char a, char b, char c) {
+#if defined(LAMIA_SCAN_AVX2)
+ if (vectorized()) {
+ const __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b), vc = _mm256_set1_epi8(c);
+ for (; end - p >= 32; p += 32) {
+ __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+ __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, va), _mm256_cmpeq_epi8(chunk, vb)),
+ _mm256_cmpeq_epi8(chunk, vc));
+ uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+ if (mask) {
+ return p + __builtin_ctz(mask);
+ }
+ }
+ }
+#endif
+#if defined(LAMIA_SCAN_SSE2)
+ if (vectorized()) {
+ const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+ for (; end - p >= 16; p += 16) {
+ __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+ __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)),
+ _mm_cmpeq_epi8(chunk, vc));
+ uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+ if (mask) {
+ return p + __builtin_ctz(mask);
+ }
+ }
+ }
+#endif
+ for (; p < end; ++p) {
+ if (*p == a || *p == b || *p == c) {
+ return p;
+ }
+ }
+ return end;
+ }
+
+ static const char* find_any(const char* p, const char* end, char a, char b) {
+ return find_any(p, end, a, b, b);
+ }
+
+ static const char* find(const char* p, const char* end, char a) {
+ return find_any(p, end, a, a, a);
+ }
+
+ /**
+ * @brief Start of the first "* /" terminator (without the space)
+ */
+ static const char* find_comment_end(const char* p, const char* end) {
+ while (p < end) {
+ p = find(p, end, '*');
+ if (end - p < 2) {
+ return end;
+ }
+ if (p[1] == '/') {
+ return p;
+ }
+ ++p;
+ }
+ return end;
+ }
+
+ /**
+ * @brief First byte that is not horizontal whitespace (space, \t, \v, \f, \r)
+ */
+ static const char* skip_horizontal_space(const char* p, const char* end) {
+#if defined(LAMIA_SCAN_AVX2)
+ if (vectorized()) {
+ const __m256i space = _mm256_set1_epi8(' '), newline = _mm256_set1_epi8('\n');
+ const __m256i below_tab = _mm256_set1_epi8('\t' - 1), above_cr = _mm256_set1_epi8('\r' + 1);
+ for (; end - p >= 32; p += 32) {
+ __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+ __m256i control = _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, newline),
+ _mm256_and_si256(_mm256_cmpgt_epi8(chunk, below_tab), _mm256_cmpgt_epi8(above_cr, chunk)));
+ __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), control);
+ uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(blank));
+ if (mask) {
+ return p + __builtin_ctz(mask);
+ }
+ }
+ }
+#endif
+#if defined(LAMIA_SCAN_SSE2)
+ if (vectorized()) {
+ const __m128i space = _mm_set1_epi8(' '), newline = _mm_set1_epi8('\n');
+ const __m128i below_tab = _mm_set1_epi8('\t' - 1), above_cr = _mm_set1_epi8('\r' + 1);
+ for (; end - p >= 16; p += 16) {
+ __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+ __m128i control = _mm_andnot_si128(_mm_cmpeq_epi8(chunk, newline),
+ _mm_and_si128(_mm_cmpgt_epi8(chunk, below_tab), _mm_cmplt_epi8(chunk, above_cr)));
+ __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), control);
+ uint32_t mask = static_cast<uint32_t>(~_mm_movemask_epi8(blank)) & 0xFFFFu;
+ if (mask) {
+ return p + __builtin_ctz(mask);
+ }
+ }
+ }
+#endif
+ for (; p < end; ++p) {
+ if (!is_horizontal_space(*p)) {
+ return p;
+ }
+ }
+ return end;
+ }
+
+ /**
+ * @brief Count newlines in [p, end), reporting the last one (or nullptr)
+ */
+ static size_t count_newlines(const char* p, const char* end, const char** last_newline) {
+ size_t count = 0;
+ const char* last = nullptr;
+#if defined(LAMIA_SCAN_AVX2)
+ if (vectorized()) {
+ const __m256i newline = _mm256_set1_epi8('\n');
+ for (; end - p >= 32; p += 32) {
+ __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+ uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+ if (mask) {
+ count += static_cast<size_t>(__builtin_popcount(mask));
+ last = p + 31 - __builtin_clz(mask);
+ }
+ }
+ }
+#endif
+#if defined(LAMIA_SCAN_SSE2)
+ if (vectorized()) {
+ const __m128i newline = _mm_set1_epi8('\n');
+ for (; end - p >= 16; p += 16) {
+ __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+ uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+ if (mask) {
+ count += static_cast<size_t>(__builtin_popcount(mask));
+ last = p + 31 - __builtin_clz(mask);
+ }
+ }
+ }
+#endif
+ for (; p < end; ++p) {
+ if (*p == '\n') {
+ ++count;
+ last = p;
+ }
+ }
+ if (last_newline) {
+ *last_newline = last;
+ }
+ return count;
+ }
+
+ static constexpr bool is_horizontal_space(char c) {
+ return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r';
+ }
+
+private:
+ static inline std::atomic<bool> vectorized_{true};
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
@@ -0,0 +1,162 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA SOURCE BUFFER v0.3.0c
+ * ===========================
+ *
+ * Read-only view of a .lamia source file for the lexers
+ * - Regular files are memory-mapped: no copy, pages fault in as the
+ *   lexer reaches them
+ * - Anything that cannot be mapped (pipes, special files, mmap failure)
+ *   is read into one exactly-sized allocation
+ *
+ * Tokens view this buffer directly, so it must outlive the token stream.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Source Buffer - Owns the bytes of one source file
+ */
+class LamiaSourceBuffer {
+private:
+ const char* data_ = nullptr;
+ size_t size_ = 0;
+ bool open_ = false;
+ bool mapped_ = false;
+ std::unique_ptr<char[]> owned_; // Fallback storage
+
+public:
+ LamiaSourceBuffer() = default;
+
+ explicit LamiaSourceBuffer(const std::string& path) {
+ int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+ if (fd < 0) {
+ return;
+ }
+
+ struct stat info;
+ if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+ size_ = static_cast<size_t>(info.st_size);
+ if (size_ == 0) {
+ open_ = true; // Empty file: nothing to map
+ } else {
+ void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+ if (mapping != MAP_FAILED) {
+ ::madvise(mapping, size_, MADV_SEQUENTIAL); // The lexer makes one forward pass
+ data_ = static_cast<const char*>(mapping);
+ open_ = mapped_ = true;
+ } else {
+ open_ = read_all(fd, size_);
+ }
+ }
+ } else {
+ open_ = read_all(fd, 0);
+ }
+
+ ::close(fd); // A mapping stays valid after its descriptor is closed
+ }
+
+ ~LamiaSourceBuffer() {
+ release();
+ }
+
+ LamiaSourceBuffer(LamiaSourceBuffer&& other) noexcept {
+ *this = std::move(other);
+ }
+
+ LamiaSourceBuffer& operator=(LamiaSourceBuffer&& other) noexcept {
+ if (this != &other) {
+ release();
+ data_ = other.data_;
+ size_ = other.size_;
+ open_ = other.open_;
+ mapped_ = other.mapped_;
+ owned_ = std::move(other.owned_);
+ other.data_ = nullptr;
+ other.size_ = 0;
+ other.open_ = other.mapped_ = false;
+ }
+ return *this;
+ }
+
+ LamiaSourceBuffer(const LamiaSourceBuffer&) = delete;
+ LamiaSourceBuffer& operator=(const LamiaSourceBuffer&) = delete;
+
+ bool is_open() const { return open_; }
+ bool is_mapped() const { return mapped_; }
+ bool empty() const { return size_ == 0; }
+ size_t size() const { return size_; }
+ std::string_view view() const { return std::string_view(data_ ? data_ : "", size_); }
+
+private:
+ /**
+ * @brief Fallback: one allocation and (for regular files) a single read()
+ * @param expected Known size, or 0 to grow until end of file
+ */
+ bool read_all(int fd, size_t expected) {
+ size_t capacity = expected ? expected : 64 * 1024;
+ owned_.reset(new char[capacity]);
+ size_ = 0;
+
+ while (true) {
+ if (size_ == capacity) {
+ if (expected) {
+ break; // Read exactly what fstat reported
+ }
+ std::unique_ptr<char[]> grown(new char[capacity * 2]);
+ std::copy(owned_.get(), owned_.get() + size_, grown.get());
+ owned_ = std::move(grown);
+ capacity *= 2;
+ }
+
+ ssize_t count = ::read(fd, owned_.get() + size_, capacity - size_);
+ if (count < 0) {
+ if (errno == EINTR) {
+ continue;
+ }
+ owned_.reset();
+ size_ = 0;
+ return false;
+ }
+ if (count == 0) {
+ break;
+ }
+ size_ += static_cast<size_t>(count);
+ }
+
+ data_ = owned_.get();
+ return true;
+ }
+
+ void release() {
+ if (mapped_ && data_) {
+ ::munmap(const_cast<char*>(data_), size_);
+ }
+ owned_.reset();
+ data_ = nullptr;
+ size_ = 0;
+ open_ = mapped_ = false;
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
@@ -0,0 +1,324 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA SOURCE MAP v0.3.0c
+ * ========================
+ *
+ * Source Map v3 line tables for generated JS, HTML and CSS
+ * - Built while the output streams: an output sink reports every fragment
+ *   it writes, emitters mark where each node's code starts
+ * - Segments are delta-encoded as base64 VLQ the moment they are added, so
+ *   a map costs a few bytes per mapped node and no second pass
+ * - Source positions come as views into the source text (converted through
+ *   a line-start table built on first use) or as 1-based line/column pairs
+ * - A position is held until visible generated text follows it, so nodes
+ *   that write nothing to this output leave no segment behind
+ * - Columns count UTF-16 code units, as browsers do
+ *
+ * This header depends on nothing but the standard library.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+/**
+ * @brief Lamia Source Map - Incrementally encoded mappings from one output to one source
+ */
+class LamiaSourceMap {
+private:
+ std::string_view source_; // Text that add(std::string_view) locations point into
+ std::vector<size_t> line_starts_; // Offsets of each source line, built on first use
+ size_t line_hint_ = 0; // Line of the last lookup - emit order mostly follows the source
+
+ // Where the next generated byte goes
+ size_t generated_line_ = 0;
+ size_t generated_column_ = 0;
+
+ // Previous segment, the base of the next one's deltas
+ bool line_has_segment_ = false;
+ int64_t previous_column_ = 0; // Resets on every generated line
+ int64_t previous_source_line_ = 0;
+ int64_t previous_source_column_ = 0;
+
+ // Position marked at the current column, committed by the next generated text
+ bool pending_ = false;
+ size_t pending_line_ = 0;
+ size_t pending_column_ = 0;
+
+ std::string mappings_;
+ size_t segments_ = 0;
+
+public:
+ /**
+ * @param source Text that locations passed to add(std::string_view) view into
+ */
+ explicit LamiaSourceMap(std::string_view source = {}) : source_(source) {}
+
+ /**
+ * @brief Account for generated text written after the last call
+ */
+ void advance(std::string_view generated) {
+ if (pending_) {
+ // The mark belongs to the node's first visible character, not the indentation before it
+ size_t visible = generated.find_first_not_of(" \t\r\n");
+ if (visible == std::string_view::npos) {
+ move_over(generated);
+ return;
+ }
+ move_over(generated.substr(0, visible));
+ commit_pending();
+ generated.remove_prefix(visible);
+ }
+ move_over(generated);
+ }
+
+ /**
+ * @brief Map the current generated position to a location inside the source text
+ *
+ * Views that do not point into the source (interned copies, other buffers) are ignored.
+ */
+ void add(std::string_view location) {
+ if (location.data() < source_.data() || location.data() > source_.data() + source_.size() || source_.empty()) {
+ return;
+ }
+ size_t offset = static_cast<size_t>(location.data() - source_.data());
+ size_t line = line_of(offset);
+ mark(line, utf16_length(source_.substr(line_starts_[line], offset - line_starts_[line])));
+ }
+
+ /**
+ * @brief Map the current generated position to a 1-based source line and column
+ */
+ void add(size_t line, size_t column) {
+ if (line == 0) {
+ return; // Unknown position
+ }
+ mark(line - 1, column ? column - 1 : 0);
+ }
+
+ /**
+ * @brief Account for generated text rendered elsewhere, with fragment's mappings for it
+ *
+ * fragment was built for generated on its own, starting at line 0, column 0.
+ */
+ void append(std::string_view generated, const LamiaSourceMap& fragment) {
+ if (generated.find_first_not_of(" \t\r\n") == std::string_view::npos) {
+ move_over(generated);
+ return;
+ }
+ commit_pending();
+ size_t base_line = generated_line_;
+ size_t base_column = generated_column_;
+ fragment.for_each_segment([&](size_t line, size_t column, size_t source_line, size_t source_column) {
+ move_to_line(base_line + line);
+ add_segment((line == 0 ? base_column : 0) + column, source_line, source_column);
+ });
+
+ size_t newlines = static_cast<size_t>(std::count(generated.begin(), generated.end(), '\n'));
+ move_to_line(base_line + newlines);
+ generated_column_ = newlines ? utf16_length(generated.substr(generated.rfind('\n') + 1)) :
+ base_column + utf16_length(generated);
+ }
+
+ /**
+ * @brief Forget a mark no text has followed yet - what comes next belongs to no node
+ */
+ void drop_mark() { pending_ = false; }
+
+ size_t segments() const { return segments_; }
+ const std::string& mappings() const { return mappings_; }
+
+ /**
+ * @brief The map file: version 3, one source, no names
+ * @param file The generated file, as the map names it
+ * @param source_name The source, relative to the map's directory
+ */
+ std::string to_json(std::string_view file, std::string_view source_name) const {
+ std::string json = "{\"version\":3,\"file\":";
+ append_json_string(json, file);
+ json += ",\"sources\":[";
+ append_json_string(json, source_name);
+ json += "],\"names\":[],\"mappings\":\"";
+ json += mappings_;
+ json += "\"}\n";
+ return json;
+ }
+
+ /**
+ * @brief Decode the mappings: generated line/column and source line/column, all 0-based
+ */
+ void for_each_segment(const std::function<void(size_t, size_t, size_t, size_t)>& visit) const {
+ size_t line = 0;
+ int64_t fields[4] = {0, 0, 0, 0}; // Column, source, source line, source column
+ size_t field = 0;
+ int64_t value = 0;
+ int shift = 0;
+ for (char c : mappings_) {
+ if (c == ';' || c == ',') {
+ if (c == ';') {
+ ++line;
+ fields[0] = 0;
+ }
+ continue;
+ }
+ int digit = base64_value(c);
+ value |= static_cast<int64_t>(digit & 31) << shift;
+ if (digit & 32) {
+ shift += 5;
+ continue;
+ }
+ fields[field] += (value & 1) ? -(value >> 1) : (value >> 1);
+ value = 0;
+ shift = 0;
+ if (++field == 4) {
+ field = 0;
+ visit(line, static_cast<size_t>(fields[0]), static_cast<size_t>(fields[2]), static_cast<size_t>(fields[3]));
+ }
+ }
+ }
+
+private:
+ void move_over(std::string_view generated) {
+ const char* newline = static_cast<const char*>(std::memchr(generated.data(), '\n', generated.size()));
+ if (!newline) {
+ generated_column_ += utf16_length(generated);
+ return;
+ }
+ while (newline) {
+ next_line();
+ size_t rest = generated.size() - static_cast<size_t>(newline + 1 - generated.data());
+ generated = generated.substr(generated.size() - rest);
+ newline = static_cast<const char*>(std::memchr(generated.data(), '\n', generated.size()));
+ }
+ generated_column_ = utf16_length(generated);
+ }
+
+ void mark(size_t source_line, size_t source_column) {
+ pending_ = true; // A later mark before any text replaces this one
+ pending_line_ = source_line;
+ pending_column_ = source_column;
+ }
+
+ void commit_pending() {
+ if (pending_) {
+ pending_ = false;
+ add_segment(generated_column_, pending_line_, pending_column_);
+ }
+ }
+
+ void next_line() {
+ mappings_ += ';';
+ ++generated_line_;
+ generated_column_ = 0;
+ previous_column_ = 0;
+ line_has_segment_ = false;
+ }
+
+ void move_to_line(size_t line) {
+ while (generated_line_ < line) {
+ next_line();
+ }
+ }
+
+ void add_segment(size_t column, size_t source_line, size_t source_column) {
+ if (line_has_segment_ && static_cast<int64_t>(column) == previous_column_) {
+ return; // A segment already covers this column
+ }
+ if (line_has_segment_) {
+ mappings_ += ',';
+ }
+ append_vlq(static_cast<int64_t>(column) - previous_column_);
+ append_vlq(0); // Always the one source
+ append_vlq(static_cast<int64_t>(source_line) - previous_source_line_);
+ append_vlq(static_cast<int64_t>(source_column) - previous_source_column_);
+ previous_column_ = static_cast<int64_t>(column);
+ previous_source_line_ = static_cast<int64_t>(source_line);
+ previous_source_column_ = static_cast<int64_t>(source_column);
+ line_has_segment_ = true;
+ ++segments_;
+ }
+
+ void append_vlq(int64_t value) {
+ static constexpr char DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+ uint64_t bits = value < 0 ? (static_cast<uint64_t>(-value) << 1) | 1 : static_cast<uint64_t>(value) << 1;
+ do {
+ unsigned digit = bits & 31;
+ bits >>= 5;
+ mappings_ += DIGITS[bits ? digit | 32 : digit];
+ } while (bits);
+ }
+
+ static int base64_value(char c) {
+ if (c >= 'A' && c <= 'Z') return c - 'A';
+ if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+ if (c >= '0' && c <= '9') return c - '0' + 52;
+ return c == '+' ? 62 : 63;
+ }
+
+ size_t line_of(size_t offset) {
+ if (line_starts_.empty()) {
+ line_starts_.push_back(0);
+ for (size_t i = 0; i < source_.size(); ++i) {
+ if (source_[i] == '\n') {
+ line_starts_.push_back(i + 1);
+ }
+ }
+ }
+ // Usually the same line as last time or a few below it
+ if (line_starts_[line_hint_] > offset) {
+ line_hint_ = static_cast<size_t>(std::upper_bound(line_starts_.begin(), line_starts_.end(), offset) - line_starts_.begin()) - 1;
+ }
+ while (line_hint_ + 1 < line_starts_.size() && line_starts_[line_hint_ + 1] <= offset) {
+ ++line_hint_;
+ }
+ return line_hint_;
+ }
+
+ /**
+ * @brief Length in UTF-16 code units: one per character, two above U+FFFF
+ */
+ static size_t utf16_length(std::string_view text) {
+ size_t length = 0;
+ for (char c : text) {
+ unsigned char byte = static_cast<unsigned char>(c);
+ length += (byte & 0xC0) != 0x80; // Lead and ASCII bytes start a character
+ length += byte >= 0xF0; // Four-byte sequences are surrogate pairs
+ }
+ return length;
+ }
+
+ static void append_json_string(std::string& json, std::string_view text) {
+ json += '"';
+ for (char c : text) {
+ if (c == '"' || c == '\\') {
+ json += '\\';
+ json += c;
+ } else if (static_cast<unsigned char>(c) < 0x20) {
+ static constexpr char HEX[] = "0123456789abcdef";
+ json += "\\u00";
+ json += HEX[(c >> 4) & 0xF];
+ json += HEX[c & 0xF];
+ } else {
+ json += c;
+ }
+ }
+ json += '"';
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
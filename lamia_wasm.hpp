@@ -0,0 +1,263 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * LAMIA WASM v0.3.0c
+ * ==================
+ *
+ * WebAssembly 1.0 (MVP) binary encoder for the WEBASSEMBLY target
+ * - Every Lamia value crossing into a module is an f64: shimmer as is,
+ *   lumina as 0 or 1
+ * - Host functions are imported from the "lamia" module; manifests are
+ *   defined and exported under their own names
+ * - A custom "name" section carries the manifest names for disassemblers
+ *   and browser stack traces
+ *
+ * Layout: magic | version | type | import | function | export | code | name
+ *
+ * The output is a plain .wasm module, so it checks offline with any local
+ * validator (wasm-validate, or WebAssembly.validate under node).
+ *
+ * This header depends on nothing but the standard library.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MedusaServ {
+namespace Language {
+namespace Lamia {
+
+namespace LamiaWasm {
+
+constexpr char MAGIC[4] = {'\0', 'a', 's', 'm'};
+constexpr uint32_t VERSION = 1;
+constexpr char IMPORT_MODULE[] = "lamia"; // Module name of every host function import
+
+enum Section : uint8_t {
+ SECTION_CUSTOM = 0,
+ SECTION_TYPE = 1,
+ SECTION_IMPORT = 2,
+ SECTION_FUNCTION = 3,
+ SECTION_EXPORT = 7,
+ SECTION_CODE = 10
+};
+
+enum Opcode : uint8_t {
+ OP_END = 0x0B,
+ OP_CALL = 0x10,
+ OP_DROP = 0x1A,
+ OP_LOCAL_GET = 0x20,
+ OP_F64_CONST = 0x44
+};
+
+constexpr uint8_t TYPE_FUNC = 0x60;
+constexpr uint8_t TYPE_F64 = 0x7C;
+constexpr uint8_t EXTERNAL_FUNCTION = 0x00;
+constexpr uint8_t NAME_FUNCTIONS = 1; // Subsection of the "name" section
+
+inline void append_u32(std::string& out, uint32_t value) {
+ do {
+ uint8_t byte = value & 0x7F;
+ value >>= 7;
+ out += static_cast<char>(value ? byte | 0x80 : byte);
+ } while (value);
+}
+
+inline void append_name(std::string& out, std::string_view name) {
+ append_u32(out, static_cast<uint32_t>(name.size()));
+ out.append(name);
+}
+
+} // namespace LamiaWasm
+
+/**
+ * @brief Lamia Wasm Code - The instruction stream of one function body
+ */
+class LamiaWasmCode {
+private:
+ std::string bytes_;
+
+public:
+ void f64_const(double value) {
+ char bits[sizeof(value)];
+ std::memcpy(bits, &value, sizeof(value)); // IEEE 754, little-endian like the format
+ bytes_ += static_cast<char>(LamiaWasm::OP_F64_CONST);
+ bytes_.append(bits, sizeof(bits));
+ }
+
+ void local_get(uint32_t index) { op(LamiaWasm::OP_LOCAL_GET, index); }
+ void call(uint32_t function) { op(LamiaWasm::OP_CALL, function); }
+ void drop() { bytes_ += static_cast<char>(LamiaWasm::OP_DROP); }
+ void end() { bytes_ += static_cast<char>(LamiaWasm::OP_END); }
+
+ const std::string& bytes() const { return bytes_; }
+
+private:
+ void op(LamiaWasm::Opcode opcode, uint32_t immediate) {
+ bytes_ += static_cast<char>(opcode);
+ LamiaWasm::append_u32(bytes_, immediate);
+ }
+};
+
+/**
+ * @brief Lamia Wasm Writer - Assembles a module from imports and function bodies
+ *
+ * Imports come first in the function index space, so every import is
+ * added before the first function.
+ */
+class LamiaWasmWriter {
+public:
+ /**
+ * @brief Import host function name taking parameters f64s and returning one
+ * @return Its function index, for call
+ */
+ uint32_t import(std::string_view name, size_t parameters) {
+ if (!functions_.empty()) {
+ throw std::logic_error("wasm imports must precede the module's functions");
+ }
+ imports_.push_back({std::string(name), type(parameters)});
+ return static_cast<uint32_t>(imports_.size() - 1);
+ }
+
+ /**
+ * @brief Index the next add_function() will get
+ */
+ uint32_t next_function() const {
+ return static_cast<uint32_t>(imports_.size() + functions_.size());
+ }
+
+ /**
+ * @brief Define and export function name; code must end with end()
+ */
+ uint32_t add_function(std::string_view name, size_t parameters, const LamiaWasmCode& code) {
+ functions_.push_back({std::string(name), type(parameters), code.bytes()});
+ return next_function() - 1;
+ }
+
+ size_t import_count() const { return imports_.size(); }
+ size_t function_count() const { return functions_.size(); }
+
+ /**
+ * @brief The module binary, ready to write to a .wasm file or instantiate
+ */
+ std::string bytes() const {
+ using namespace LamiaWasm;
+
+ std::string module(MAGIC, sizeof(MAGIC));
+ char version[4] = {VERSION & 0xFF, 0, 0, 0};
+ module.append(version, sizeof(version));
+
+ std::string section;
+ append_u32(section, static_cast<uint32_t>(types_.size()));
+ for (size_t parameters : types_) {
+ section += static_cast<char>(TYPE_FUNC);
+ append_u32(section, static_cast<uint32_t>(parameters));
+ section.append(parameters, static_cast<char>(TYPE_F64));
+ section += '\x01';
+ section += static_cast<char>(TYPE_F64);
+ }
+ append_section(module, SECTION_TYPE, section);
+
+ if (!imports_.empty()) {
+ section.clear();
+ append_u32(section, static_cast<uint32_t>(imports_.size()));
+ for (const auto& import : imports_) {
+ append_name(section, IMPORT_MODULE);
+ append_name(section, import.name);
+ section += static_cast<char>(EXTERNAL_FUNCTION);
+ append_u32(section, import.type);
+ }
+ append_section(module, SECTION_IMPORT, section);
+ }
+
+ section.clear();
+ append_u32(section, static_cast<uint32_t>(functions_.size()));
+ for (const auto& function : functions_) {
+ append_u32(section, function.type);
+ }
+ append_section(module, SECTION_FUNCTION, section);
+
+ section.clear();
+ append_u32(section, static_cast<uint32_t>(functions_.size()));
+ for (size_t i = 0; i < functions_.size(); ++i) {
+ append_name(section, functions_[i].name);
+ section += static_cast<char>(EXTERNAL_FUNCTION);
+ append_u32(section, static_cast<uint32_t>(imports_.size() + i));
+ }
+ append_section(module, SECTION_EXPORT, section);
+
+ section.clear();
+ append_u32(section, static_cast<uint32_t>(functions_.size()));
+ for (const auto& function : functions_) {
+ std::string body;
+ append_u32(body, 0); // No locals beyond the parameters
+ body += function.code;
+ append_u32(section, static_cast<uint32_t>(body.size()));
+ section += body;
+ }
+ append_section(module, SECTION_CODE, section);
+
+ // Names of every function, imports included, in index order
+ std::string names;
+ append_u32(names, static_cast<uint32_t>(imports_.size() + functions_.size()));
+ for (size_t i = 0; i < imports_.size() + functions_.size(); ++i) {
+ append_u32(names, static_cast<uint32_t>(i));
+ append_name(names, i < imports_.size() ? imports_[i].name : functions_[i - imports_.size()].name);
+ }
+ section.clear();
+ append_name(section, "name");
+ section += static_cast<char>(NAME_FUNCTIONS);
+ append_u32(section, static_cast<uint32_t>(names.size()));
+ section += names;
+ append_section(module, SECTION_CUSTOM, section);
+
+ return module;
+ }
+
+private:
+ struct Import {
+ std::string name;
+ uint32_t type;
+ };
+
+ struct Function {
+ std::string name;
+ uint32_t type;
+ std::string code;
+ };
+
+ std::vector<size_t> types_; // Parameter count of each (f64, ...) -> f64 signature
+ std::map<size_t, uint32_t> type_index_;
+ std::vector<Import> imports_;
+ std::vector<Function> functions_;
+
+ uint32_t type(size_t parameters) {
+ auto it = type_index_.find(parameters);
+ if (it != type_index_.end()) {
+ return it->second;
+ }
+ types_.push_back(parameters);
+ uint32_t index = static_cast<uint32_t>(types_.size() - 1);
+ type_index_.emplace(parameters, index);
+ return index;
+ }
+
+ static void append_section(std::string& module, LamiaWasm::Section id, const std::string& contents) {
+ module += static_cast<char>(id);
+ LamiaWasm::append_u32(module, static_cast<uint32_t>(contents.size()));
+ module += contents;
+ }
+};
+
+} // namespace Lamia
+} // namespace Language
+} // namespace MedusaServ
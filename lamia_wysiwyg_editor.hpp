@@ -29,6 +29,7 @@
 #pragma once
 
 #include "lamia_language_specification.hpp"
+#include "lamia_incremental_parser.hpp"
 #include "medusa_revolutionary_typography.hpp"
 #include "medusa_widget_system.hpp"
 #include <string>
@@ -1003,6 +1004,9 @@ private:
  bool live_preview_enabled_ = false;
  std::function<void(const std::string&)> preview_update_callback_;
  
+ // Source view - kept parsed between keystrokes
+ LamiaIncrementalDocument lamia_source_;
+ 
 public:
  LamiaWYSIWYGEditor() {
  initialize_default_nodes();
@@ -1022,7 +1026,33 @@ public:
  // Parse Lamia syntax and create document
  // This would use the Lamia parser to reconstruct the document
  current_document_ = std::make_unique<EditorDocument>();
- return true; // Simplified for specification
+ lamia_source_.set_text(lamia_source);
+ return lamia_source_.errors().empty();
+ }
+ 
+ /**
+ * @brief Apply a keystroke-sized edit to the Lamia source view
+ *
+ * Only the blocks the edit touches are re-lexed and re-parsed, so the
+ * live preview refresh costs the size of the edit, not the document.
+ */
+ void edit_lamia_source(size_t offset, size_t deleted, const std::string& inserted) {
+ lamia_source_.apply_edit(offset, deleted, inserted);
+ 
+ if (live_preview_enabled_ && preview_update_callback_) {
+ preview_update_callback_(lamia_source_.render(LamiaEmitter::HTML));
+ }
+ }
+ 
+ /**
+ * @brief Current Lamia source view and its syntax errors
+ */
+ const std::string& get_lamia_source() const {
+ return lamia_source_.text();
+ }
+ 
+ std::vector<std::string> get_lamia_source_errors() const {
+ return lamia_source_.errors();
  }
  
  /**
@@ -0,0 +1,335 @@
+/**
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves - All Rights Reserved
+ */
+
+/**
+ * MEDUSA NATIVE RUNTIME v0.3.0c
+ * =============================
+ *
+ * Support library for the C++ the Lamia compiler generates for the
+ * MEDUSA_NATIVE target
+ * - LamiaValue: the dynamic value every manifest takes and returns
+ * - Widget: a constructed create / style_with / directive block, its
+ *   properties and its children
+ * - Page: the widgets mounted while a program renders, written as HTML
+ * - Host functions: callees that are not manifests of the program,
+ *   registered by whoever runs it
+ *
+ * Generated programs hold their manifests as free functions in namespace
+ * LamiaProgram, and LamiaProgram::render_page runs the top-level
+ * statements. They define main() unless LAMIA_NATIVE_NO_MAIN is set.
+ *
+ * This header depends on nothing but the standard library.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace MedusaNative {
+
+/**
+ * @brief A Lamia value: null, lumina, shimmer, radiant or constellation
+ */
+class LamiaValue {
+public:
+ enum class Kind { NULL_VALUE, BOOLEAN, NUMBER, STRING, ARRAY };
+
+private:
+ Kind kind_ = Kind::NULL_VALUE;
+ bool boolean_ = false;
+ double number_ = 0;
+ std::string text_;
+ std::vector<LamiaValue> elements_;
+
+public:
+ LamiaValue() = default;
+ LamiaValue(bool value) : kind_(Kind::BOOLEAN), boolean_(value) {}
+ LamiaValue(double value) : kind_(Kind::NUMBER), number_(value) {}
+ LamiaValue(std::string value) : kind_(Kind::STRING), text_(std::move(value)) {}
+ LamiaValue(const char* value) : LamiaValue(std::string(value)) {}
+ LamiaValue(std::vector<LamiaValue> elements) : kind_(Kind::ARRAY), elements_(std::move(elements)) {}
+
+ Kind kind() const { return kind_; }
+ bool is_null() const { return kind_ == Kind::NULL_VALUE; }
+ bool boolean() const { return boolean_; }
+ double number() const { return number_; }
+ const std::string& text() const { return text_; }
+ const std::vector<LamiaValue>& elements() const { return elements_; }
+
+ /**
+ * @brief Strings as they are, anything else as JSON
+ */
+ std::string to_string() const {
+ if (kind_ == Kind::STRING) {
+ return text_;
+ }
+ std::string out;
+ append_json(out);
+ return out;
+ }
+
+ void append_json(std::string& out) const {
+ switch (kind_) {
+ case Kind::NULL_VALUE:
+ out += "null";
+ break;
+ case Kind::BOOLEAN:
+ out += boolean_ ? "true" : "false";
+ break;
+ case Kind::NUMBER: {
+ char buffer[32];
+ int length = std::snprintf(buffer, sizeof(buffer), "%.15g", number_);
+ out.append(buffer, static_cast<size_t>(length));
+ break;
+ }
+ case Kind::STRING:
+ out += '"';
+ for (char c : text_) {
+ if (c == '"' || c == '\\') {
+ out += '\\';
+ out += c;
+ } else if (c == '\n') {
+ out += "\\n";
+ } else {
+ out += c;
+ }
+ }
+ out += '"';
+ break;
+ case Kind::ARRAY:
+ out += '[';
+ for (size_t i = 0; i < elements_.size(); ++i) {
+ if (i > 0) out += ',';
+ elements_[i].append_json(out);
+ }
+ out += ']';
+ break;
+ }
+ }
+};
+
+// Literal constructors, named after the Lamia types
+template<size_t N>
+inline LamiaValue LamiaRadiant(const char (&text)[N]) { return LamiaValue(std::string(text, N - 1)); }
+inline LamiaValue LamiaShimmer(double number) { return LamiaValue(number); }
+inline LamiaValue LamiaLumina(bool value) { return LamiaValue(value); }
+inline LamiaValue LamiaVoidStar() { return LamiaValue(); }
+inline LamiaValue LamiaConstellation(std::vector<LamiaValue> elements) { return LamiaValue(std::move(elements)); }
+
+/**
+ * @brief Append text with the HTML special characters escaped
+ */
+inline void append_html_escaped(std::string& out, std::string_view text) {
+ for (char c : text) {
+ switch (c) {
+ case '&': out += "&amp;"; break;
+ case '<': out += "&lt;"; break;
+ case '>': out += "&gt;"; break;
+ case '"': out += "&quot;"; break;
+ default: out += c; break;
+ }
+ }
+}
+
+/**
+ * @brief One constructed block of a program: a widget, a style or a text child
+ */
+struct Widget {
+ enum class Kind { ELEMENT, STYLE, TEXT };
+ using Properties = std::vector<std::pair<std::string, LamiaValue>>;
+
+ Kind kind = Kind::TEXT;
+ std::string name; // Widget name, or the selector of a style
+ std::string theme;
+ Properties properties;
+ std::vector<Widget> children;
+ LamiaValue text; // What a TEXT child shows
+
+ Widget() = default;
+ Widget(std::string name, std::string theme, Properties properties = {}, std::vector<Widget> children = {})
+ : kind(Kind::ELEMENT), name(std::move(name)), theme(std::move(theme)),
+ properties(std::move(properties)), children(std::move(children)) {}
+
+ const LamiaValue* property(std::string_view key) const {
+ for (const auto& [name, value] : properties) {
+ if (name == key) {
+ return &value;
+ }
+ }
+ return nullptr;
+ }
+
+ /**
+ * @brief The markup the HTML5 target writes for this block
+ */
+ void render_html(std::string& out) const {
+ switch (kind) {
+ case Kind::ELEMENT:
+ out += "<medusa-";
+ out += name;
+ out += " theme=\"";
+ append_html_escaped(out, theme);
+ out += '"';
+ for (const auto& [key, value] : properties) {
+ out += ' ';
+ out += key;
+ out += "=\"";
+ append_html_escaped(out, value.to_string());
+ out += '"';
+ }
+ if (children.empty()) {
+ out += " />";
+ return;
+ }
+ out += '>';
+ for (const auto& child : children) {
+ child.render_html(out);
+ }
+ out += "</medusa-";
+ out += name;
+ out += '>';
+ break;
+ case Kind::STYLE:
+ out += "<style data-theme=\"";
+ append_html_escaped(out, theme);
+ out += "\">";
+ out += name;
+ out += " {";
+ for (const auto& [prop, value] : properties) {
+ out += ' ';
+ out += prop;
+ out += ": ";
+ out += value.to_string();
+ out += ';';
+ }
+ out += " }</style>";
+ break;
+ case Kind::TEXT:
+ if (!text.is_null()) {
+ append_html_escaped(out, text.to_string());
+ }
+ break;
+ }
+ }
+};
+
+inline Widget Style(std::string selector, std::string theme, Widget::Properties properties = {}) {
+ Widget style;
+ style.kind = Widget::Kind::STYLE;
+ style.name = std::move(selector);
+ style.theme = std::move(theme);
+ style.properties = std::move(properties);
+ return style;
+}
+
+inline Widget Text(LamiaValue value = LamiaValue()) {
+ Widget text;
+ text.text = std::move(value);
+ return text;
+}
+
+/**
+ * @brief The widgets mounted while a program renders, in mount order
+ */
+class Page {
+private:
+ std::vector<Widget> widgets_;
+
+public:
+ void mount(Widget widget) { widgets_.push_back(std::move(widget)); }
+ const std::vector<Widget>& widgets() const { return widgets_; }
+
+ std::string render_html() const {
+ std::string out;
+ for (const auto& widget : widgets_) {
+ widget.render_html(out);
+ out += '\n';
+ }
+ return out;
+ }
+};
+
+inline Page*& current_page() {
+ thread_local Page* page = nullptr;
+ return page;
+}
+
+/**
+ * @brief Makes page the one mount() adds to until the scope ends
+ */
+class PageScope {
+private:
+ Page* saved_;
+
+public:
+ explicit PageScope(Page& page) : saved_(current_page()) { current_page() = &page; }
+ ~PageScope() { current_page() = saved_; }
+ PageScope(const PageScope&) = delete;
+ PageScope& operator=(const PageScope&) = delete;
+};
+
+/**
+ * @brief A create or style_with statement; outside a render the widget is dropped
+ */
+inline void mount(Widget widget) {
+ if (Page* page = current_page()) {
+ page->mount(std::move(widget));
+ }
+}
+
+using HostFunction = std::function<LamiaValue(const std::vector<LamiaValue>& arguments)>;
+
+/**
+ * @brief Callees the program does not define - register them before the first render
+ */
+inline std::map<std::string, HostFunction, std::less<>>& host_functions() {
+ static std::map<std::string, HostFunction, std::less<>> functions;
+ return functions;
+}
+
+inline void register_function(std::string name, HostFunction function) {
+ host_functions()[std::move(name)] = std::move(function);
+}
+
+/**
+ * @brief Call a host function
+ * @throws std::runtime_error if nothing is registered under name
+ */
+inline LamiaValue call(std::string_view name, const std::vector<LamiaValue>& arguments) {
+ auto function = host_functions().find(name);
+ if (function == host_functions().end()) {
+ throw std::runtime_error("no host function '" + std::string(name) + "'");
+ }
+ return function->second(arguments);
+}
+
+/**
+ * @brief main() of a generated program: render the page and write it to stdout as HTML
+ */
+inline int run_page(void (*render)(Page&)) {
+ Page page;
+ try {
+ render(page);
+ } catch (const std::exception& e) {
+ std::cerr << "Lamia: " << e.what() << std::endl;
+ return 1;
+ }
+ std::cout << "<!DOCTYPE html>\n<html lang=\"en\">\n<head>\n <meta charset=\"UTF-8\">\n";
+ std::cout << " <title>Lamia Generated Page</title>\n";
+ std::cout << " <link rel=\"stylesheet\" href=\"medusa-theme.css\">\n</head>\n<body>\n";
+ std::cout << page.render_html();
+ std::cout << "</body>\n</html>\n";
+ return 0;
+}
+
+} // namespace MedusaNative
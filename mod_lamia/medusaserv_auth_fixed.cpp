@@ -11,6 +11,8 @@
  * - Corporate cPanel-style control panel with 6 admin cards (snippets)
  * - 3D emotions and GIF3D integration
  * - ICEWALL security system with real-time monitoring
+ * - /assets/ served from web/assets with sendfile, an open-file cache,
+ *   ETag / Last-Modified and 304 Not Modified
  * 
  * Author: roylepython
  * Date: August 22, 2025
@@ -29,12 +31,16 @@
 #include <unistd.h>
 #include <thread>
 #include <regex>
+#include "medusaserv_http_parser.hpp"
+#include "medusaserv_http_response.hpp"
+#include "medusaserv_static_files.hpp"
 
 class MedusaServAuth {
 private:
     int server_socket;
     bool server_running;
     int port;
+    medusaserv::http::StaticFileCache file_cache; // Open assets and panel sources, dropped on change by inotify
 
 public:
     MedusaServAuth(int listen_port = 80) : server_socket(-1), server_running(false), port(listen_port) {}
@@ -201,14 +207,71 @@ Connection: close
     }
     
     std::string read_file(const std::string& filepath) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
+        // One pread into a string sized from the cached fstat - no stream buffers, no reopen per request
+        auto file = file_cache.open(filepath);
+        if (!file) {
             return "";
         }
         
-        std::ostringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
+        std::string content(static_cast<size_t>(file->size), '\0');
+        size_t filled = 0;
+        while (filled < content.size()) {
+            ssize_t got = pread(file->fd, &content[filled], content.size() - filled, static_cast<off_t>(filled));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                break;
+            }
+            filled += static_cast<size_t>(got);
+        }
+        content.resize(filled);
+        return content;
+    }
+    
+    /**
+     * Serve GET / HEAD /assets/... from web/assets: headers, then the body by sendfile
+     * @return false if path names no asset, so the caller answers 404
+     */
+    bool serve_asset(int client_socket, const std::string& method, const std::string& request, const std::string& path) {
+        using namespace medusaserv::http;
+        
+        std::string decoded;
+        std::string_view request_path(path);
+        request_path = request_path.substr(0, request_path.find('?'));
+        if (!decode_request_path(request_path, decoded) || has_dot_segment(decoded)) {
+            return false;
+        }
+        
+        auto file = file_cache.open("web" + decoded);
+        if (!file) {
+            return false;
+        }
+        
+        HttpRequestParser parser;
+        parser.parse(request);
+        bool not_modified = is_not_modified(*file, parser.header("If-None-Match"), parser.header("If-Modified-Since"));
+        
+        std::string scratch;
+        HttpResponseBuilder response(scratch);
+        response.start(not_modified ? "HTTP/1.1 304 Not Modified\r\n" : "HTTP/1.1 200 OK\r\n")
+                .header("ETag: ", file->etag)
+                .header("Last-Modified: ", file->last_modified);
+        if (!not_modified) {
+            response.header("Content-Type: ", file->content_type);
+        }
+        response.header("Connection: close\r\n");
+        if (not_modified) {
+            response.end_headers();
+        } else {
+            response.finish_headers(static_cast<size_t>(file->size));
+        }
+        
+        bool body = !not_modified && method != "HEAD" && file->size > 0;
+        if (response.send(client_socket, body) && body) {
+            send_file_body(client_socket, file->fd, 0, static_cast<size_t>(file->size));
+        }
+        return true;
     }
     
     std::string serve_panel() {
@@ -724,6 +787,12 @@ Connection: close
         std::string method, path, protocol;
         iss >> method >> path >> protocol;
         
+        if ((method == "GET" || method == "HEAD") && path.compare(0, 8, "/assets/") == 0 &&
+            serve_asset(client_socket, method, request, path)) {
+            close(client_socket); // Assets are not logged: they are the bulk of the traffic
+            return;
+        }
+        
         std::cout << "🌐 REQUEST: " << method << " " << path << std::endl;
         
         std::string response;
@@ -0,0 +1,511 @@
+/**
+ * MEDUSASERV LOAD GENERATOR v0.3.0a
+ * =================================
+ * HTTP load generator for the native MedusaServ event loops
+ * Throughput and latency percentiles (p50, p90, p99, p99.9) per run
+ * © 2025 The Medusa Project | Roylepython | D Hargreaves
+ *
+ * Each thread drives its share of the connections from one epoll loop:
+ * connect, send a GET, read the response to its Content-Length (or to
+ * EOF), record the latency, repeat. Without --keep-alive every request
+ * opens a fresh connection, as the server closes after each response.
+ *
+ * By default the load is closed-loop: a connection sends its next request
+ * only once the last response arrives, so a slow server slows the client
+ * down and latencies leave out the time requests would have queued. With
+ * -r the load is open-loop: requests are scheduled at a fixed rate, wait
+ * for a free connection when they fall due, and their latency runs from
+ * the scheduled time - queueing included.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread medusaserv_loadgen.cpp -o medusaserv_loadgen
+ * Usage:  medusaserv_loadgen [-c connections] [-t threads] [-d seconds] [-r requests/s] [--keep-alive] [host] [port] [path]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <deque>
+#include <cstring>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace medusaserv {
+
+struct LoadOptions {
+    std::string host = "127.0.0.1";
+    int port = 2000;
+    std::string path = "/health";
+    int connections = 64;
+    int threads = 0; // 0: one per core, never more than connections
+    int seconds = 10;
+    double rate = 0; // Requests per second across all threads; 0: closed loop
+    bool keep_alive = false;
+};
+
+/**
+ * @brief What one thread measured
+ */
+struct LoadResults {
+    std::vector<uint32_t> latencies_us; // One per completed request
+    size_t errors = 0;      // Failed connects, resets and malformed responses
+    size_t non_2xx = 0;     // Completed, but not with a 2xx status
+    size_t bytes_read = 0;
+    size_t unstarted = 0;   // Open loop: fell due but found no free connection before the end
+};
+
+class LoadGenerator {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief One client connection and the request it has in flight
+     */
+    struct Client {
+        int fd = -1;
+        bool connected = false;
+        bool idle = false;         // Open loop: waiting for the next request to fall due
+        Clock::time_point started; // When the request (and for a new connection, the connect) began - or was due
+        size_t sent = 0;
+        std::string response;
+        size_t header_end = std::string::npos;
+        size_t content_length = std::string::npos; // Unknown: read to EOF
+    };
+
+    LoadOptions options_;
+    struct sockaddr_in address_;
+    std::string request_;
+    Clock::duration interval_{}; // Open loop: time between one thread's requests
+    std::atomic<bool> running_{false};
+
+public:
+    explicit LoadGenerator(const LoadOptions& options) : options_(options) {
+        request_ = "GET " + options_.path + " HTTP/1.1\r\nHost: " + options_.host + "\r\n";
+        request_ += options_.keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    }
+
+    bool resolve() {
+        std::memset(&address_, 0, sizeof(address_));
+        address_.sin_family = AF_INET;
+        address_.sin_port = htons(options_.port);
+        if (inet_pton(AF_INET, options_.host.c_str(), &address_.sin_addr) == 1) {
+            return true;
+        }
+
+        struct addrinfo hints, *found = nullptr;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(options_.host.c_str(), nullptr, &hints, &found) != 0 || !found) {
+            std::cerr << "❌ Cannot resolve " << options_.host << std::endl;
+            return false;
+        }
+        address_.sin_addr = reinterpret_cast<struct sockaddr_in*>(found->ai_addr)->sin_addr;
+        freeaddrinfo(found);
+        return true;
+    }
+
+    /**
+     * @brief Run for options.seconds and print the report
+     */
+    int run() {
+        if (!resolve()) {
+            return 1;
+        }
+
+        int threads = options_.threads > 0 ? options_.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        threads = std::max(1, std::min(threads, options_.connections));
+
+        std::cout << "🚀 Load: " << options_.connections << " connections, " << threads << " threads, "
+                  << options_.seconds << "s against http://" << options_.host << ":" << options_.port << options_.path
+                  << (options_.keep_alive ? " (keep-alive)" : " (connection per request)") << std::endl;
+        if (options_.rate > 0) {
+            interval_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(threads / options_.rate));
+            std::cout << "   Open loop at " << options_.rate << " req/s: latency runs from each request's scheduled time" << std::endl;
+        } else {
+            std::cout << "   Closed loop: each connection waits for its response before the next request,"
+                      << " so latencies exclude queueing time (-r RATE for open loop)" << std::endl;
+        }
+
+        std::vector<LoadResults> results(threads);
+        std::vector<std::thread> workers;
+        running_ = true;
+        auto start = Clock::now();
+        for (int i = 0; i < threads; ++i) {
+            int share = options_.connections / threads + (i < options_.connections % threads ? 1 : 0);
+            workers.emplace_back(&LoadGenerator::drive, this, share, std::ref(results[i]));
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(options_.seconds));
+        running_ = false;
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        report(results, elapsed);
+        return 0;
+    }
+
+private:
+    /**
+     * @brief One thread's event loop over its connections
+     */
+    void drive(int count, LoadResults& results) {
+        int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            results.errors += count;
+            return;
+        }
+
+        // Closed loop: every connection always has a request in flight.
+        // Open loop: connections start idle and take requests as they fall due.
+        bool open_loop = options_.rate > 0;
+        std::vector<Client> clients(count);
+        std::vector<uint32_t> idle;
+        std::deque<Clock::time_point> due; // Open loop: fallen due, waiting for an idle connection
+        Clock::time_point next_due = Clock::now();
+        for (int i = 0; i < count; ++i) {
+            if (open_loop) {
+                clients[i].idle = true;
+                idle.push_back(i);
+            } else {
+                open_connection(epoll_fd, clients[i], i, results);
+            }
+        }
+
+        struct epoll_event events[256];
+        while (running_) {
+            int timeout = 100; // Wake up to notice the end of the run
+            if (open_loop) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_due - Clock::now()).count();
+                timeout = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait, timeout)));
+            }
+            int ready = epoll_wait(epoll_fd, events, 256, timeout);
+            for (int i = 0; i < ready; ++i) {
+                uint32_t index = events[i].data.u32;
+                Client& client = clients[index];
+                if (client.idle) {
+                    // A kept-alive connection the server has since closed: reconnect when next needed
+                    if (client.fd >= 0 && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+                        close(client.fd);
+                        client.fd = -1;
+                    }
+                    continue;
+                }
+                if (!service(client, events[i].events, results)) {
+                    if (client.fd >= 0) {
+                        close(client.fd);
+                        client.fd = -1;
+                    }
+                    if (open_loop) {
+                        client.idle = true;
+                    } else if (running_) {
+                        open_connection(epoll_fd, client, index, results);
+                    }
+                }
+                if (client.idle) {
+                    idle.push_back(index);
+                }
+            }
+
+            if (open_loop) {
+                for (auto now = Clock::now(); next_due <= now; next_due += interval_) {
+                    due.push_back(next_due);
+                }
+                while (!due.empty() && !idle.empty() && running_) {
+                    dispatch(epoll_fd, clients, idle, due.front(), results);
+                    due.pop_front();
+                }
+            }
+        }
+        results.unstarted += due.size();
+
+        for (auto& client : clients) {
+            if (client.fd >= 0) {
+                close(client.fd);
+            }
+        }
+        close(epoll_fd);
+    }
+
+    /**
+     * @brief Open loop: start a request that fell due at scheduled on an idle connection
+     */
+    void dispatch(int epoll_fd, std::vector<Client>& clients, std::vector<uint32_t>& idle,
+                  Clock::time_point scheduled, LoadResults& results) {
+        uint32_t index = idle.back();
+        idle.pop_back();
+        Client& client = clients[index];
+
+        bool in_flight;
+        if (client.fd >= 0) {
+            // Kept alive: nothing else will signal the socket, so send now
+            client.idle = false;
+            client.started = scheduled;
+            in_flight = service(client, EPOLLOUT, results);
+        } else {
+            open_connection(epoll_fd, client, index, results);
+            client.started = scheduled;
+            in_flight = client.fd >= 0;
+        }
+
+        if (!in_flight) {
+            if (client.fd >= 0) {
+                close(client.fd);
+                client.fd = -1;
+            }
+            client.idle = true;
+        }
+        if (client.idle) {
+            idle.push_back(index);
+        }
+    }
+
+    void open_connection(int epoll_fd, Client& client, uint32_t index, LoadResults& results) {
+        // A failed connect is retried on the next pass through the loop, after the error is counted
+        while (running_) {
+            client = Client();
+            client.started = Clock::now();
+            client.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (client.fd < 0) {
+                ++results.errors;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            int one = 1;
+            setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            if (connect(client.fd, reinterpret_cast<struct sockaddr*>(&address_), sizeof(address_)) < 0 && errno != EINPROGRESS) {
+                ++results.errors;
+                close(client.fd);
+                client.fd = -1;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+
+            struct epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.u32 = index;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client.fd, &event) == 0) {
+                return;
+            }
+            ++results.errors;
+            close(client.fd);
+            client.fd = -1;
+        }
+    }
+
+    /**
+     * @brief Advance one client: finish connecting, send, read, record
+     * @return false when the connection is done with and must be replaced
+     */
+    bool service(Client& client, uint32_t events, LoadResults& results) {
+        if (!client.connected) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            if ((events & EPOLLERR) || getsockopt(client.fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+                ++results.errors;
+                return false;
+            }
+            if (!(events & (EPOLLOUT | EPOLLIN))) {
+                return true;
+            }
+            client.connected = true;
+        }
+
+        // Edge-triggered: keep going until the socket would block, request after request on keep-alive
+        while (true) {
+            // Send whatever of the request the socket takes now
+            while (client.sent < request_.size()) {
+                ssize_t sent = send(client.fd, request_.data() + client.sent, request_.size() - client.sent, MSG_NOSIGNAL);
+                if (sent > 0) {
+                    client.sent += static_cast<size_t>(sent);
+                } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    return true;
+                } else if (sent < 0 && errno == EINTR) {
+                    continue;
+                } else {
+                    ++results.errors;
+                    return false;
+                }
+            }
+
+            // Read until EAGAIN, the end of the body, or EOF
+            char buffer[16384];
+            bool complete = false;
+            while (!complete) {
+                ssize_t bytes_read = recv(client.fd, buffer, sizeof(buffer), 0);
+                if (bytes_read > 0) {
+                    results.bytes_read += static_cast<size_t>(bytes_read);
+                    client.response.append(buffer, static_cast<size_t>(bytes_read));
+                    complete = response_complete(client);
+                } else if (bytes_read == 0) {
+                    // EOF ends a body of unknown length; anything else is cut short
+                    if (client.header_end != std::string::npos && client.content_length == std::string::npos) {
+                        finish(client, results);
+                    } else {
+                        ++results.errors;
+                    }
+                    return false;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return true;
+                } else if (errno != EINTR) {
+                    ++results.errors;
+                    return false;
+                }
+            }
+            if (!finish(client, results) || !running_) {
+                return false;
+            }
+            if (options_.rate > 0) {
+                // Open loop: keep the connection for the next request to fall due
+                client.idle = true;
+                return true;
+            }
+        }
+    }
+
+    static bool response_complete(Client& client) {
+        if (client.header_end == std::string::npos) {
+            size_t end = client.response.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                return false;
+            }
+            client.header_end = end + 4;
+            client.content_length = header_value(client.response, client.header_end, "content-length");
+        }
+        return client.content_length != std::string::npos &&
+               client.response.size() >= client.header_end + client.content_length;
+    }
+
+    /**
+     * @brief A numeric header's value, npos when absent (names compared case-insensitively)
+     */
+    static size_t header_value(const std::string& response, size_t header_end, const char* name) {
+        size_t name_length = std::strlen(name);
+        size_t line = response.find("\r\n");
+        while (line != std::string::npos && line + 2 < header_end) {
+            size_t start = line + 2;
+            bool match = start + name_length < header_end && response[start + name_length] == ':';
+            for (size_t i = 0; match && i < name_length; ++i) {
+                match = std::tolower(static_cast<unsigned char>(response[start + i])) == name[i];
+            }
+            if (match) {
+                return std::strtoul(response.c_str() + start + name_length + 1, nullptr, 10);
+            }
+            line = response.find("\r\n", start);
+        }
+        return std::string::npos;
+    }
+
+    /**
+     * @brief Record a completed response
+     * @return true to send the next request on the same connection
+     */
+    bool finish(Client& client, LoadResults& results) {
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - client.started).count();
+        results.latencies_us.push_back(static_cast<uint32_t>(std::min<int64_t>(latency, UINT32_MAX)));
+
+        // "HTTP/1.1 200 ..." - the status starts at offset 9
+        if (client.response.size() < 12 || client.response[9] != '2') {
+            ++results.non_2xx;
+        }
+
+        bool reuse = options_.keep_alive && client.content_length != std::string::npos &&
+                     client.response.size() == client.header_end + client.content_length &&
+                     !has_connection_close(client.response, client.header_end);
+        if (reuse) {
+            client.started = Clock::now();
+            client.sent = 0;
+            client.response.clear();
+            client.header_end = std::string::npos;
+            client.content_length = std::string::npos;
+        }
+        return reuse;
+    }
+
+    static bool has_connection_close(const std::string& response, size_t header_end) {
+        std::string head = response.substr(0, header_end);
+        std::transform(head.begin(), head.end(), head.begin(), [](unsigned char c) { return std::tolower(c); });
+        return head.find("\r\nconnection: close") != std::string::npos;
+    }
+
+    void report(std::vector<LoadResults>& results, double elapsed) {
+        std::vector<uint32_t> latencies;
+        size_t errors = 0, non_2xx = 0, bytes = 0, unstarted = 0;
+        for (auto& result : results) {
+            latencies.insert(latencies.end(), result.latencies_us.begin(), result.latencies_us.end());
+            errors += result.errors;
+            non_2xx += result.non_2xx;
+            bytes += result.bytes_read;
+            unstarted += result.unstarted;
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        auto percentile = [&](double p) -> double {
+            if (latencies.empty()) {
+                return 0;
+            }
+            size_t rank = static_cast<size_t>(p / 100.0 * (latencies.size() - 1) + 0.5);
+            return latencies[rank] / 1000.0;
+        };
+
+        std::cout << std::endl << "📊 RESULTS" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "   Requests:    " << latencies.size() << " in " << elapsed << "s" << std::endl;
+        std::cout << "   Throughput:  " << latencies.size() / elapsed << " req/s, "
+                  << bytes / elapsed / (1024 * 1024) << " MB/s" << std::endl;
+        std::cout << "   Latency ms:  p50 " << percentile(50) << "  p90 " << percentile(90)
+                  << "  p99 " << percentile(99) << "  p99.9 " << percentile(99.9)
+                  << "  max " << (latencies.empty() ? 0 : latencies.back() / 1000.0) << std::endl;
+        std::cout << "   Errors:      " << errors << " (non-2xx responses: " << non_2xx << ")" << std::endl;
+        if (options_.rate > 0) {
+            std::cout << "   Unstarted:   " << unstarted << " requests still waiting for a connection at the end" << std::endl;
+        }
+    }
+};
+
+} // namespace medusaserv
+
+int main(int argc, char* argv[]) {
+    medusaserv::LoadOptions options;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-c" && i + 1 < argc) {
+            options.connections = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-t" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "-d" && i + 1 < argc) {
+            options.seconds = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-r" && i + 1 < argc) {
+            options.rate = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--keep-alive" || arg == "-k") {
+            options.keep_alive = true;
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [-c connections] [-t threads] [-d seconds] [-r requests/s] [--keep-alive] [host] [port] [path]" << std::endl;
+            return 0;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() > 0) options.host = positional[0];
+    if (positional.size() > 1) options.port = std::atoi(positional[1].c_str());
+    if (positional.size() > 2) options.path = positional[2];
+
+    medusaserv::LoadGenerator generator(options);
+    return generator.run();
+}
@@ -5,6 +5,16 @@
  * Professional web server using established library catalog
  * NO shortcuts, NO mock data, maximum performance
  * © 2025 The Medusa Project | Roylepython | D Hargreaves
+ *
+ * Connection handling: one edge-triggered epoll loop per core, each
+ * pinned to its core with its own SO_REUSEPORT listening socket, so the
+ * kernel spreads accepts across loops and loops share nothing. Sockets
+ * are non-blocking; a connection reads its request, writes its response
+ * as the socket drains, then closes.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread medusaserv_native.cpp -o medusaserv_native
+ * Run:    medusaserv_native [port] [event loops]
+ * Load:   medusaserv_loadgen (medusaserv_loadgen.cpp) reports req/s and p99
  */
 
 #include <iostream>
@@ -17,12 +27,19 @@
 #include <sstream>
 #include <unordered_map>
 #include <cstring>
+#include <cstdlib>
+#include <algorithm>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <signal.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 // Forward declarations for established library functions
 extern "C" {
@@ -38,15 +55,50 @@ namespace medusaserv {
 
 class NativeMedusaServ {
 private:
-    std::atomic<bool> running_;
-    int server_socket_;
+    static constexpr size_t MAX_REQUEST_BYTES = 16 * 1024; // Request head limit - larger gets a 400
+    static constexpr int MAX_EVENTS = 256; // Events taken per epoll_wait
+    static constexpr size_t MAX_LINGER_BYTES = 256 * 1024; // Unread input discarded before closing anyway
+    static constexpr std::chrono::milliseconds LINGER_TIMEOUT{2000}; // How long a client gets to stop sending
+    
+    /**
+     * @brief One client socket: the request as it arrives, then the response as it leaves
+     */
+    struct Connection {
+        std::string request;
+        std::string response; // Empty until the request is complete
+        size_t sent = 0;
+        bool unread_input = false; // The client may still be sending - drain before closing
+        bool lingering = false;    // Response sent and write side shut down; discarding input
+        size_t drained = 0;
+        std::chrono::steady_clock::time_point linger_deadline;
+    };
+    
+    /**
+     * @brief One reactor - owns its listening socket, epoll set and connections
+     */
+    struct EventLoop {
+        int listen_fd = -1;
+        int epoll_fd = -1;
+        int wake_fd = -1; // eventfd that interrupts epoll_wait on shutdown
+        int cpu = -1;     // Core the loop runs on
+        std::unordered_map<int, Connection> connections;
+        std::vector<int> lingering; // Sockets with a linger deadline, possibly stale
+    };
+    
+    std::atomic<bool> running_; // Cleared from a signal handler: must stay lock-free
+    bool serving_ = false;      // start() reached the loops; shutdown() has not yet reported
     int port_;
+    int num_loops_;
     std::string server_version_;
-    std::vector<std::thread> worker_threads_;
+    std::vector<EventLoop> loops_;
+    std::vector<std::thread> worker_threads_; // Loops 1..N-1; loop 0 runs on the thread calling start()
     
 public:
-    NativeMedusaServ(int port = 2000) 
-        : running_(false), server_socket_(-1), port_(port), 
+    /**
+     * @param num_loops Event loops to run, 0 for one per available core
+     */
+    NativeMedusaServ(int port = 2000, int num_loops = 0) 
+        : running_(false), port_(port), num_loops_(num_loops), 
           server_version_("MedusaServ v0.3.0a (Professional Native C++ Server)") {
         
         std::cout << "🚀 Initializing Native C++ MedusaServ v0.3.0a..." << std::endl;
@@ -57,6 +109,12 @@ public:
     
     ~NativeMedusaServ() {
         shutdown();
+        for (auto& loop : loops_) {
+            close_loop(loop);
+            if (loop.wake_fd >= 0) {
+                close(loop.wake_fd);
+            }
+        }
     }
     
     bool initialize() {
@@ -67,38 +125,31 @@ public:
             std::cout << "📝 Using established alternative core implementation" << std::endl;
         }
         
-        // Create socket
-        server_socket_ = socket(AF_INET, SOCK_STREAM, 0);
-        if (server_socket_ < 0) {
-            std::cerr << "❌ Failed to create socket" << std::endl;
-            return false;
-        }
+        // One loop per core this process may run on, unless told otherwise
+        std::vector<int> cpus = available_cpus();
+        int count = num_loops_ > 0 ? num_loops_ : static_cast<int>(cpus.size());
+        loops_.resize(count);
         
-        // Set socket options
-        int opt = 1;
-        if (setsockopt(server_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-            std::cerr << "❌ Failed to set socket options" << std::endl;
-            return false;
-        }
-        
-        // Bind socket
-        struct sockaddr_in address;
-        address.sin_family = AF_INET;
-        address.sin_addr.s_addr = INADDR_ANY;
-        address.sin_port = htons(port_);
-        
-        if (bind(server_socket_, (struct sockaddr*)&address, sizeof(address)) < 0) {
-            std::cerr << "❌ Failed to bind socket to port " << port_ << std::endl;
-            return false;
-        }
-        
-        // Listen for connections
-        if (listen(server_socket_, 1024) < 0) {
-            std::cerr << "❌ Failed to listen on socket" << std::endl;
-            return false;
+        for (int i = 0; i < count; ++i) {
+            EventLoop& loop = loops_[i];
+            loop.cpu = cpus[i % cpus.size()];
+            
+            // Every loop binds the port itself; the kernel balances accepts between them
+            loop.listen_fd = create_listen_socket();
+            if (loop.listen_fd < 0) {
+                return false;
+            }
+            
+            loop.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            loop.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (loop.epoll_fd < 0 || loop.wake_fd < 0 ||
+                !watch(loop, loop.listen_fd, EPOLLIN | EPOLLET) || !watch(loop, loop.wake_fd, EPOLLIN)) {
+                std::cerr << "❌ Failed to create event loop: " << strerror(errno) << std::endl;
+                return false;
+            }
         }
         
-        std::cout << "✅ Native C++ server initialized successfully" << std::endl;
+        std::cout << "✅ Native C++ server initialized successfully (" << count << " event loops)" << std::endl;
         return true;
     }
     
@@ -131,41 +182,56 @@ public:
         std::cout << "👑 Native C++ MedusaServ is now OPERATIONAL" << std::endl;
         std::cout << "⚡ Maximum performance with established library support" << std::endl;
         
-        // Start worker threads for handling connections
-        const int num_workers = std::thread::hardware_concurrency();
-        for (int i = 0; i < num_workers; ++i) {
-            worker_threads_.emplace_back(&NativeMedusaServ::worker_thread, this);
+        // One event loop per worker thread; this thread runs the first.
+        // Workers block SIGINT/SIGTERM so the shutdown handler runs here,
+        // and only while the loops run: loops_ must not change under it
+        sigset_t signals, saved;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, &saved);
+        for (size_t i = 1; i < loops_.size(); ++i) {
+            worker_threads_.emplace_back(&NativeMedusaServ::run_loop, this, std::ref(loops_[i]));
         }
+        serving_ = true;
+        pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+        run_loop(loops_[0]);
+        pthread_sigmask(SIG_SETMASK, &saved, nullptr);
         
-        // Main accept loop
-        while (running_) {
-            struct sockaddr_in client_address;
-            socklen_t client_len = sizeof(client_address);
-            
-            int client_socket = accept(server_socket_, (struct sockaddr*)&client_address, &client_len);
-            if (client_socket >= 0) {
-                // Handle connection in separate thread
-                std::thread(&NativeMedusaServ::handle_connection, this, client_socket).detach();
+        // The first loop only returns on shutdown (or failure): stop the rest too
+        shutdown();
+    }
+    
+    /**
+     * @brief Clear running_ and wake every loop out of epoll_wait
+     *
+     * Async-signal-safe - an atomic store and write() - so a signal handler
+     * may call it; shutdown() does the joining and reporting.
+     */
+    void request_stop() {
+        static_assert(std::atomic<bool>::is_always_lock_free, "running_ is cleared from a signal handler");
+        running_.store(false);
+        uint64_t one = 1;
+        for (auto& loop : loops_) {
+            if (loop.wake_fd >= 0) {
+                ssize_t ignored = write(loop.wake_fd, &one, sizeof(one));
+                (void)ignored;
             }
         }
     }
     
     void shutdown() {
-        if (running_) {
-            running_ = false;
-            
-            if (server_socket_ >= 0) {
-                close(server_socket_);
-                server_socket_ = -1;
-            }
-            
-            // Wait for worker threads
-            for (auto& thread : worker_threads_) {
-                if (thread.joinable()) {
-                    thread.join();
-                }
+        request_stop();
+        
+        // Wait for worker threads
+        for (auto& thread : worker_threads_) {
+            if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+                thread.join();
             }
-            
+        }
+        
+        if (serving_) {
+            serving_ = false;
             std::cout << std::endl;
             std::cout << "📝 Native C++ MedusaServ shutdown complete" << std::endl;
             std::cout << "🤝 Professional standards maintained throughout operation" << std::endl;
@@ -173,29 +239,316 @@ public:
     }
     
 private:
-    void worker_thread() {
-        while (running_) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            // Worker thread for connection pool management
+    /**
+     * @brief Cores this process may run on, in order (sched_getaffinity, else all online cores)
+     */
+    static std::vector<int> available_cpus() {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        if (cpus.empty()) {
+            int count = std::max(1u, std::thread::hardware_concurrency());
+            for (int cpu = 0; cpu < count; ++cpu) {
+                cpus.push_back(cpu);
+            }
         }
+        return cpus;
     }
     
-    void handle_connection(int client_socket) {
-        char buffer[4096];
-        ssize_t bytes_read = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
+    int create_listen_socket() {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            std::cerr << "❌ Failed to create socket" << std::endl;
+            return -1;
+        }
         
-        if (bytes_read > 0) {
-            buffer[bytes_read] = '\0';
-            std::string request(buffer);
-            
-            // Parse HTTP request
-            std::string response = process_request(request);
+        // Set socket options
+        int opt = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+            std::cerr << "❌ Failed to set socket options" << std::endl;
+            close(fd);
+            return -1;
+        }
+        
+        // Bind socket
+        struct sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = INADDR_ANY;
+        address.sin_port = htons(port_);
+        
+        if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+            std::cerr << "❌ Failed to bind socket to port " << port_ << std::endl;
+            close(fd);
+            return -1;
+        }
+        
+        // Listen for connections
+        if (listen(fd, 1024) < 0) {
+            std::cerr << "❌ Failed to listen on socket" << std::endl;
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    
+    static bool watch(EventLoop& loop, int fd, uint32_t events) {
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.fd = fd;
+        return epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+    
+    /**
+     * @brief Reactor body - accept, read, respond and close until shutdown
+     */
+    void run_loop(EventLoop& loop) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(loop.cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // Best effort - unpinned still works
+        
+        struct epoll_event events[MAX_EVENTS];
+        while (running_) {
+            // Wake up now and then while a lingering close is waiting on its deadline
+            int timeout = loop.lingering.empty() ? -1 : static_cast<int>(LINGER_TIMEOUT.count() / 4);
+            int ready = epoll_wait(loop.epoll_fd, events, MAX_EVENTS, timeout);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "❌ epoll_wait failed: " << strerror(errno) << std::endl;
+                break;
+            }
             
-            // Send response
-            send(client_socket, response.c_str(), response.length(), 0);
+            for (int i = 0; i < ready; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == loop.listen_fd) {
+                    accept_connections(loop);
+                } else if (fd != loop.wake_fd) {
+                    handle_connection(loop, fd, events[i].events);
+                }
+                // A wake_fd event only means running_ has been cleared
+            }
+            if (!loop.lingering.empty()) {
+                expire_lingering(loop);
+            }
+        }
+        
+        close_loop(loop);
+    }
+    
+    /**
+     * @brief Release a loop's listening socket, epoll set and open connections (idempotent)
+     */
+    static void close_loop(EventLoop& loop) {
+        for (const auto& connection : loop.connections) {
+            close(connection.first);
+        }
+        loop.connections.clear();
+        if (loop.listen_fd >= 0) {
+            close(loop.listen_fd);
+            loop.listen_fd = -1;
+        }
+        if (loop.epoll_fd >= 0) {
+            close(loop.epoll_fd);
+            loop.epoll_fd = -1;
+        }
+    }
+    
+    /**
+     * @brief Take every pending connection - edge-triggered, so until EAGAIN
+     */
+    void accept_connections(EventLoop& loop) {
+        while (true) {
+            int client_socket = accept4(loop.listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client_socket < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                // EAGAIN: drained. EMFILE and friends: leave the rest queued for the next edge
+                return;
+            }
+            if (!watch(loop, client_socket, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET)) {
+                close(client_socket);
+                continue;
+            }
+            loop.connections.emplace(client_socket, Connection());
+        }
+    }
+    
+    /**
+     * @brief Advance one connection's state machine: reading -> writing -> closed
+     */
+    void handle_connection(EventLoop& loop, int client_socket, uint32_t events) {
+        auto it = loop.connections.find(client_socket);
+        if (it == loop.connections.end()) {
+            return;
+        }
+        Connection& connection = it->second;
+        
+        if (events & EPOLLERR) {
+            close_connection(loop, client_socket);
+            return;
+        }
+        
+        if (connection.lingering) {
+            drain_input(loop, client_socket, connection);
+            return;
         }
         
-        close(client_socket);
+        if (connection.response.empty()) {
+            switch (read_request(client_socket, connection)) {
+                case ReadResult::PENDING:
+                    return;
+                case ReadResult::CLOSED:
+                    close_connection(loop, client_socket);
+                    return;
+                case ReadResult::COMPLETE:
+                    // Parse HTTP request
+                    connection.response = process_request(connection.request);
+                    // Bytes past the head are a body nobody reads
+                    connection.unread_input = connection.request.find("\r\n\r\n") + 4 < connection.request.size();
+                    break;
+                case ReadResult::TOO_LARGE:
+                    connection.response = generate_400_response();
+                    connection.unread_input = true;
+                    break;
+            }
+        }
+        
+        // Send response - whatever the socket takes now, the rest on the next EPOLLOUT
+        if (write_response(client_socket, connection)) {
+            if (connection.unread_input && connection.sent == connection.response.size()) {
+                start_lingering(loop, client_socket, connection);
+            } else {
+                close_connection(loop, client_socket);
+            }
+        }
+    }
+    
+    /**
+     * @brief Close after the client stops sending, so unread input can't turn the close into a reset
+     *
+     * close() with unread data sends RST, and the client may drop the response
+     * it has not read yet. Shut down the write side (the client sees EOF after
+     * the response) and discard input until the client closes, the byte budget
+     * runs out or LINGER_TIMEOUT passes.
+     */
+    static void start_lingering(EventLoop& loop, int client_socket, Connection& connection) {
+        if (::shutdown(client_socket, SHUT_WR) < 0) {
+            close_connection(loop, client_socket);
+            return;
+        }
+        connection.lingering = true;
+        connection.linger_deadline = std::chrono::steady_clock::now() + LINGER_TIMEOUT;
+        std::string().swap(connection.request);
+        std::string().swap(connection.response);
+        loop.lingering.push_back(client_socket);
+        drain_input(loop, client_socket, connection); // Edge-triggered: input may already be waiting
+    }
+    
+    static void drain_input(EventLoop& loop, int client_socket, Connection& connection) {
+        char buffer[4096];
+        while (true) {
+            ssize_t bytes_read = recv(client_socket, buffer, sizeof(buffer), 0);
+            if (bytes_read > 0) {
+                connection.drained += static_cast<size_t>(bytes_read);
+                if (connection.drained > MAX_LINGER_BYTES) {
+                    close_connection(loop, client_socket);
+                    return;
+                }
+            } else if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;
+            } else if (bytes_read < 0 && errno == EINTR) {
+                continue;
+            } else {
+                close_connection(loop, client_socket); // Client closed (or failed): done
+                return;
+            }
+        }
+    }
+    
+    /**
+     * @brief Close lingering sockets past their deadline and forget entries that are gone
+     */
+    static void expire_lingering(EventLoop& loop) {
+        auto now = std::chrono::steady_clock::now();
+        auto expired = [&loop, now](int fd) {
+            auto it = loop.connections.find(fd);
+            if (it == loop.connections.end() || !it->second.lingering) {
+                return true; // Closed already; the descriptor may belong to a new connection
+            }
+            if (now < it->second.linger_deadline) {
+                return false;
+            }
+            close_connection(loop, fd);
+            return true;
+        };
+        loop.lingering.erase(std::remove_if(loop.lingering.begin(), loop.lingering.end(), expired), loop.lingering.end());
+    }
+    
+    enum class ReadResult { PENDING, COMPLETE, TOO_LARGE, CLOSED };
+    
+    /**
+     * @brief Read until EAGAIN or the end of the request head
+     */
+    static ReadResult read_request(int client_socket, Connection& connection) {
+        char buffer[4096];
+        while (true) {
+            ssize_t bytes_read = recv(client_socket, buffer, sizeof(buffer), 0);
+            if (bytes_read > 0) {
+                size_t scan_from = connection.request.size() < 3 ? 0 : connection.request.size() - 3;
+                connection.request.append(buffer, static_cast<size_t>(bytes_read));
+                if (connection.request.find("\r\n\r\n", scan_from) != std::string::npos) {
+                    return ReadResult::COMPLETE;
+                }
+                if (connection.request.size() > MAX_REQUEST_BYTES) {
+                    return ReadResult::TOO_LARGE;
+                }
+            } else if (bytes_read == 0) {
+                return ReadResult::CLOSED; // Peer went away before finishing its request
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return ReadResult::PENDING;
+            } else if (errno != EINTR) {
+                return ReadResult::CLOSED;
+            }
+        }
+    }
+    
+    /**
+     * @brief Write until EAGAIN or the whole response is out
+     * @return true once the connection is finished with (sent, or failed)
+     */
+    static bool write_response(int client_socket, Connection& connection) {
+        while (connection.sent < connection.response.size()) {
+            ssize_t bytes_sent = send(client_socket, connection.response.data() + connection.sent,
+                                      connection.response.size() - connection.sent, MSG_NOSIGNAL);
+            if (bytes_sent > 0) {
+                connection.sent += static_cast<size_t>(bytes_sent);
+            } else if (bytes_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return false;
+            } else if (bytes_sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return true;
+            }
+        }
+        return true; // Every response says Connection: close
+    }
+    
+    static void close_connection(EventLoop& loop, int client_socket) {
+        loop.connections.erase(client_socket);
+        close(client_socket); // Also drops it from the epoll set
     }
     
     std::string process_request(const std::string& request) {
@@ -513,28 +866,35 @@ private:
 // Signal handler for graceful shutdown
 std::unique_ptr<medusaserv::NativeMedusaServ> g_server;
 
-void signal_handler(int signal) {
+void signal_handler(int) {
+    // Only async-signal-safe work here: start() returns, then joins, reports and main exits
     if (g_server) {
-        std::cout << std::endl << "📝 Received shutdown signal..." << std::endl;
-        g_server->shutdown();
+        g_server->request_stop();
     }
-    exit(0);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "🚀 Starting MedusaServ Native C++ v0.3.0a..." << std::endl;
     std::cout << "🔬 Ground Up methodology - established libraries active" << std::endl;
     std::cout << "⚡ Maximum performance with native C++ implementation" << std::endl;
     std::cout << "👑 YOUR MedusaServ converting to ultimate performance" << std::endl;
     
-    // Setup signal handlers
+    // Setup signal handlers - held back until start() runs the loops
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
-    // Create and start server on port 2000
-    g_server = std::make_unique<medusaserv::NativeMedusaServ>(2000);
+    // Create and start server - port 2000 and one event loop per core unless given
+    int port = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int loops = argc > 2 ? std::atoi(argv[2]) : 0;
+    g_server = std::make_unique<medusaserv::NativeMedusaServ>(port, loops);
     g_server->start();
     
+    g_server.reset();
     return 0;
 }
 